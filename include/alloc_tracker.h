@@ -0,0 +1,103 @@
+#ifndef CPP_FEATURES_ALLOC_TRACKER_H
+#define CPP_FEATURES_ALLOC_TRACKER_H
+
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <utility>
+
+#include "utils.h"
+
+namespace cpp_features {
+
+// Process-wide allocation counters
+struct AllocStats {
+  uint64_t allocations = 0;
+  uint64_t deallocations = 0;
+  uint64_t bytes_allocated = 0;
+  uint64_t live_bytes = 0;
+  uint64_t peak_live_bytes = 0;
+};
+
+// Global operator new/delete instrumentation. Opt-in: configure with
+// `xmake f --alloc_tracking=y` to link src/utils/alloc_tracker.cpp and define
+// CPP_FEATURES_ALLOC_TRACKING; otherwise these are no-op stubs.
+namespace alloc_tracking {
+
+#ifdef CPP_FEATURES_ALLOC_TRACKING
+AllocStats snapshot();
+// Lowers the peak watermark to the current live bytes; returns the old peak
+uint64_t reset_peak();
+// Raises the peak watermark back to at least `peak`
+void restore_peak(uint64_t peak);
+inline bool enabled() { return true; }
+#else
+inline AllocStats snapshot() { return AllocStats(); }
+inline uint64_t reset_peak() { return 0; }
+inline void restore_peak(uint64_t) {}
+inline bool enabled() { return false; }
+#endif
+
+}  // namespace alloc_tracking
+
+// Timer-like RAII scope that measures time and allocations made inside it.
+// A labelled scope prints its report on destruction when tracking is enabled.
+class AllocScope {
+  std::string label;
+  Timer timer;
+  AllocStats start;
+  uint64_t outer_peak;
+
+ public:
+  explicit AllocScope(std::string scope_label = "")
+      : label(std::move(scope_label)),
+        start(alloc_tracking::snapshot()),
+        outer_peak(alloc_tracking::reset_peak()) {}
+
+  AllocScope(const AllocScope&) = delete;
+  AllocScope& operator=(const AllocScope&) = delete;
+
+  ~AllocScope() {
+    if (!label.empty() && alloc_tracking::enabled()) report(label);
+    alloc_tracking::restore_peak(outer_peak);
+  }
+
+  double elapsed_ms() const { return timer.elapsed_ms(); }
+
+  // Counters accumulated since the scope opened; peak_live_bytes is the
+  // high-water mark above the live bytes at entry
+  AllocStats stats() const {
+    AllocStats now = alloc_tracking::snapshot();
+    AllocStats delta;
+    delta.allocations = now.allocations - start.allocations;
+    delta.deallocations = now.deallocations - start.deallocations;
+    delta.bytes_allocated = now.bytes_allocated - start.bytes_allocated;
+    delta.live_bytes = now.live_bytes - start.live_bytes;
+    delta.peak_live_bytes =
+        now.peak_live_bytes > start.live_bytes ? now.peak_live_bytes - start.live_bytes : 0;
+    return delta;
+  }
+
+  void report(const std::string& name) const {
+    AllocStats s = stats();
+    std::cout << "  [alloc] " << std::left << std::setw(32) << name << std::right << std::fixed
+              << std::setprecision(3) << std::setw(10) << elapsed_ms() << " ms, "
+              << s.allocations << " allocs, " << std::setprecision(1)
+              << s.bytes_allocated / 1024.0 << " KB, peak +" << s.peak_live_bytes / 1024.0
+              << " KB\n";
+    std::cout.unsetf(std::ios::fixed);
+    std::cout << std::setprecision(6);
+  }
+};
+
+// Runs one demo function inside a labelled AllocScope
+template <typename F>
+void run_demo(const std::string& name, F demo) {
+  AllocScope scope(name);
+  demo();
+}
+
+}  // namespace cpp_features
+
+#endif  // CPP_FEATURES_ALLOC_TRACKER_H
@@ -0,0 +1,86 @@
+#ifndef CPP_FEATURES_JSON_CODEC_H
+#define CPP_FEATURES_JSON_CODEC_H
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace cpp_features {
+
+// Wire formats supported by nlohmann::json. Everything except kText is one
+// of the library's binary encodings; BSON only accepts a top-level object.
+enum class JsonFormat { kText, kCbor, kMsgPack, kUbjson, kBson };
+
+constexpr std::array<JsonFormat, 5> kAllJsonFormats = {JsonFormat::kText, JsonFormat::kCbor,
+                                                       JsonFormat::kMsgPack, JsonFormat::kUbjson,
+                                                       JsonFormat::kBson};
+
+inline const char* json_format_name(JsonFormat format) {
+  switch (format) {
+    case JsonFormat::kText: return "text";
+    case JsonFormat::kCbor: return "cbor";
+    case JsonFormat::kMsgPack: return "msgpack";
+    case JsonFormat::kUbjson: return "ubjson";
+    case JsonFormat::kBson: return "bson";
+  }
+  return "unknown";
+}
+
+// File extension without the dot
+inline const char* json_format_extension(JsonFormat format) {
+  return format == JsonFormat::kText ? "json" : json_format_name(format);
+}
+
+// Parses a format name as printed by json_format_name(); throws on anything else
+inline JsonFormat parse_json_format(const std::string& name) {
+  for (JsonFormat format : kAllJsonFormats) {
+    if (name == json_format_name(format)) return format;
+  }
+  throw std::invalid_argument("unknown JSON format: " + name);
+}
+
+// Picks the format from a `--format=<name>` argument, defaulting to text
+inline JsonFormat json_format_from_args(int argc, char** argv) {
+  const std::string prefix = "--format=";
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg.compare(0, prefix.size(), prefix) == 0) {
+      return parse_json_format(arg.substr(prefix.size()));
+    }
+  }
+  return JsonFormat::kText;
+}
+
+// Templated on the json type so this header does not depend on nlohmann
+template <typename Json>
+std::vector<std::uint8_t> encode_json(const Json& value, JsonFormat format) {
+  switch (format) {
+    case JsonFormat::kText: {
+      const std::string text = value.dump();
+      return std::vector<std::uint8_t>(text.begin(), text.end());
+    }
+    case JsonFormat::kCbor: return Json::to_cbor(value);
+    case JsonFormat::kMsgPack: return Json::to_msgpack(value);
+    case JsonFormat::kUbjson: return Json::to_ubjson(value);
+    case JsonFormat::kBson: return Json::to_bson(value);
+  }
+  throw std::invalid_argument("unknown JSON format");
+}
+
+template <typename Json>
+Json decode_json(const std::vector<std::uint8_t>& bytes, JsonFormat format) {
+  switch (format) {
+    case JsonFormat::kText: return Json::parse(bytes.begin(), bytes.end());
+    case JsonFormat::kCbor: return Json::from_cbor(bytes);
+    case JsonFormat::kMsgPack: return Json::from_msgpack(bytes);
+    case JsonFormat::kUbjson: return Json::from_ubjson(bytes);
+    case JsonFormat::kBson: return Json::from_bson(bytes);
+  }
+  throw std::invalid_argument("unknown JSON format");
+}
+
+}  // namespace cpp_features
+
+#endif  // CPP_FEATURES_JSON_CODEC_H
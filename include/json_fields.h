@@ -0,0 +1,748 @@
+#ifndef CPP_FEATURES_JSON_FIELDS_H
+#define CPP_FEATURES_JSON_FIELDS_H
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(__cpp_lib_reflection)
+#include <meta>
+#endif
+
+// Compile-time field descriptors for JSON serialisation.
+//
+//   CPP_FEATURES_JSON_FIELDS(Person, name, age, hobbies, email)
+//
+// describes a type once and generates both a direct text codec (append_json /
+// read_json_text, no DOM) and nlohmann-compatible to_json/from_json. Object keys
+// are dispatched through a perfect hash computed at compile time. std::optional
+// members are omitted when empty and may be absent on input; all other members
+// are required. When the standard library provides reflection, class
+// aggregates without a macro are described automatically.
+
+namespace cpp_features {
+
+template <typename T, typename M>
+struct FieldDescriptor {
+  std::string_view name;
+  M T::*member;
+};
+
+template <typename T, typename M>
+constexpr FieldDescriptor<T, M> json_field(std::string_view name, M T::*member) {
+  return {name, member};
+}
+
+// Specialised by CPP_FEATURES_JSON_FIELDS with `static constexpr auto fields`,
+// a tuple of FieldDescriptor
+template <typename T, typename = void>
+struct JsonFields {};
+
+#if defined(__cpp_lib_reflection)
+template <typename T, typename = void>
+struct is_tuple_like : std::false_type {};
+template <typename T>
+struct is_tuple_like<T, std::void_t<decltype(std::tuple_size<T>::value)>> : std::true_type {};
+
+// Plain class aggregates only: C arrays and std::array are not objects, and a
+// CPP_FEATURES_JSON_FIELDS specialisation is more specialised and wins
+template <typename T>
+struct JsonFields<T, std::enable_if_t<std::is_class_v<T> && std::is_aggregate_v<T> &&
+                                      !is_tuple_like<T>::value>> {
+  static constexpr auto members = std::define_static_array(
+      std::meta::nonstatic_data_members_of(^^T, std::meta::access_context::unchecked()));
+  static constexpr auto fields = []<size_t... I>(std::index_sequence<I...>) {
+    return std::make_tuple(json_field(std::meta::identifier_of(members[I]), &[:members[I]:])...);
+  }(std::make_index_sequence<members.size()>{});
+};
+#endif
+
+namespace json_fields {
+
+template <typename T, typename = void>
+struct is_described : std::false_type {};
+template <typename T>
+struct is_described<T, std::void_t<decltype(JsonFields<T>::fields)>> : std::true_type {};
+
+template <typename T>
+struct is_optional : std::false_type {};
+template <typename T>
+struct is_optional<std::optional<T>> : std::true_type {};
+
+template <typename T>
+constexpr bool is_string_like_v =
+    std::is_convertible<const T&, std::string_view>::value && !std::is_arithmetic<T>::value;
+
+template <typename T, typename = void>
+struct is_sequence : std::false_type {};
+template <typename T>
+struct is_sequence<T, std::void_t<typename T::value_type, decltype(std::begin(std::declval<T&>())),
+                                  decltype(std::declval<T&>().push_back(
+                                      std::declval<typename T::value_type>()))>>
+    : std::true_type {};
+
+template <typename T>
+constexpr size_t field_count() {
+  return std::tuple_size<std::decay_t<decltype(JsonFields<T>::fields)>>::value;
+}
+
+template <typename T, typename F>
+void for_each_field(F&& f) {
+  std::apply([&](const auto&... field) { (f(field), ...); }, JsonFields<T>::fields);
+}
+
+// Calls f with the index-th descriptor; the fold compiles to a compare chain
+template <typename T, typename F, size_t... I>
+void visit_field_impl(size_t index, F& f, std::index_sequence<I...>) {
+  (void)((index == I ? (f(std::get<I>(JsonFields<T>::fields)), true) : false) || ...);
+}
+
+template <typename T, typename F>
+void visit_field(size_t index, F&& f) {
+  visit_field_impl<T>(index, f, std::make_index_sequence<field_count<T>()>{});
+}
+
+// ---------------------------------------------------------------------------
+// Perfect hash over the field names, searched for at compile time: seeded
+// FNV-1a into a power-of-two table at most 1/4 full, first collision-free seed
+// wins. A lookup is one hash, one table load and one string compare.
+
+constexpr uint64_t hash_key(std::string_view key, uint64_t seed) {
+  uint64_t h = 0xcbf29ce484222325ull ^ seed;
+  for (char c : key) h = (h ^ static_cast<unsigned char>(c)) * 0x100000001b3ull;
+  return h ^ (h >> 29);
+}
+
+constexpr size_t table_size(size_t n) {
+  size_t size = 8;
+  while (size < 4 * n) size *= 2;
+  return size;
+}
+
+constexpr uint8_t kNoField = 0xff;
+
+template <size_t N>
+struct KeyTable {
+  static constexpr size_t kSlots = table_size(N);
+  std::string_view names[N > 0 ? N : 1] = {};
+  uint8_t slots[kSlots] = {};
+  uint64_t seed = 0;
+
+  size_t find(std::string_view key) const {
+    const uint8_t index = slots[hash_key(key, seed) & (kSlots - 1)];
+    return index != kNoField && names[index] == key ? index : kNoField;
+  }
+};
+
+template <typename T>
+constexpr KeyTable<field_count<T>()> make_key_table() {
+  constexpr size_t n = field_count<T>();
+  static_assert(n < kNoField, "too many fields for the key table");
+  KeyTable<n> table;
+  std::apply(
+      [&](const auto&... field) {
+        size_t i = 0;
+        ((table.names[i++] = field.name), ...);
+      },
+      JsonFields<T>::fields);
+  for (uint64_t seed = 1; seed < 100000; ++seed) {
+    for (auto& slot : table.slots) slot = kNoField;
+    bool ok = true;
+    for (size_t f = 0; f < n && ok; ++f) {
+      uint8_t& slot = table.slots[hash_key(table.names[f], seed) & (table.kSlots - 1)];
+      ok = slot == kNoField;
+      slot = static_cast<uint8_t>(f);
+    }
+    if (ok) {
+      table.seed = seed;
+      return table;
+    }
+  }
+  throw std::logic_error("json_fields: no perfect hash seed found");
+}
+
+template <typename T>
+struct FieldTable {
+  static constexpr auto keys = make_key_table<T>();
+
+  // Bit i set when field i may be absent (std::optional)
+  static constexpr uint64_t optional_mask() {
+    uint64_t mask = 0;
+    size_t i = 0;
+    std::apply(
+        [&](const auto&... field) {
+          ((mask |= uint64_t{is_optional<std::decay_t<decltype(std::declval<T&>().*
+                                                               field.member)>>::value}
+                    << i++),
+           ...);
+        },
+        JsonFields<T>::fields);
+    return mask;
+  }
+};
+
+template <typename T>
+void check_required(uint64_t seen) {
+  constexpr size_t n = field_count<T>();
+  static_assert(n <= 64, "at most 64 fields per type");
+  const uint64_t all = n == 64 ? ~uint64_t{0} : (uint64_t{1} << n) - 1;
+  const uint64_t missing = all & ~seen & ~FieldTable<T>::optional_mask();
+  if (missing == 0) return;
+  size_t index = 0;
+  while ((missing >> index & 1) == 0) ++index;
+  throw std::runtime_error("json_fields: missing field '" +
+                           std::string(FieldTable<T>::keys.names[index]) + "'");
+}
+
+// ---------------------------------------------------------------------------
+// Direct text encoder: appends to the caller's buffer, no intermediate DOM
+
+inline void append_string(std::string& out, std::string_view s) {
+  out += '"';
+  size_t run = 0;  // unescaped runs are copied in one piece
+  for (size_t i = 0; i < s.size(); ++i) {
+    const auto c = static_cast<unsigned char>(s[i]);
+    if (c >= 0x20 && c != '"' && c != '\\') continue;
+    out.append(s.data() + run, i - run);
+    run = i + 1;
+    switch (c) {
+      case '"': out += "\\\""; break;
+      case '\\': out += "\\\\"; break;
+      case '\n': out += "\\n"; break;
+      case '\r': out += "\\r"; break;
+      case '\t': out += "\\t"; break;
+      default: {
+        static constexpr char kHex[] = "0123456789abcdef";
+        const char escaped[6] = {'\\', 'u', '0', '0', kHex[c >> 4], kHex[c & 15]};
+        out.append(escaped, sizeof(escaped));
+      }
+    }
+  }
+  out.append(s.data() + run, s.size() - run);
+  out += '"';
+}
+
+// Same spelling as nlohmann::json::dump: shortest round-trip digits, ".0" on
+// integral values, null for NaN/infinity
+inline void append_number(std::string& out, double value) {
+  if (value != value || value - value != 0.0) {
+    out += "null";
+    return;
+  }
+  char text[32];
+#if defined(__cpp_lib_to_chars)
+  const char* end = std::to_chars(text, text + sizeof(text), value).ptr;
+  const auto size = static_cast<size_t>(end - text);
+#else
+  const size_t size = static_cast<size_t>(std::snprintf(text, sizeof(text), "%.17g", value));
+#endif
+  const std::string_view digits(text, size);
+  out += digits;
+  if (digits.find_first_of(".e") == std::string_view::npos) out += ".0";
+}
+
+template <typename V>
+void append_value(std::string& out, const V& value);
+
+template <typename T>
+void append_object(std::string& out, const T& object) {
+  out += '{';
+  bool first = true;
+  for_each_field<T>([&](const auto& field) {
+    const auto& member = object.*field.member;
+    if constexpr (is_optional<std::decay_t<decltype(member)>>::value) {
+      if (!member) return;
+    }
+    if (!first) out += ',';
+    first = false;
+    out += '"';
+    out += field.name;  // field names are identifiers, nothing to escape
+    out += "\":";
+    append_value(out, member);
+  });
+  out += '}';
+}
+
+template <typename V>
+void append_value(std::string& out, const V& value) {
+  if constexpr (is_described<V>::value) {
+    append_object(out, value);
+  } else if constexpr (is_optional<V>::value) {
+    if (value) {
+      append_value(out, *value);
+    } else {
+      out += "null";
+    }
+  } else if constexpr (std::is_same<V, bool>::value) {
+    out += value ? "true" : "false";
+  } else if constexpr (std::is_integral<V>::value) {
+    char text[24];
+    const char* end = std::to_chars(text, text + sizeof(text), value).ptr;
+    out.append(text, static_cast<size_t>(end - text));
+  } else if constexpr (std::is_floating_point<V>::value) {
+    append_number(out, static_cast<double>(value));
+  } else if constexpr (is_string_like_v<V>) {
+    append_string(out, std::string_view(value));
+  } else if constexpr (is_sequence<V>::value) {
+    out += '[';
+    bool first = true;
+    for (const auto& item : value) {
+      if (!first) out += ',';
+      first = false;
+      append_value(out, item);
+    }
+    out += ']';
+  } else {
+    static_assert(sizeof(V) == 0, "json_fields: unsupported member type");
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Direct text decoder: a recursive-descent reader that writes straight into
+// the target members. Errors throw std::runtime_error with the byte offset.
+
+class TextReader {
+ public:
+  explicit TextReader(std::string_view text) : text_(text) {}
+
+  char peek() {
+    skip_whitespace();
+    return pos_ < text_.size() ? text_[pos_] : '\0';
+  }
+
+  bool consume(char c) {
+    if (peek() != c) return false;
+    ++pos_;
+    return true;
+  }
+
+  void expect(char c) {
+    if (!consume(c)) fail(std::string("expected '") + c + "'");
+  }
+
+  bool consume_literal(std::string_view word) {
+    if (peek() != word[0] || text_.substr(pos_, word.size()) != word) return false;
+    pos_ += word.size();
+    return true;
+  }
+
+  void expect_end() {
+    if (peek() != '\0') fail("trailing characters");
+  }
+
+  // The view points into the input when there are no escapes, otherwise into a
+  // scratch buffer that the next call overwrites
+  std::string_view read_string() {
+    expect('"');
+    const size_t start = pos_;
+    while (pos_ < text_.size() && text_[pos_] != '"' && text_[pos_] != '\\') ++pos_;
+    if (pos_ >= text_.size()) fail("unterminated string");
+    if (text_[pos_] == '"') return text_.substr(start, pos_++ - start);
+
+    scratch_.assign(text_.data() + start, pos_ - start);
+    while (true) {
+      if (pos_ >= text_.size()) fail("unterminated string");
+      const char c = text_[pos_++];
+      if (c == '"') return scratch_;
+      if (c != '\\') {
+        scratch_ += c;
+        continue;
+      }
+      if (pos_ >= text_.size()) fail("unterminated escape");
+      switch (text_[pos_++]) {
+        case '"': scratch_ += '"'; break;
+        case '\\': scratch_ += '\\'; break;
+        case '/': scratch_ += '/'; break;
+        case 'b': scratch_ += '\b'; break;
+        case 'f': scratch_ += '\f'; break;
+        case 'n': scratch_ += '\n'; break;
+        case 'r': scratch_ += '\r'; break;
+        case 't': scratch_ += '\t'; break;
+        case 'u': append_code_point(); break;
+        default: fail("invalid escape");
+      }
+    }
+  }
+
+  std::string_view read_number_token() {
+    skip_whitespace();
+    const size_t start = pos_;
+    while (pos_ < text_.size()) {
+      const char c = text_[pos_];
+      if (!((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E')) {
+        break;
+      }
+      ++pos_;
+    }
+    if (pos_ == start) fail("expected a number");
+    return text_.substr(start, pos_ - start);
+  }
+
+  template <typename Integer>
+  Integer read_integer() {
+    const std::string_view token = read_number_token();
+    Integer value{};
+    const auto result = std::from_chars(token.data(), token.data() + token.size(), value);
+    if (result.ec != std::errc() || result.ptr != token.data() + token.size()) {
+      fail("invalid integer");
+    }
+    return value;
+  }
+
+  double read_double() {
+    const std::string_view token = read_number_token();
+#if defined(__cpp_lib_to_chars)
+    double value = 0.0;
+    const auto result = std::from_chars(token.data(), token.data() + token.size(), value);
+    if (result.ec != std::errc() || result.ptr != token.data() + token.size()) {
+      fail("invalid number");
+    }
+    return value;
+#else
+    const std::string copy(token);
+    char* end = nullptr;
+    const double value = std::strtod(copy.c_str(), &end);
+    if (end != copy.c_str() + copy.size()) fail("invalid number");
+    return value;
+#endif
+  }
+
+  // Skips any value, used for unknown keys
+  void skip_value() {
+    switch (peek()) {
+      case '"': read_string(); return;
+      case '{':
+        ++pos_;
+        if (consume('}')) return;
+        do {
+          read_string();
+          expect(':');
+          skip_value();
+        } while (consume(','));
+        expect('}');
+        return;
+      case '[':
+        ++pos_;
+        if (consume(']')) return;
+        do {
+          skip_value();
+        } while (consume(','));
+        expect(']');
+        return;
+      default:
+        if (consume_literal("true") || consume_literal("false") || consume_literal("null")) return;
+        read_number_token();
+    }
+  }
+
+  [[noreturn]] void fail(const std::string& message) const {
+    throw std::runtime_error("json_fields: " + message + " at offset " + std::to_string(pos_));
+  }
+
+ private:
+  std::string_view text_;
+  size_t pos_ = 0;
+  std::string scratch_;
+
+  void skip_whitespace() {
+    while (pos_ < text_.size()) {
+      const char c = text_[pos_];
+      if (c != ' ' && c != '\n' && c != '\r' && c != '\t') break;
+      ++pos_;
+    }
+  }
+
+  uint32_t read_hex4() {
+    if (text_.size() - pos_ < 4) fail("truncated \\u escape");
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) {
+      const char c = text_[pos_++];
+      value <<= 4;
+      if (c >= '0' && c <= '9') {
+        value |= static_cast<uint32_t>(c - '0');
+      } else if ((c | 0x20) >= 'a' && (c | 0x20) <= 'f') {
+        value |= static_cast<uint32_t>((c | 0x20) - 'a' + 10);
+      } else {
+        fail("invalid \\u escape");
+      }
+    }
+    return value;
+  }
+
+  void append_code_point() {
+    uint32_t cp = read_hex4();
+    if (cp >= 0xd800 && cp <= 0xdbff) {
+      if (text_.substr(pos_, 2) != "\\u") fail("unpaired surrogate");
+      pos_ += 2;
+      const uint32_t low = read_hex4();
+      if (low < 0xdc00 || low > 0xdfff) fail("unpaired surrogate");
+      cp = 0x10000 + ((cp - 0xd800) << 10) + (low - 0xdc00);
+    }
+    if (cp < 0x80) {
+      scratch_ += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+      scratch_ += static_cast<char>(0xc0 | (cp >> 6));
+      scratch_ += static_cast<char>(0x80 | (cp & 0x3f));
+    } else if (cp < 0x10000) {
+      scratch_ += static_cast<char>(0xe0 | (cp >> 12));
+      scratch_ += static_cast<char>(0x80 | ((cp >> 6) & 0x3f));
+      scratch_ += static_cast<char>(0x80 | (cp & 0x3f));
+    } else {
+      scratch_ += static_cast<char>(0xf0 | (cp >> 18));
+      scratch_ += static_cast<char>(0x80 | ((cp >> 12) & 0x3f));
+      scratch_ += static_cast<char>(0x80 | ((cp >> 6) & 0x3f));
+      scratch_ += static_cast<char>(0x80 | (cp & 0x3f));
+    }
+  }
+};
+
+template <typename V>
+void read_value(TextReader& in, V& value);
+
+template <typename T>
+void read_object(TextReader& in, T& object) {
+  in.expect('{');
+  uint64_t seen = 0;
+  if (!in.consume('}')) {
+    do {
+      const size_t index = FieldTable<T>::keys.find(in.read_string());
+      in.expect(':');
+      if (index == kNoField) {
+        in.skip_value();
+        continue;
+      }
+      visit_field<T>(index, [&](const auto& field) { read_value(in, object.*field.member); });
+      seen |= uint64_t{1} << index;
+    } while (in.consume(','));
+    in.expect('}');
+  }
+  check_required<T>(seen);
+}
+
+template <typename V>
+void read_value(TextReader& in, V& value) {
+  if constexpr (is_described<V>::value) {
+    read_object(in, value);
+  } else if constexpr (is_optional<V>::value) {
+    if (in.consume_literal("null")) {
+      value.reset();
+    } else {
+      read_value(in, value.emplace());
+    }
+  } else if constexpr (std::is_same<V, bool>::value) {
+    if (in.consume_literal("true")) {
+      value = true;
+    } else if (in.consume_literal("false")) {
+      value = false;
+    } else {
+      in.fail("expected a boolean");
+    }
+  } else if constexpr (std::is_integral<V>::value) {
+    value = in.read_integer<V>();
+  } else if constexpr (std::is_floating_point<V>::value) {
+    value = static_cast<V>(in.read_double());
+  } else if constexpr (is_string_like_v<V>) {
+    value = in.read_string();
+  } else if constexpr (is_sequence<V>::value) {
+    value.clear();
+    in.expect('[');
+    if (in.consume(']')) return;
+    do {
+      typename V::value_type item{};
+      read_value(in, item);
+      value.push_back(std::move(item));
+    } while (in.consume(','));
+    in.expect(']');
+  } else {
+    static_assert(sizeof(V) == 0, "json_fields: unsupported member type");
+  }
+}
+
+// ---------------------------------------------------------------------------
+// nlohmann-style DOM adapters, templated on the json type so this header does
+// not depend on nlohmann. Keys are dispatched with the same perfect hash.
+
+template <typename Json, typename V>
+void to_dom(Json& j, const V& value);
+
+template <typename Json, typename T>
+void object_to_dom(Json& j, const T& object) {
+  j = Json::object();
+  for_each_field<T>([&](const auto& field) {
+    const auto& member = object.*field.member;
+    if constexpr (is_optional<std::decay_t<decltype(member)>>::value) {
+      if (!member) return;
+    }
+    to_dom(j[std::string(field.name)], member);
+  });
+}
+
+template <typename Json, typename V>
+void to_dom(Json& j, const V& value) {
+  if constexpr (is_described<V>::value) {
+    object_to_dom(j, value);
+  } else if constexpr (is_optional<V>::value) {
+    if (value) {
+      to_dom(j, *value);
+    } else {
+      j = nullptr;
+    }
+  } else if constexpr (is_string_like_v<V>) {
+    j = std::string(std::string_view(value));
+  } else if constexpr (is_sequence<V>::value) {
+    j = Json::array();
+    for (const auto& item : value) {
+      Json element;
+      to_dom(element, item);
+      j.push_back(std::move(element));
+    }
+  } else {
+    j = value;
+  }
+}
+
+template <typename Json, typename V>
+void from_dom(const Json& j, V& value);
+
+template <typename Json, typename T>
+void object_from_dom(const Json& j, T& object) {
+  if (!j.is_object()) throw std::runtime_error("json_fields: expected an object");
+  uint64_t seen = 0;
+  for (auto it = j.begin(); it != j.end(); ++it) {
+    const size_t index = FieldTable<T>::keys.find(it.key());
+    if (index == kNoField) continue;
+    visit_field<T>(index, [&](const auto& field) { from_dom(it.value(), object.*field.member); });
+    seen |= uint64_t{1} << index;
+  }
+  check_required<T>(seen);
+}
+
+template <typename Json, typename V>
+void from_dom(const Json& j, V& value) {
+  if constexpr (is_described<V>::value) {
+    object_from_dom(j, value);
+  } else if constexpr (is_optional<V>::value) {
+    if (j.is_null()) {
+      value.reset();
+    } else {
+      from_dom(j, value.emplace());
+    }
+  } else if constexpr (is_string_like_v<V>) {
+    value = std::string_view(j.template get_ref<const typename Json::string_t&>());
+  } else if constexpr (is_sequence<V>::value) {
+    value.clear();
+    for (const auto& element : j) {
+      typename V::value_type item{};
+      from_dom(element, item);
+      value.push_back(std::move(item));
+    }
+  } else {
+    j.get_to(value);
+  }
+}
+
+}  // namespace json_fields
+
+// Appends the JSON text of value to out
+template <typename T>
+void append_json(std::string& out, const T& value) {
+  json_fields::append_value(out, value);
+}
+
+template <typename T>
+std::string to_json_text(const T& value) {
+  std::string out;
+  append_json(out, value);
+  return out;
+}
+
+template <typename T>
+void read_json_text(std::string_view text, T& value) {
+  json_fields::TextReader in(text);
+  json_fields::read_value(in, value);
+  in.expect_end();
+}
+
+template <typename T>
+T from_json_text(std::string_view text) {
+  T value{};
+  read_json_text(text, value);
+  return value;
+}
+
+}  // namespace cpp_features
+
+// CPP_FEATURES_JSON_FIELDS(Type, member...) describes up to 16 members and only works for types
+// declared in the global namespace, used at global scope: the explicit specialisation must sit in
+// a namespace enclosing cpp_features, and the generated to_json/from_json must sit in Type's
+// namespace for nlohmann to find them through ADL.
+#define CPP_FEATURES_JSON_FIELDS(Type, ...)                                                        \
+  template <>                                                                                      \
+  struct cpp_features::JsonFields<Type> {                                                          \
+    static constexpr auto fields = std::make_tuple(CPP_FEATURES_JF_LIST_(Type, __VA_ARGS__));      \
+  };                                                                                               \
+  template <typename BasicJsonType>                                                                \
+  void to_json(BasicJsonType& j, const Type& value) {                                              \
+    ::cpp_features::json_fields::to_dom(j, value);                                                 \
+  }                                                                                                \
+  template <typename BasicJsonType>                                                                \
+  void from_json(const BasicJsonType& j, Type& value) {                                            \
+    ::cpp_features::json_fields::from_dom(j, value);                                               \
+  }
+
+// Preprocessor plumbing: one descriptor per member, dispatched on the argument count
+#define CPP_FEATURES_JF_EXPAND_(x) x
+#define CPP_FEATURES_JF_(T, m) ::cpp_features::json_field(#m, &T::m)
+#define CPP_FEATURES_JF_1_(T, m) CPP_FEATURES_JF_(T, m)
+#define CPP_FEATURES_JF_2_(T, m, ...) \
+  CPP_FEATURES_JF_(T, m), CPP_FEATURES_JF_EXPAND_(CPP_FEATURES_JF_1_(T, __VA_ARGS__))
+#define CPP_FEATURES_JF_3_(T, m, ...) \
+  CPP_FEATURES_JF_(T, m), CPP_FEATURES_JF_EXPAND_(CPP_FEATURES_JF_2_(T, __VA_ARGS__))
+#define CPP_FEATURES_JF_4_(T, m, ...) \
+  CPP_FEATURES_JF_(T, m), CPP_FEATURES_JF_EXPAND_(CPP_FEATURES_JF_3_(T, __VA_ARGS__))
+#define CPP_FEATURES_JF_5_(T, m, ...) \
+  CPP_FEATURES_JF_(T, m), CPP_FEATURES_JF_EXPAND_(CPP_FEATURES_JF_4_(T, __VA_ARGS__))
+#define CPP_FEATURES_JF_6_(T, m, ...) \
+  CPP_FEATURES_JF_(T, m), CPP_FEATURES_JF_EXPAND_(CPP_FEATURES_JF_5_(T, __VA_ARGS__))
+#define CPP_FEATURES_JF_7_(T, m, ...) \
+  CPP_FEATURES_JF_(T, m), CPP_FEATURES_JF_EXPAND_(CPP_FEATURES_JF_6_(T, __VA_ARGS__))
+#define CPP_FEATURES_JF_8_(T, m, ...) \
+  CPP_FEATURES_JF_(T, m), CPP_FEATURES_JF_EXPAND_(CPP_FEATURES_JF_7_(T, __VA_ARGS__))
+#define CPP_FEATURES_JF_9_(T, m, ...) \
+  CPP_FEATURES_JF_(T, m), CPP_FEATURES_JF_EXPAND_(CPP_FEATURES_JF_8_(T, __VA_ARGS__))
+#define CPP_FEATURES_JF_10_(T, m, ...) \
+  CPP_FEATURES_JF_(T, m), CPP_FEATURES_JF_EXPAND_(CPP_FEATURES_JF_9_(T, __VA_ARGS__))
+#define CPP_FEATURES_JF_11_(T, m, ...) \
+  CPP_FEATURES_JF_(T, m), CPP_FEATURES_JF_EXPAND_(CPP_FEATURES_JF_10_(T, __VA_ARGS__))
+#define CPP_FEATURES_JF_12_(T, m, ...) \
+  CPP_FEATURES_JF_(T, m), CPP_FEATURES_JF_EXPAND_(CPP_FEATURES_JF_11_(T, __VA_ARGS__))
+#define CPP_FEATURES_JF_13_(T, m, ...) \
+  CPP_FEATURES_JF_(T, m), CPP_FEATURES_JF_EXPAND_(CPP_FEATURES_JF_12_(T, __VA_ARGS__))
+#define CPP_FEATURES_JF_14_(T, m, ...) \
+  CPP_FEATURES_JF_(T, m), CPP_FEATURES_JF_EXPAND_(CPP_FEATURES_JF_13_(T, __VA_ARGS__))
+#define CPP_FEATURES_JF_15_(T, m, ...) \
+  CPP_FEATURES_JF_(T, m), CPP_FEATURES_JF_EXPAND_(CPP_FEATURES_JF_14_(T, __VA_ARGS__))
+#define CPP_FEATURES_JF_16_(T, m, ...) \
+  CPP_FEATURES_JF_(T, m), CPP_FEATURES_JF_EXPAND_(CPP_FEATURES_JF_15_(T, __VA_ARGS__))
+#define CPP_FEATURES_JF_SELECT_(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, \
+                                _16, NAME, ...)                                                    \
+  NAME
+#define CPP_FEATURES_JF_LIST_(T, ...)                                                              \
+  CPP_FEATURES_JF_EXPAND_(CPP_FEATURES_JF_SELECT_(                                                 \
+      __VA_ARGS__, CPP_FEATURES_JF_16_, CPP_FEATURES_JF_15_, CPP_FEATURES_JF_14_,                  \
+      CPP_FEATURES_JF_13_, CPP_FEATURES_JF_12_, CPP_FEATURES_JF_11_, CPP_FEATURES_JF_10_,          \
+      CPP_FEATURES_JF_9_, CPP_FEATURES_JF_8_, CPP_FEATURES_JF_7_, CPP_FEATURES_JF_6_,              \
+      CPP_FEATURES_JF_5_, CPP_FEATURES_JF_4_, CPP_FEATURES_JF_3_, CPP_FEATURES_JF_2_,              \
+      CPP_FEATURES_JF_1_)(T, __VA_ARGS__))
+
+#endif  // CPP_FEATURES_JSON_FIELDS_H
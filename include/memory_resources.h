@@ -0,0 +1,301 @@
+#ifndef CPP_FEATURES_MEMORY_RESOURCES_H
+#define CPP_FEATURES_MEMORY_RESOURCES_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace cpp_features {
+
+// Monotonic arena: bump-pointer allocation out of large chunks, nothing is
+// freed until release()/destruction. On Linux chunks are mmap'ed with
+// MAP_HUGETLB when huge pages are reserved, otherwise with a transparent
+// huge page hint; elsewhere they come from the upstream resource.
+class ArenaResource : public std::pmr::memory_resource {
+ public:
+  static constexpr size_t kHugePageSize = size_t{2} << 20;
+
+  explicit ArenaResource(size_t chunk_bytes = size_t{32} << 20,
+                         std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+      : chunk_bytes_(round_up(chunk_bytes, kHugePageSize)), upstream_(upstream) {}
+
+  ArenaResource(const ArenaResource&) = delete;
+  ArenaResource& operator=(const ArenaResource&) = delete;
+
+  ~ArenaResource() override { release(); }
+
+  void release() {
+    for (const Chunk& chunk : chunks_) {
+#if defined(__linux__)
+      if (chunk.mapped) {
+        munmap(chunk.base, chunk.size);
+        continue;
+      }
+#endif
+      upstream_->deallocate(chunk.base, chunk.size, alignof(std::max_align_t));
+    }
+    chunks_.clear();
+    cursor_ = nullptr;
+    end_ = nullptr;
+    bytes_used_ = 0;
+  }
+
+  size_t bytes_reserved() const {
+    size_t total = 0;
+    for (const Chunk& chunk : chunks_) total += chunk.size;
+    return total;
+  }
+  size_t bytes_used() const { return bytes_used_; }
+  size_t huge_page_chunks() const {
+    return static_cast<size_t>(
+        std::count_if(chunks_.begin(), chunks_.end(), [](const Chunk& c) { return c.huge; }));
+  }
+
+ private:
+  struct Chunk {
+    void* base;
+    size_t size;
+    bool mapped;
+    bool huge;
+  };
+
+  size_t chunk_bytes_;
+  std::pmr::memory_resource* upstream_;
+  std::vector<Chunk> chunks_;
+  char* cursor_ = nullptr;
+  char* end_ = nullptr;
+  size_t bytes_used_ = 0;
+
+  static size_t round_up(size_t value, size_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+  }
+
+  void* do_allocate(size_t bytes, size_t alignment) override {
+    char* aligned = align(cursor_, alignment);
+    if (aligned == nullptr || aligned + bytes > end_) {
+      add_chunk(bytes + alignment);
+      aligned = align(cursor_, alignment);
+    }
+    cursor_ = aligned + bytes;
+    bytes_used_ += bytes;
+    return aligned;
+  }
+
+  void do_deallocate(void*, size_t, size_t) override {}
+
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+
+  static char* align(char* p, size_t alignment) {
+    if (p == nullptr) return nullptr;
+    auto address = reinterpret_cast<std::uintptr_t>(p);
+    address = (address + alignment - 1) & ~static_cast<std::uintptr_t>(alignment - 1);
+    return reinterpret_cast<char*>(address);
+  }
+
+  void add_chunk(size_t min_bytes) {
+    const size_t size = round_up(std::max(chunk_bytes_, min_bytes), kHugePageSize);
+    Chunk chunk{nullptr, size, false, false};
+#if defined(__linux__)
+    void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+                   -1, 0);
+    if (p != MAP_FAILED) {
+      chunk = Chunk{p, size, true, true};
+    } else {
+      p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (p != MAP_FAILED) {
+#ifdef MADV_HUGEPAGE
+        madvise(p, size, MADV_HUGEPAGE);
+#endif
+        chunk = Chunk{p, size, true, false};
+      }
+    }
+#endif
+    if (chunk.base == nullptr) {
+      chunk.base = upstream_->allocate(size, alignof(std::max_align_t));
+    }
+    chunks_.push_back(chunk);
+    cursor_ = static_cast<char*>(chunk.base);
+    end_ = cursor_ + size;
+  }
+};
+
+// Fixed-size block pool: requests up to block_size bytes are served from an
+// intrusive free list carved out of slabs; larger or over-aligned requests
+// go straight upstream. Not thread-safe, like unsynchronized_pool_resource.
+class FixedPoolResource : public std::pmr::memory_resource {
+ public:
+  explicit FixedPoolResource(size_t block_size, size_t blocks_per_slab = 4096,
+                             std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+      : block_size_(std::max(round_up(block_size, alignof(std::max_align_t)), sizeof(FreeBlock))),
+        blocks_per_slab_(blocks_per_slab),
+        upstream_(upstream) {}
+
+  FixedPoolResource(const FixedPoolResource&) = delete;
+  FixedPoolResource& operator=(const FixedPoolResource&) = delete;
+
+  ~FixedPoolResource() override {
+    for (void* slab : slabs_) {
+      upstream_->deallocate(slab, block_size_ * blocks_per_slab_, alignof(std::max_align_t));
+    }
+  }
+
+  size_t block_size() const { return block_size_; }
+  size_t slab_count() const { return slabs_.size(); }
+  size_t pooled_allocations() const { return pooled_allocations_; }
+  size_t upstream_allocations() const { return upstream_allocations_; }
+
+ private:
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+
+  size_t block_size_;
+  size_t blocks_per_slab_;
+  std::pmr::memory_resource* upstream_;
+  std::vector<void*> slabs_;
+  FreeBlock* free_list_ = nullptr;
+  size_t pooled_allocations_ = 0;
+  size_t upstream_allocations_ = 0;
+
+  static size_t round_up(size_t value, size_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+  }
+
+  bool pooled(size_t bytes, size_t alignment) const {
+    return bytes <= block_size_ && alignment <= alignof(std::max_align_t);
+  }
+
+  void* do_allocate(size_t bytes, size_t alignment) override {
+    if (!pooled(bytes, alignment)) {
+      ++upstream_allocations_;
+      return upstream_->allocate(bytes, alignment);
+    }
+    if (free_list_ == nullptr) add_slab();
+    FreeBlock* block = free_list_;
+    free_list_ = block->next;
+    ++pooled_allocations_;
+    return block;
+  }
+
+  void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+    if (!pooled(bytes, alignment)) {
+      upstream_->deallocate(p, bytes, alignment);
+      return;
+    }
+    auto* block = static_cast<FreeBlock*>(p);
+    block->next = free_list_;
+    free_list_ = block;
+  }
+
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+
+  void add_slab() {
+    char* slab = static_cast<char*>(
+        upstream_->allocate(block_size_ * blocks_per_slab_, alignof(std::max_align_t)));
+    slabs_.push_back(slab);
+    // Thread the new blocks onto the free list in address order
+    for (size_t i = blocks_per_slab_; i-- > 0;) {
+      auto* block = reinterpret_cast<FreeBlock*>(slab + i * block_size_);
+      block->next = free_list_;
+      free_list_ = block;
+    }
+  }
+};
+
+// Thread-local caching resource: power-of-two size classes (16 B - 4 KB),
+// each thread keeps a bounded free list per class so repeated
+// allocate/deallocate pairs never leave the thread. Cached blocks go back to
+// new_delete_resource() at thread exit. Every instance shares the same
+// caches, so all instances compare equal and may free each other's blocks.
+class ThreadCachingResource : public std::pmr::memory_resource {
+ public:
+  static constexpr size_t kMinClassBytes = 16;
+  static constexpr size_t kClassCount = 9;  // 16, 32, ..., 4096
+  static constexpr size_t kMaxCachedPerClass = 1024;
+
+ private:
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+
+  struct ThreadCache {
+    std::array<FreeBlock*, kClassCount> heads{};
+    std::array<size_t, kClassCount> counts{};
+
+    ~ThreadCache() {
+      for (size_t c = 0; c < kClassCount; ++c) {
+        while (heads[c] != nullptr) {
+          FreeBlock* block = heads[c];
+          heads[c] = block->next;
+          std::pmr::new_delete_resource()->deallocate(block, class_bytes(c),
+                                                      alignof(std::max_align_t));
+        }
+      }
+    }
+  };
+
+  static ThreadCache& cache() {
+    thread_local ThreadCache thread_cache;
+    return thread_cache;
+  }
+
+  static size_t class_bytes(size_t size_class) { return kMinClassBytes << size_class; }
+
+  // Smallest class that fits, or kClassCount when the request is not cached
+  static size_t size_class(size_t bytes, size_t alignment) {
+    if (alignment > alignof(std::max_align_t)) return kClassCount;
+    size_t c = 0;
+    while (c < kClassCount && class_bytes(c) < bytes) ++c;
+    return c;
+  }
+
+  void* do_allocate(size_t bytes, size_t alignment) override {
+    const size_t c = size_class(bytes, alignment);
+    if (c == kClassCount) return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+
+    ThreadCache& tc = cache();
+    if (FreeBlock* block = tc.heads[c]) {
+      tc.heads[c] = block->next;
+      --tc.counts[c];
+      return block;
+    }
+    return std::pmr::new_delete_resource()->allocate(class_bytes(c), alignof(std::max_align_t));
+  }
+
+  void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+    const size_t c = size_class(bytes, alignment);
+    if (c == kClassCount) {
+      std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+      return;
+    }
+
+    ThreadCache& tc = cache();
+    if (tc.counts[c] >= kMaxCachedPerClass) {
+      std::pmr::new_delete_resource()->deallocate(p, class_bytes(c), alignof(std::max_align_t));
+      return;
+    }
+    auto* block = static_cast<FreeBlock*>(p);
+    block->next = tc.heads[c];
+    tc.heads[c] = block;
+    ++tc.counts[c];
+  }
+
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+    return dynamic_cast<const ThreadCachingResource*>(&other) != nullptr;
+  }
+};
+
+}  // namespace cpp_features
+
+#endif  // CPP_FEATURES_MEMORY_RESOURCES_H
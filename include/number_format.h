@@ -0,0 +1,186 @@
+#ifndef CPP_FEATURES_NUMBER_FORMAT_H
+#define CPP_FEATURES_NUMBER_FORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ios>
+#include <string>
+#include <type_traits>
+
+#if __cplusplus >= 201703L && defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+#endif
+
+namespace cpp_features {
+
+// Decimal formatting kernels for integers and floating-point values. Integers
+// are written two digits at a time from a pair table into a buffer sized by a
+// branch-free digit count; doubles use the shortest representation that reads
+// back to the same value (std::to_chars when the library has it).
+// Usable from C++11; nothing here allocates except to_text.
+namespace number_format {
+
+// Enough for any 64-bit integer and any shortest-form double or float
+constexpr size_t kMaxChars = 32;
+
+// Integer types printed as numbers; bool and character types keep their
+// iostream meaning and are not covered
+template <typename T>
+struct is_integer
+    : std::integral_constant<bool, std::is_integral<T>::value && !std::is_same<T, bool>::value &&
+                                       (sizeof(T) > 1) && !std::is_same<T, wchar_t>::value &&
+                                       !std::is_same<T, char16_t>::value &&
+                                       !std::is_same<T, char32_t>::value> {};
+
+template <typename T>
+struct is_floating
+    : std::integral_constant<bool,
+                             std::is_same<T, double>::value || std::is_same<T, float>::value> {};
+
+template <typename T>
+struct is_number : std::integral_constant<bool, is_integer<T>::value || is_floating<T>::value> {};
+
+namespace detail {
+
+inline const char* digit_pairs() {
+  static const char pairs[] =
+      "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+      "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+      "8081828384858687888990919293949596979899";
+  return pairs;
+}
+
+// Number of decimal digits in value (1 for 0): estimate from the bit width,
+// then correct by one comparison against a power of ten
+inline unsigned count_digits(uint64_t value) {
+  static const uint64_t powers[] = {0,
+                                    10ULL,
+                                    100ULL,
+                                    1000ULL,
+                                    10000ULL,
+                                    100000ULL,
+                                    1000000ULL,
+                                    10000000ULL,
+                                    100000000ULL,
+                                    1000000000ULL,
+                                    10000000000ULL,
+                                    100000000000ULL,
+                                    1000000000000ULL,
+                                    10000000000000ULL,
+                                    100000000000000ULL,
+                                    1000000000000000ULL,
+                                    10000000000000000ULL,
+                                    100000000000000000ULL,
+                                    1000000000000000000ULL,
+                                    10000000000000000000ULL};
+#if defined(__GNUC__) || defined(__clang__)
+  const unsigned bits = 64 - static_cast<unsigned>(__builtin_clzll(value | 1));
+#else
+  unsigned bits = 1;
+  for (uint64_t rest = value >> 1; rest != 0; rest >>= 1) ++bits;
+#endif
+  // bits * log10(2) ~ bits * 1233 / 4096
+  const unsigned estimate = (bits * 1233) >> 12;
+  return estimate + 1 - (value < powers[estimate] ? 1 : 0);
+}
+
+inline char* write_unsigned(char* out, uint64_t value) {
+  const unsigned digits = count_digits(value);
+  char* end = out + digits;
+  char* pos = end;
+  const char* pairs = digit_pairs();
+  while (value >= 100) {
+    const size_t pair = static_cast<size_t>(value % 100) * 2;
+    value /= 100;
+    pos -= 2;
+    std::memcpy(pos, pairs + pair, 2);
+  }
+  if (value >= 10) {
+    std::memcpy(pos - 2, pairs + value * 2, 2);
+  } else {
+    pos[-1] = static_cast<char>('0' + value);
+  }
+  return end;
+}
+
+// Shortest "%.Ng" that parses back to value, for libraries without
+// floating-point std::to_chars
+inline char* write_shortest_printf(char* out, double value, int min_digits, int max_digits) {
+  int length = 0;
+  for (int digits = min_digits; digits <= max_digits; ++digits) {
+    length = std::snprintf(out, kMaxChars, "%.*g", digits, value);
+    if (std::strtod(out, nullptr) == value) break;
+  }
+  return out + length;
+}
+
+}  // namespace detail
+
+// Writes the decimal form of value to out, which must hold kMaxChars bytes;
+// returns one past the last character written (no terminator)
+template <typename T>
+typename std::enable_if<is_integer<T>::value && std::is_unsigned<T>::value, char*>::type
+format_number(char* out, T value) {
+  return detail::write_unsigned(out, value);
+}
+
+template <typename T>
+typename std::enable_if<is_integer<T>::value && std::is_signed<T>::value, char*>::type
+format_number(char* out, T value) {
+  uint64_t magnitude = static_cast<uint64_t>(static_cast<int64_t>(value));
+  if (value < 0) {
+    *out++ = '-';
+    magnitude = 0 - magnitude;
+  }
+  return detail::write_unsigned(out, magnitude);
+}
+
+inline char* format_number(char* out, double value) {
+#if defined(__cpp_lib_to_chars)
+  return std::to_chars(out, out + kMaxChars, value).ptr;
+#else
+  return detail::write_shortest_printf(out, value, 15, 17);
+#endif
+}
+
+inline char* format_number(char* out, float value) {
+#if defined(__cpp_lib_to_chars)
+  return std::to_chars(out, out + kMaxChars, value).ptr;
+#else
+  // Every float is exact as a double, so the shortest float digits are found
+  // by checking the round trip through float
+  int length = 0;
+  for (int digits = 6; digits <= 9; ++digits) {
+    length = std::snprintf(out, kMaxChars, "%.*g", digits, static_cast<double>(value));
+    if (std::strtof(out, nullptr) == value) break;
+  }
+  return out + length;
+#endif
+}
+
+// Allocating convenience wrapper, e.g. for map keys
+template <typename T>
+typename std::enable_if<is_number<T>::value, std::string>::type to_text(T value) {
+  char buffer[kMaxChars];
+  return std::string(buffer, format_number(buffer, value));
+}
+
+// True when a stream would print numbers in plain decimal, i.e. no base,
+// sign, point or fixed/scientific flags are set. Callers fall back to
+// operator<< otherwise so stream manipulators keep working.
+inline bool uses_default_format(const std::ios_base& stream) {
+  const std::ios_base::fmtflags custom = std::ios_base::basefield | std::ios_base::floatfield |
+                                         std::ios_base::showpos | std::ios_base::showpoint |
+                                         std::ios_base::showbase | std::ios_base::uppercase;
+  return (stream.flags() & custom) == std::ios_base::dec;
+}
+
+}  // namespace number_format
+}  // namespace cpp_features
+
+#endif  // CPP_FEATURES_NUMBER_FORMAT_H
@@ -0,0 +1,313 @@
+#ifndef CPP_FEATURES_SMALL_CONTAINERS_H
+#define CPP_FEATURES_SMALL_CONTAINERS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace cpp_features {
+
+// Vector that stores up to N elements inline and only heap-allocates beyond
+// that. Iterators are plain pointers; growth doubles like std::vector.
+template <typename T, size_t N>
+class small_vector {
+ public:
+  using value_type = T;
+  using size_type = size_t;
+  using iterator = T*;
+  using const_iterator = const T*;
+  using reference = T&;
+  using const_reference = const T&;
+
+  small_vector() = default;
+
+  small_vector(std::initializer_list<T> init) {
+    reserve(init.size());
+    for (const T& value : init) push_back(value);
+  }
+
+  small_vector(const small_vector& other) {
+    reserve(other.size_);
+    std::uninitialized_copy(other.begin(), other.end(), data_);
+    size_ = other.size_;
+  }
+
+  small_vector(small_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+    take(std::move(other));
+  }
+
+  small_vector& operator=(const small_vector& other) {
+    if (this != &other) {
+      clear();
+      reserve(other.size_);
+      std::uninitialized_copy(other.begin(), other.end(), data_);
+      size_ = other.size_;
+    }
+    return *this;
+  }
+
+  small_vector& operator=(small_vector&& other) noexcept(
+      std::is_nothrow_move_constructible_v<T>) {
+    if (this != &other) {
+      clear();
+      release_heap();
+      take(std::move(other));
+    }
+    return *this;
+  }
+
+  ~small_vector() {
+    clear();
+    release_heap();
+  }
+
+  T* data() { return data_; }
+  const T* data() const { return data_; }
+  size_t size() const { return size_; }
+  size_t capacity() const { return capacity_; }
+  bool empty() const { return size_ == 0; }
+  bool is_inline() const { return data_ == inline_data(); }
+  static constexpr size_t inline_capacity() { return N; }
+
+  T& operator[](size_t i) { return data_[i]; }
+  const T& operator[](size_t i) const { return data_[i]; }
+  T& back() { return data_[size_ - 1]; }
+  const T& back() const { return data_[size_ - 1]; }
+
+  iterator begin() { return data_; }
+  iterator end() { return data_ + size_; }
+  const_iterator begin() const { return data_; }
+  const_iterator end() const { return data_ + size_; }
+
+  void reserve(size_t new_capacity) {
+    if (new_capacity <= capacity_) return;
+    T* new_data = allocate(new_capacity);
+    try {
+      adopt(new_data, new_capacity);
+    } catch (...) {
+      deallocate(new_data);
+      throw;
+    }
+  }
+
+  template <typename... Args>
+  T& emplace_back(Args&&... args) {
+    if (size_ < capacity_) {
+      T* slot = ::new (static_cast<void*>(data_ + size_)) T(std::forward<Args>(args)...);
+      ++size_;
+      return *slot;
+    }
+    // args may refer to one of our own elements (v.push_back(v[0])), so build
+    // the new element in the new buffer before the old ones are moved out
+    const size_t new_capacity = std::max<size_t>(size_t{capacity_} * 2, 1);
+    T* new_data = allocate(new_capacity);
+    T* slot = nullptr;
+    try {
+      slot = ::new (static_cast<void*>(new_data + size_)) T(std::forward<Args>(args)...);
+      adopt(new_data, new_capacity);
+    } catch (...) {
+      if (slot != nullptr) std::destroy_at(slot);
+      deallocate(new_data);
+      throw;
+    }
+    ++size_;
+    return *slot;
+  }
+
+  void push_back(const T& value) { emplace_back(value); }
+  void push_back(T&& value) { emplace_back(std::move(value)); }
+
+  void pop_back() {
+    --size_;
+    std::destroy_at(data_ + size_);
+  }
+
+  void clear() {
+    std::destroy(data_, data_ + size_);
+    size_ = 0;
+  }
+
+  friend bool operator==(const small_vector& a, const small_vector& b) {
+    return std::equal(a.begin(), a.end(), b.begin(), b.end());
+  }
+
+ private:
+  alignas(T) unsigned char inline_[N * sizeof(T)];
+  T* data_ = inline_data();
+  uint32_t size_ = 0;  // 32-bit counters keep the header at 16 bytes
+  uint32_t capacity_ = N;
+
+  T* inline_data() { return reinterpret_cast<T*>(inline_); }
+  const T* inline_data() const { return reinterpret_cast<const T*>(inline_); }
+
+  // Over-aligned element types need the aligned operator new/delete pair
+  static T* allocate(size_t n) {
+    if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+      return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{alignof(T)}));
+    } else {
+      return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+  }
+
+  static void deallocate(T* p) {
+    if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+      ::operator delete(p, std::align_val_t{alignof(T)});
+    } else {
+      ::operator delete(p);
+    }
+  }
+
+  // Moves the current elements into new_data and makes it the buffer. Like
+  // std::vector, copies instead when T's move may throw and T is copyable, so
+  // a throwing relocation leaves *this untouched; the caller still owns
+  // new_data on exception
+  void adopt(T* new_data, size_t new_capacity) {
+    if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+      std::uninitialized_move(data_, data_ + size_, new_data);
+    } else {
+      std::uninitialized_copy(data_, data_ + size_, new_data);
+    }
+    std::destroy(data_, data_ + size_);
+    release_heap();
+    data_ = new_data;
+    capacity_ = static_cast<uint32_t>(new_capacity);
+  }
+
+  void release_heap() {
+    if (!is_inline()) deallocate(data_);
+    data_ = inline_data();
+    capacity_ = N;
+  }
+
+  // Steals a heap buffer, or moves inline elements one by one
+  void take(small_vector&& other) {
+    if (other.is_inline()) {
+      std::uninitialized_move(other.begin(), other.end(), data_);
+      size_ = other.size_;
+      other.clear();
+    } else {
+      data_ = other.data_;
+      size_ = other.size_;
+      capacity_ = other.capacity_;
+      other.data_ = other.inline_data();
+      other.size_ = 0;
+      other.capacity_ = N;
+    }
+  }
+};
+
+// String with N - 1 characters of inline capacity (libstdc++'s std::string
+// keeps 15). Inline and heap pointer share storage, so sizeof is N + 8.
+template <size_t N>
+class SmallString {
+  static_assert(N >= sizeof(char*) && N % 8 == 0, "N must be a multiple of 8");
+
+ public:
+  SmallString() { inline_[0] = '\0'; }
+  SmallString(const char* s) : SmallString(std::string_view(s)) {}
+  SmallString(const std::string& s) : SmallString(std::string_view(s)) {}
+  SmallString(std::string_view s) { assign(s); }
+
+  SmallString(const SmallString& other) { assign(other.view()); }
+  SmallString(SmallString&& other) noexcept { take(other); }
+
+  SmallString& operator=(const SmallString& other) {
+    if (this != &other) assign(other.view());
+    return *this;
+  }
+  SmallString& operator=(SmallString&& other) noexcept {
+    if (this != &other) {
+      release_heap();
+      take(other);
+    }
+    return *this;
+  }
+  SmallString& operator=(std::string_view s) {
+    assign(s);
+    return *this;
+  }
+  SmallString& operator=(const std::string& s) { return *this = std::string_view(s); }
+  SmallString& operator=(const char* s) { return *this = std::string_view(s); }
+
+  ~SmallString() { release_heap(); }
+
+  const char* data() const { return is_inline() ? inline_ : heap_; }
+  const char* c_str() const { return data(); }
+  size_t size() const { return size_; }
+  size_t length() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  bool is_inline() const { return capacity_ == 0; }
+  static constexpr size_t inline_capacity() { return N - 1; }
+
+  std::string_view view() const { return {data(), size_}; }
+  operator std::string_view() const { return view(); }
+  std::string str() const { return std::string(view()); }
+
+  friend bool operator==(const SmallString& a, const SmallString& b) {
+    return a.view() == b.view();
+  }
+  friend bool operator<(const SmallString& a, const SmallString& b) {
+    return a.view() < b.view();
+  }
+  friend std::ostream& operator<<(std::ostream& os, const SmallString& s) {
+    return os << s.view();
+  }
+
+ private:
+  union {
+    char inline_[N];
+    char* heap_;
+  };
+  uint32_t size_ = 0;
+  uint32_t capacity_ = 0;  // 0 while inline, heap capacity otherwise
+
+  void assign(std::string_view s) {
+    if (s.size() < N) {
+      char text[N];  // s may point into our own heap buffer
+      std::memcpy(text, s.data(), s.size());
+      release_heap();
+      std::memcpy(inline_, text, s.size());
+      inline_[s.size()] = '\0';
+    } else {
+      if (capacity_ < s.size()) {
+        char* buffer = new char[s.size() + 1];
+        release_heap();
+        heap_ = buffer;
+        capacity_ = static_cast<uint32_t>(s.size());
+      }
+      std::memmove(heap_, s.data(), s.size());  // s may be a view into heap_
+      heap_[s.size()] = '\0';
+    }
+    size_ = static_cast<uint32_t>(s.size());
+  }
+
+  void release_heap() {
+    if (!is_inline()) {
+      delete[] heap_;
+      capacity_ = 0;
+      inline_[0] = '\0';
+    }
+  }
+
+  void take(SmallString& other) {
+    std::memcpy(inline_, other.inline_, N);  // copies either the inline text or the pointer
+    size_ = other.size_;
+    capacity_ = other.capacity_;
+    other.capacity_ = 0;
+    other.size_ = 0;
+    other.inline_[0] = '\0';
+  }
+};
+
+}  // namespace cpp_features
+
+#endif  // CPP_FEATURES_SMALL_CONTAINERS_H
@@ -0,0 +1,107 @@
+#ifndef CPP_FEATURES_THREAD_POOL_H
+#define CPP_FEATURES_THREAD_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cpp_features {
+
+// Fixed set of worker threads for data-parallel loops. parallel_for hands out
+// task indices through an atomic counter, so uneven tasks balance themselves;
+// the calling thread works too and the call returns once every task is done.
+// One parallel_for runs at a time per pool.
+class ThreadPool {
+ public:
+  // 0 means one thread per hardware thread (the caller counts as one)
+  explicit ThreadPool(size_t threads = 0) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    workers_.reserve(threads - 1);
+    for (size_t i = 1; i < threads; ++i) workers_.emplace_back([this] { worker_loop(); });
+  }
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_) worker.join();
+  }
+
+  size_t size() const { return workers_.size() + 1; }
+
+  // Calls task(i) for every i in [0, count); rethrows the first exception
+  void parallel_for(size_t count, const std::function<void(size_t)>& task) {
+    if (count == 0) return;
+    std::unique_lock<std::mutex> lock(mutex_);
+    task_ = &task;
+    count_ = count;
+    next_.store(0, std::memory_order_relaxed);
+    active_ = workers_.size();
+    error_ = nullptr;
+    ++generation_;
+    lock.unlock();
+    wake_.notify_all();
+
+    run_tasks();
+
+    lock.lock();
+    done_.wait(lock, [this] { return active_ == 0; });
+    task_ = nullptr;
+    if (error_) std::rethrow_exception(error_);
+  }
+
+ private:
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable done_;
+  const std::function<void(size_t)>* task_ = nullptr;
+  size_t count_ = 0;
+  std::atomic<size_t> next_{0};
+  size_t active_ = 0;  // workers still inside the current generation
+  size_t generation_ = 0;
+  bool stopping_ = false;
+  std::exception_ptr error_;
+
+  void run_tasks() {
+    for (size_t i = next_.fetch_add(1); i < count_; i = next_.fetch_add(1)) {
+      try {
+        (*task_)(i);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!error_) error_ = std::current_exception();
+        next_.store(count_);  // stop handing out work
+      }
+    }
+  }
+
+  void worker_loop() {
+    size_t seen = 0;
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        wake_.wait(lock, [&] { return stopping_ || generation_ != seen; });
+        if (stopping_) return;
+        seen = generation_;
+      }
+      run_tasks();
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (--active_ == 0) done_.notify_one();
+    }
+  }
+};
+
+}  // namespace cpp_features
+
+#endif  // CPP_FEATURES_THREAD_POOL_H
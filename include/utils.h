@@ -5,6 +5,9 @@
 #include <iomanip>
 #include <iostream>
 #include <string>
+#include <type_traits>
+
+#include "number_format.h"
 
 namespace cpp_features {
 
@@ -27,7 +30,28 @@ class Demo {
 
   template <typename T>
   static void print_value(const std::string& name, const T& value) {
-    std::cout << "  " << std::left << std::setw(20) << name << ": " << value << "\n";
+    std::cout << "  " << std::left << std::setw(20) << name << ": ";
+    print_number_or_stream(value, number_format::is_number<T>());
+    std::cout << "\n";
+  }
+
+ private:
+  template <typename T>
+  static void print_number_or_stream(const T& value, std::false_type) {
+    std::cout << value;
+  }
+
+  // Integers and doubles skip the locale/facet machinery of operator<<;
+  // doubles print in shortest round-trip form instead of 6 significant digits
+  template <typename T>
+  static void print_number_or_stream(const T& value, std::true_type) {
+    if (!number_format::uses_default_format(std::cout)) {
+      std::cout << value;
+      return;
+    }
+    char buffer[number_format::kMaxChars];
+    char* end = number_format::format_number(buffer, value);
+    std::cout.write(buffer, end - buffer);
   }
 };
 
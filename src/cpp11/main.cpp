@@ -11,6 +11,7 @@
 #include <unordered_map>
 #include <vector>
 
+#include "../include/alloc_tracker.h"
 #include "../include/utils.h"
 
 namespace cpp11_features {
@@ -114,7 +115,7 @@ void demo_range_based_for() {
   // With index (C++11 way)
   std::cout << "  With index:\n";
   for (size_t i = 0; i < fruits.size(); ++i) {
-    cpp_features::Demo::print_value(std::to_string(i), fruits[i]);
+    cpp_features::Demo::print_value(cpp_features::number_format::to_text(i), fruits[i]);
   }
 }
 
@@ -231,15 +232,15 @@ void demo_tuples() {
 int main() {
   cpp_features::Demo::print_header("C++11 Features Showcase");
 
-  cpp11_features::demo_auto_keyword();
-  cpp11_features::demo_lambda_expressions();
-  cpp11_features::demo_smart_pointers();
-  cpp11_features::demo_range_based_for();
-  cpp11_features::demo_initializer_lists();
-  cpp11_features::demo_nullptr();
-  cpp11_features::demo_decltype();
-  cpp11_features::demo_threading();
-  cpp11_features::demo_tuples();
+  cpp_features::run_demo("demo_auto_keyword", cpp11_features::demo_auto_keyword);
+  cpp_features::run_demo("demo_lambda_expressions", cpp11_features::demo_lambda_expressions);
+  cpp_features::run_demo("demo_smart_pointers", cpp11_features::demo_smart_pointers);
+  cpp_features::run_demo("demo_range_based_for", cpp11_features::demo_range_based_for);
+  cpp_features::run_demo("demo_initializer_lists", cpp11_features::demo_initializer_lists);
+  cpp_features::run_demo("demo_nullptr", cpp11_features::demo_nullptr);
+  cpp_features::run_demo("demo_decltype", cpp11_features::demo_decltype);
+  cpp_features::run_demo("demo_threading", cpp11_features::demo_threading);
+  cpp_features::run_demo("demo_tuples", cpp11_features::demo_tuples);
 
   std::cout << "\nC++11 features demonstration completed!\n";
   return 0;
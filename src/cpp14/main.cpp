@@ -7,6 +7,7 @@
 #include <type_traits>
 #include <vector>
 
+#include "../include/alloc_tracker.h"
 #include "../include/utils.h"
 
 namespace cpp14_features {
@@ -248,14 +249,14 @@ void demo_decltype_auto() {
 int main() {
   cpp_features::Demo::print_header("C++14 Features Showcase");
 
-  cpp14_features::demo_return_type_deduction();
-  cpp14_features::demo_generic_lambdas();
-  cpp14_features::demo_variable_templates();
-  cpp14_features::demo_binary_literals();
-  cpp14_features::demo_improved_constexpr();
-  cpp14_features::demo_make_unique();
-  cpp14_features::demo_integer_sequence();
-  cpp14_features::demo_decltype_auto();
+  cpp_features::run_demo("demo_return_type_deduction", cpp14_features::demo_return_type_deduction);
+  cpp_features::run_demo("demo_generic_lambdas", cpp14_features::demo_generic_lambdas);
+  cpp_features::run_demo("demo_variable_templates", cpp14_features::demo_variable_templates);
+  cpp_features::run_demo("demo_binary_literals", cpp14_features::demo_binary_literals);
+  cpp_features::run_demo("demo_improved_constexpr", cpp14_features::demo_improved_constexpr);
+  cpp_features::run_demo("demo_make_unique", cpp14_features::demo_make_unique);
+  cpp_features::run_demo("demo_integer_sequence", cpp14_features::demo_integer_sequence);
+  cpp_features::run_demo("demo_decltype_auto", cpp14_features::demo_decltype_auto);
 
   std::cout << "\nC++14 features demonstration completed!\n";
   return 0;
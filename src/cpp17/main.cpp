@@ -14,6 +14,7 @@
 #include <variant>
 #include <vector>
 
+#include "../include/alloc_tracker.h"
 #include "../include/utils.h"
 
 namespace cpp17_features {
@@ -195,6 +196,32 @@ void demo_string_view() {
   std::string long_text = "This is a very long string that we want to process efficiently";
   std::string_view middle_part = std::string_view(long_text).substr(10, 20);
   std::cout << "  Middle part: '" << middle_part << "'\n";
+
+  // Same first-word extraction through std::string copies and through views;
+  // with --alloc_tracking=y each scope reports its allocations
+  const char* inputs[] = {"Hello World from C++17 and its string_view type",
+                          "String view is efficient for read-only text",
+                          "C-style string works too without any copies"};
+  size_t copy_total = 0;
+  {
+    cpp_features::AllocScope scope("string copies");
+    for (int i = 0; i < 1000; ++i) {
+      for (const char* input : inputs) {
+        std::string text_copy = input;
+        copy_total += text_copy.substr(0, text_copy.find(' ')).size();
+      }
+    }
+  }
+  size_t view_total = 0;
+  {
+    cpp_features::AllocScope scope("string_view");
+    for (int i = 0; i < 1000; ++i) {
+      for (std::string_view input : inputs) {
+        view_total += input.substr(0, input.find(' ')).size();
+      }
+    }
+  }
+  cpp_features::Demo::print_value("Same result", copy_total == view_total);
 }
 
 // C++17: std::any
@@ -337,16 +364,17 @@ void demo_nested_namespaces() {
 int main() {
   cpp_features::Demo::print_header("C++17 Features Showcase");
 
-  cpp17_features::demo_structured_bindings();
-  cpp17_features::demo_if_constexpr();
-  cpp17_features::demo_optional();
-  cpp17_features::demo_variant();
-  cpp17_features::demo_string_view();
-  cpp17_features::demo_any();
-  cpp17_features::demo_fold_expressions();
-  cpp17_features::demo_class_template_deduction();
-  cpp17_features::demo_parallel_algorithms();
-  cpp17_features::demo_nested_namespaces();
+  cpp_features::run_demo("demo_structured_bindings", cpp17_features::demo_structured_bindings);
+  cpp_features::run_demo("demo_if_constexpr", cpp17_features::demo_if_constexpr);
+  cpp_features::run_demo("demo_optional", cpp17_features::demo_optional);
+  cpp_features::run_demo("demo_variant", cpp17_features::demo_variant);
+  cpp_features::run_demo("demo_string_view", cpp17_features::demo_string_view);
+  cpp_features::run_demo("demo_any", cpp17_features::demo_any);
+  cpp_features::run_demo("demo_fold_expressions", cpp17_features::demo_fold_expressions);
+  cpp_features::run_demo("demo_class_template_deduction",
+                         cpp17_features::demo_class_template_deduction);
+  cpp_features::run_demo("demo_parallel_algorithms", cpp17_features::demo_parallel_algorithms);
+  cpp_features::run_demo("demo_nested_namespaces", cpp17_features::demo_nested_namespaces);
 
   std::cout << "\nC++17 features demonstration completed!\n";
   return 0;
@@ -0,0 +1,263 @@
+#ifndef CPP20_FEATURES_BITMAP_H
+#define CPP20_FEATURES_BITMAP_H
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+// Bit-manipulation kernels built on the C++20 <bit> primitives.
+// AVX2 popcount and BMI2 PEXT/PDEP are used when the compiler targets them
+// (xmake f --simd=y), otherwise portable fallbacks are compiled in.
+namespace cpp20_features::bits {
+
+// PEXT: gather the bits of x selected by mask into the low bits of the result
+inline uint64_t pext(uint64_t x, uint64_t mask) {
+#if defined(__BMI2__)
+  return _pext_u64(x, mask);
+#else
+  uint64_t result = 0;
+  for (uint64_t bit = 1; mask != 0; bit <<= 1) {
+    if ((x >> std::countr_zero(mask)) & 1) result |= bit;
+    mask &= mask - 1;  // clear lowest set bit
+  }
+  return result;
+#endif
+}
+
+// PDEP: scatter the low bits of x into the positions selected by mask
+inline uint64_t pdep(uint64_t x, uint64_t mask) {
+#if defined(__BMI2__)
+  return _pdep_u64(x, mask);
+#else
+  uint64_t result = 0;
+  for (uint64_t bit = 1; mask != 0; bit <<= 1) {
+    if (x & bit) result |= uint64_t{1} << std::countr_zero(mask);
+    mask &= mask - 1;
+  }
+  return result;
+#endif
+}
+
+// Position of the k-th (0-based) set bit of word; 64 if word has <= k set bits
+inline unsigned select_in_word(uint64_t word, unsigned k) {
+#if defined(__BMI2__)
+  return static_cast<unsigned>(std::countr_zero(_pdep_u64(uint64_t{1} << k, word)));
+#else
+  for (unsigned i = 0; i < k && word != 0; ++i) word &= word - 1;
+  return static_cast<unsigned>(std::countr_zero(word));
+#endif
+}
+
+#if defined(__AVX2__)
+// Mula's nibble-lookup popcount: 4-bit LUT via pshufb, horizontal sum via psadbw
+inline __m256i popcount_epi64(__m256i v) {
+  const __m256i lookup =
+      _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,  // low lane
+                       0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+  const __m256i low_mask = _mm256_set1_epi8(0x0f);
+  __m256i lo = _mm256_and_si256(v, low_mask);
+  __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+  __m256i counts =
+      _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo), _mm256_shuffle_epi8(lookup, hi));
+  return _mm256_sad_epu8(counts, _mm256_setzero_si256());
+}
+
+inline uint64_t horizontal_sum(__m256i acc) {
+  return static_cast<uint64_t>(_mm256_extract_epi64(acc, 0)) +
+         static_cast<uint64_t>(_mm256_extract_epi64(acc, 1)) +
+         static_cast<uint64_t>(_mm256_extract_epi64(acc, 2)) +
+         static_cast<uint64_t>(_mm256_extract_epi64(acc, 3));
+}
+#endif
+
+// Population count over a word buffer
+inline uint64_t popcount(std::span<const uint64_t> words) {
+  uint64_t total = 0;
+  size_t i = 0;
+#if defined(__AVX2__)
+  __m256i acc = _mm256_setzero_si256();
+  for (; i + 4 <= words.size(); i += 4) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words.data() + i));
+    acc = _mm256_add_epi64(acc, popcount_epi64(v));
+  }
+  total = horizontal_sum(acc);
+#endif
+  for (; i < words.size(); ++i) total += std::popcount(words[i]);
+  return total;
+}
+
+// Population count of (a & b) without materialising the intersection
+inline uint64_t popcount_and(std::span<const uint64_t> a, std::span<const uint64_t> b) {
+  const size_t n = std::min(a.size(), b.size());
+  uint64_t total = 0;
+  size_t i = 0;
+#if defined(__AVX2__)
+  __m256i acc = _mm256_setzero_si256();
+  for (; i + 4 <= n; i += 4) {
+    __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a.data() + i));
+    __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b.data() + i));
+    acc = _mm256_add_epi64(acc, popcount_epi64(_mm256_and_si256(va, vb)));
+  }
+  total = horizontal_sum(acc);
+#endif
+  for (; i < n; ++i) total += std::popcount(a[i] & b[i]);
+  return total;
+}
+
+// Word-packed bitmap with bulk set operations and set-bit iteration
+class Bitmap {
+ public:
+  static constexpr size_t kWordBits = 64;
+
+  Bitmap() = default;
+  explicit Bitmap(size_t bit_count)
+      : words_((bit_count + kWordBits - 1) / kWordBits, 0), bit_count_(bit_count) {}
+
+  size_t size() const { return bit_count_; }
+  std::span<const uint64_t> words() const { return words_; }
+  std::span<uint64_t> words() { return words_; }
+
+  bool test(size_t pos) const { return (words_[pos / kWordBits] >> (pos % kWordBits)) & 1; }
+  void set(size_t pos) { words_[pos / kWordBits] |= uint64_t{1} << (pos % kWordBits); }
+  void reset(size_t pos) { words_[pos / kWordBits] &= ~(uint64_t{1} << (pos % kWordBits)); }
+
+  size_t count() const { return popcount(words_); }
+  size_t count_and(const Bitmap& other) const { return popcount_and(words_, other.words_); }
+
+  // Operands may differ in length: other is treated as zero past its end, and
+  // bits of other beyond size() are ignored
+  Bitmap& operator&=(const Bitmap& other) {
+    apply(other, [](uint64_t a, uint64_t b) { return a & b; });
+    if (other.words_.size() < words_.size()) {
+      std::fill(words_.begin() + static_cast<std::ptrdiff_t>(other.words_.size()), words_.end(),
+                uint64_t{0});
+    }
+    return *this;
+  }
+  Bitmap& operator|=(const Bitmap& other) {
+    return apply(other, [](uint64_t a, uint64_t b) { return a | b; });
+  }
+  Bitmap& operator^=(const Bitmap& other) {
+    return apply(other, [](uint64_t a, uint64_t b) { return a ^ b; });
+  }
+  Bitmap& and_not(const Bitmap& other) {
+    return apply(other, [](uint64_t a, uint64_t b) { return a & ~b; });
+  }
+
+  // Calls f(pos) for every set bit in ascending order, skipping whole zero words
+  template <typename F>
+  void for_each_set(F&& f) const {
+    for (size_t w = 0; w < words_.size(); ++w) {
+      uint64_t word = words_[w];
+      while (word != 0) {
+        f(w * kWordBits + static_cast<size_t>(std::countr_zero(word)));
+        word &= word - 1;  // clear lowest set bit
+      }
+    }
+  }
+
+ private:
+  std::vector<uint64_t> words_;
+  size_t bit_count_ = 0;
+
+  // Plain word loops over the common prefix; the compiler vectorises these
+  // under -O2/-O3. Words of *this past other's end are left to the caller.
+  // A longer other can carry bits past size() into our last word; those are
+  // cleared so count() and RankSelect never see them
+  template <typename Op>
+  Bitmap& apply(const Bitmap& other, Op op) {
+    const size_t n = std::min(words_.size(), other.words_.size());
+    uint64_t* dst = words_.data();
+    const uint64_t* src = other.words_.data();
+    for (size_t i = 0; i < n; ++i) dst[i] = op(dst[i], src[i]);
+    if (n == words_.size() && bit_count_ % kWordBits != 0) {
+      words_.back() &= (uint64_t{1} << (bit_count_ % kWordBits)) - 1;
+    }
+    return *this;
+  }
+};
+
+// Immutable rank/select index over a Bitmap.
+// Rank: cumulative popcount sampled every kBlockWords words (512 bits), so a
+// query costs one table lookup plus at most 7 popcounts.
+// Select: every kSelectSample-th set bit records its block, narrowing the
+// block search before the final in-word select (PDEP when BMI2 is enabled).
+class RankSelect {
+ public:
+  static constexpr size_t kBlockWords = 8;
+  static constexpr size_t kSelectSample = 4096;
+
+  explicit RankSelect(const Bitmap& bitmap) : words_(bitmap.words()), bit_count_(bitmap.size()) {
+    const size_t block_count = (words_.size() + kBlockWords - 1) / kBlockWords;
+    block_rank_.reserve(block_count + 1);
+
+    uint64_t running = 0;
+    for (size_t b = 0; b < block_count; ++b) {
+      block_rank_.push_back(running);
+      const size_t first = b * kBlockWords;
+      const size_t last = std::min(first + kBlockWords, words_.size());
+      uint64_t block_ones = 0;
+      for (size_t w = first; w < last; ++w) block_ones += std::popcount(words_[w]);
+
+      // Record the block for every sampled one that falls inside it
+      while (select_samples_.size() * kSelectSample < running + block_ones) {
+        select_samples_.push_back(static_cast<uint32_t>(b));
+      }
+      running += block_ones;
+    }
+    block_rank_.push_back(running);
+  }
+
+  size_t ones() const { return block_rank_.back(); }
+
+  // Number of set bits in [0, pos)
+  size_t rank1(size_t pos) const {
+    const size_t word = pos / Bitmap::kWordBits;
+    const size_t block = word / kBlockWords;
+    uint64_t result = block_rank_[block];
+    for (size_t w = block * kBlockWords; w < word; ++w) result += std::popcount(words_[w]);
+    const unsigned offset = pos % Bitmap::kWordBits;
+    if (offset != 0) result += std::popcount(words_[word] & ((uint64_t{1} << offset) - 1));
+    return result;
+  }
+
+  // Position of the k-th (0-based) set bit, or size() if k >= ones()
+  size_t select1(size_t k) const {
+    if (k >= ones()) return bit_count_;
+
+    // Start from the sampled block and gallop to the block that holds bit k
+    size_t block = select_samples_[k / kSelectSample];
+    while (block_rank_[block + 1] <= k) ++block;
+
+    uint64_t remaining = k - block_rank_[block];
+    for (size_t w = block * kBlockWords;; ++w) {
+      const auto ones_in_word = static_cast<uint64_t>(std::popcount(words_[w]));
+      if (remaining < ones_in_word) {
+        return w * Bitmap::kWordBits +
+               select_in_word(words_[w], static_cast<unsigned>(remaining));
+      }
+      remaining -= ones_in_word;
+    }
+  }
+
+  size_t memory_bytes() const {
+    return block_rank_.size() * sizeof(uint64_t) + select_samples_.size() * sizeof(uint32_t);
+  }
+
+ private:
+  std::span<const uint64_t> words_;
+  size_t bit_count_;
+  std::vector<uint64_t> block_rank_;
+  std::vector<uint32_t> select_samples_;
+};
+
+}  // namespace cpp20_features::bits
+
+#endif  // CPP20_FEATURES_BITMAP_H
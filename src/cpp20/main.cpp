@@ -1,20 +1,28 @@
 #include <algorithm>
 #include <array>
 #include <bit>
+#include <bitset>
 #include <compare>
 #include <concepts>
 #include <coroutine>
+#include <cstdlib>
 #include <format>
 #include <iostream>
+#include <memory>
 #include <numbers>
 #include <numeric>
 #include <ranges>
+#include <set>
 #include <span>
+#include <sstream>
 #include <string>
 #include <type_traits>
 #include <vector>
 
+#include "../include/alloc_tracker.h"
 #include "../include/utils.h"
+#include "bitmap.h"
+#include "roaring.h"
 
 namespace cpp20_features {
 
@@ -196,6 +204,31 @@ void demo_format() {
   // Number formatting
   auto hex_num = std::format("Hex: {:#x}, Binary: {:#b}, Decimal: {}", 255, 255, 255);
   std::cout << "  " << hex_num << "\n";
+
+  // Hot-path cost: std::format returns a new string, std::format_to_n writes
+  // into a caller buffer (see tests/fmtlib for the fmt equivalents)
+  const size_t iterations = 1000000;
+  auto bench = [&](const char* label, auto format_once) {
+    size_t checksum = 0;
+    cpp_features::AllocScope scope;
+    for (size_t i = 0; i < iterations; ++i) checksum += format_once(i);
+    double ns_per_op = scope.elapsed_ms() * 1e6 / static_cast<double>(iterations);
+    std::cout << "  " << std::format("{:<26} {:>7.1f} ns/op", label, ns_per_op);
+    if (cpp_features::alloc_tracking::enabled()) {
+      std::cout << std::format(", {:.2f} allocs/op",
+                               static_cast<double>(scope.stats().allocations) / iterations);
+    }
+    std::cout << std::format("  (checksum {})\n", checksum);
+  };
+  bench("std::format", [&](size_t i) {
+    return std::format("Name: {}, Value: {}, Ratio: {:.3f}", name, i, 0.8125).size();
+  });
+  bench("std::format_to_n(char[64])", [&](size_t i) {
+    char out[64];
+    auto result =
+        std::format_to_n(out, sizeof(out), "Name: {}, Value: {}, Ratio: {:.3f}", name, i, 0.8125);
+    return static_cast<size_t>(result.out - out);
+  });
 #else
   std::cout << "  std::format not available in this build\n";
   std::cout << "  Using traditional formatting:\n";
@@ -253,6 +286,464 @@ void demo_bit_operations() {
   }
 }
 
+// Bitmap engine built on the <bit> primitives above
+constexpr size_t kBitsetBits = size_t{1} << 26;  // std::bitset needs a compile-time size
+
+// Bits per benchmark; set CPP20_BITMAP_BITS=1000000000 for the full-size run
+size_t bitmap_bench_bits() {
+  if (const char* env = std::getenv("CPP20_BITMAP_BITS")) {
+    return std::max<size_t>(std::strtoull(env, nullptr, 10), 64);
+  }
+  return kBitsetBits;
+}
+
+uint64_t splitmix64(uint64_t& state) {
+  uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+std::string throughput(double ms, size_t bit_count) {
+  std::ostringstream out;
+  out << std::fixed << std::setprecision(2) << ms << " ms ("
+      << (ms > 0 ? bit_count / (ms * 1e6) : 0.0) << " Gbit/s)";
+  return out.str();
+}
+
+void demo_bitmap_kernels() {
+  cpp_features::Demo::print_section("Bitmap Kernels (rank/select, SIMD popcount, PEXT/PDEP)");
+
+  namespace bits = cpp20_features::bits;
+
+#if defined(__AVX2__)
+  std::cout << "  Popcount path: AVX2\n";
+#else
+  std::cout << "  Popcount path: scalar std::popcount\n";
+#endif
+#if defined(__BMI2__)
+  std::cout << "  PEXT/PDEP path: BMI2\n";
+#else
+  std::cout << "  PEXT/PDEP path: portable fallback\n";
+#endif
+
+  uint64_t value = 0b11010110;
+  cpp_features::Demo::print_value("pext(value, 0xF0)", bits::pext(value, 0xF0));
+  cpp_features::Demo::print_value("pdep(0b101, 0xF0)", bits::pdep(0b101, 0xF0));
+  cpp_features::Demo::print_value("select(value, 2)", bits::select_in_word(value, 2));
+
+  const size_t bit_count = bitmap_bench_bits();
+  cpp_features::Demo::print_value("Benchmark bits", bit_count);
+
+  // Two random bitmaps with ~50% density, mirrored into std::vector<bool>
+  bits::Bitmap a(bit_count);
+  bits::Bitmap b(bit_count);
+  uint64_t seed = 42;
+  for (auto& word : a.words()) word = splitmix64(seed);
+  for (auto& word : b.words()) word = splitmix64(seed);
+  if (bit_count % 64 != 0) {
+    const uint64_t tail_mask = (uint64_t{1} << (bit_count % 64)) - 1;
+    a.words().back() &= tail_mask;
+    b.words().back() &= tail_mask;
+  }
+
+  std::vector<bool> va(bit_count);
+  std::vector<bool> vb(bit_count);
+  for (size_t i = 0; i < bit_count; ++i) {
+    va[i] = a.test(i);
+    vb[i] = b.test(i);
+  }
+
+  auto sa = std::make_unique<std::bitset<kBitsetBits>>();
+  auto sb = std::make_unique<std::bitset<kBitsetBits>>();
+  for (size_t i = 0; i < std::min(bit_count, kBitsetBits); ++i) {
+    (*sa)[i] = a.test(i);
+    (*sb)[i] = b.test(i);
+  }
+
+  // Population count
+  {
+    cpp_features::Timer timer;
+    size_t ones = a.count();
+    double bitmap_ms = timer.elapsed_ms();
+
+    cpp_features::Timer vector_timer;
+    size_t vector_ones = std::count(va.begin(), va.end(), true);
+    double vector_ms = vector_timer.elapsed_ms();
+
+    cpp_features::Timer bitset_timer;
+    size_t bitset_ones = sa->count();
+    double bitset_ms = bitset_timer.elapsed_ms();
+
+    cpp_features::Demo::print_value("popcount", ones);
+    cpp_features::Demo::print_result("  Bitmap::count", throughput(bitmap_ms, bit_count));
+    cpp_features::Demo::print_result("  vector<bool> std::count", throughput(vector_ms, bit_count));
+    cpp_features::Demo::print_result("  bitset::count", throughput(bitset_ms, kBitsetBits));
+    cpp_features::Demo::print_value("vector<bool> agrees", vector_ones == ones);
+    cpp_features::Demo::print_value("bitset ones", bitset_ones);
+  }
+
+  // Filtering: count positions matching both predicates
+  {
+    cpp_features::Timer timer;
+    size_t matches = a.count_and(b);
+    double bitmap_ms = timer.elapsed_ms();
+
+    cpp_features::Timer vector_timer;
+    size_t vector_matches = 0;
+    for (size_t i = 0; i < bit_count; ++i) vector_matches += va[i] && vb[i];
+    double vector_ms = vector_timer.elapsed_ms();
+
+    // Heap copy: a kBitsetBits temporary from operator& would not fit on the stack
+    auto filtered = std::make_unique<std::bitset<kBitsetBits>>(*sa);
+    cpp_features::Timer bitset_timer;
+    size_t bitset_matches = (*filtered &= *sb).count();
+    double bitset_ms = bitset_timer.elapsed_ms();
+
+    cpp_features::Demo::print_value("filter a && b", matches);
+    cpp_features::Demo::print_result("  Bitmap::count_and", throughput(bitmap_ms, bit_count));
+    cpp_features::Demo::print_result("  vector<bool> loop", throughput(vector_ms, bit_count));
+    cpp_features::Demo::print_result("  (bitset & bitset).count",
+                                     throughput(bitset_ms, kBitsetBits));
+    cpp_features::Demo::print_value("vector<bool> agrees", vector_matches == matches);
+    cpp_features::Demo::print_value("bitset matches", bitset_matches);
+  }
+
+  // Set operations: in-place union
+  {
+    bits::Bitmap result = a;
+    cpp_features::Timer timer;
+    result |= b;
+    double bitmap_ms = timer.elapsed_ms();
+
+    std::vector<bool> vector_result = va;
+    cpp_features::Timer vector_timer;
+    for (size_t i = 0; i < bit_count; ++i) vector_result[i] = vector_result[i] || vb[i];
+    double vector_ms = vector_timer.elapsed_ms();
+
+    auto bitset_result = std::make_unique<std::bitset<kBitsetBits>>(*sa);
+    cpp_features::Timer bitset_timer;
+    *bitset_result |= *sb;
+    double bitset_ms = bitset_timer.elapsed_ms();
+
+    cpp_features::Demo::print_value("union ones", result.count());
+    cpp_features::Demo::print_result("  Bitmap |=", throughput(bitmap_ms, bit_count));
+    cpp_features::Demo::print_result("  vector<bool> loop", throughput(vector_ms, bit_count));
+    cpp_features::Demo::print_result("  bitset |=", throughput(bitset_ms, kBitsetBits));
+  }
+
+  // Mixed-length operands: the shorter side behaves as if zero-extended
+  {
+    bits::Bitmap wide(200);
+    bits::Bitmap narrow(70);
+    for (size_t i = 0; i < wide.size(); i += 3) wide.set(i);
+    for (size_t i = 0; i < narrow.size(); i += 2) narrow.set(i);
+
+    bits::Bitmap anded = wide;
+    anded &= narrow;
+    bits::Bitmap ored = wide;
+    ored |= narrow;
+    bits::Bitmap xored = wide;
+    xored ^= narrow;
+    bits::Bitmap diff = wide;
+    diff.and_not(narrow);
+
+    bool mixed_ok = true;
+    for (size_t i = 0; i < wide.size() && mixed_ok; ++i) {
+      const bool n = i < narrow.size() && narrow.test(i);
+      mixed_ok = anded.test(i) == (wide.test(i) && n) && ored.test(i) == (wide.test(i) || n) &&
+                 xored.test(i) == (wide.test(i) != n) && diff.test(i) == (wide.test(i) && !n);
+    }
+
+    // Narrow op wide: bits of wide past narrow.size() must not leak into narrow
+    bits::Bitmap narrow_ored = narrow;
+    narrow_ored |= wide;
+    bits::Bitmap narrow_xored = narrow;
+    narrow_xored ^= wide;
+    size_t expected_or = 0, expected_xor = 0;
+    for (size_t i = 0; i < narrow.size() && mixed_ok; ++i) {
+      const bool w = wide.test(i);
+      expected_or += narrow.test(i) || w;
+      expected_xor += narrow.test(i) != w;
+      mixed_ok = narrow_ored.test(i) == (narrow.test(i) || w) &&
+                 narrow_xored.test(i) == (narrow.test(i) != w);
+    }
+    mixed_ok = mixed_ok && narrow_ored.count() == expected_or &&
+               narrow_xored.count() == expected_xor &&
+               bits::RankSelect(narrow_ored).select1(expected_or - 1) < narrow.size();
+    cpp_features::Demo::print_value("mixed-length set ops", mixed_ok);
+  }
+
+  // Set-bit iteration
+  {
+    cpp_features::Timer timer;
+    uint64_t position_sum = 0;
+    a.for_each_set([&](size_t pos) { position_sum += pos; });
+    double bitmap_ms = timer.elapsed_ms();
+
+    cpp_features::Timer vector_timer;
+    uint64_t vector_sum = 0;
+    for (size_t i = 0; i < bit_count; ++i) {
+      if (va[i]) vector_sum += i;
+    }
+    double vector_ms = vector_timer.elapsed_ms();
+
+    cpp_features::Demo::print_result("  Bitmap::for_each_set", throughput(bitmap_ms, bit_count));
+    cpp_features::Demo::print_result("  vector<bool> scan", throughput(vector_ms, bit_count));
+    cpp_features::Demo::print_value("iteration agrees", position_sum == vector_sum);
+  }
+
+  // Rank/select with the sampled index
+  {
+    cpp_features::Timer build_timer;
+    bits::RankSelect index(a);
+    double build_ms = build_timer.elapsed_ms();
+
+    constexpr size_t kQueries = 1'000'000;
+    uint64_t query_seed = 7;
+    uint64_t checksum = 0;
+    cpp_features::Timer rank_timer;
+    for (size_t q = 0; q < kQueries; ++q) {
+      checksum += index.rank1(splitmix64(query_seed) % bit_count);
+    }
+    double rank_ms = rank_timer.elapsed_ms();
+
+    cpp_features::Timer select_timer;
+    for (size_t q = 0; q < kQueries; ++q) {
+      checksum += index.select1(splitmix64(query_seed) % index.ones());
+    }
+    double select_ms = select_timer.elapsed_ms();
+
+    // select1 and rank1 must be inverses on set bits
+    size_t probe = index.select1(index.ones() / 2);
+    bool consistent = a.test(probe) && index.rank1(probe) == index.ones() / 2;
+
+    cpp_features::Demo::print_value("Index build (ms)", build_ms);
+    cpp_features::Demo::print_value("Index overhead (KB)", index.memory_bytes() / 1024);
+    cpp_features::Demo::print_value("rank1 (ns/query)", rank_ms * 1e6 / kQueries);
+    cpp_features::Demo::print_value("select1 (ns/query)", select_ms * 1e6 / kQueries);
+    cpp_features::Demo::print_value("rank/select agree", consistent);
+    cpp_features::Demo::print_value("checksum", checksum);
+  }
+}
+
+// Roaring bitmap vs std::set and sorted vectors (the flat_set fallback)
+size_t roaring_bench_ids() {
+  if (const char* env = std::getenv("CPP20_ROARING_IDS")) {
+    return std::max<size_t>(std::strtoull(env, nullptr, 10), 1);
+  }
+  return 2'000'000;
+}
+
+void demo_roaring_bitmap() {
+  cpp_features::Demo::print_section("Roaring Bitmap (array/bitmap/run containers)");
+
+  namespace roaring = cpp20_features::roaring;
+
+  // Two ID sets: a scattered one (1 in 8 of the ID space) and a clustered one
+  // made of ID ranges, which is where run containers pay off
+  const size_t id_count = roaring_bench_ids();
+  const auto universe = static_cast<uint32_t>(std::min<uint64_t>(id_count * 8, UINT32_MAX));
+  uint64_t seed = 2024;
+
+  std::vector<uint32_t> scattered;
+  scattered.reserve(id_count);
+  for (size_t i = 0; i < id_count; ++i) {
+    scattered.push_back(static_cast<uint32_t>(splitmix64(seed) % universe));
+  }
+  std::sort(scattered.begin(), scattered.end());
+  scattered.erase(std::unique(scattered.begin(), scattered.end()), scattered.end());
+
+  std::vector<uint32_t> clustered;
+  clustered.reserve(id_count);
+  while (clustered.size() < id_count) {
+    const auto start = static_cast<uint32_t>(splitmix64(seed) % universe);
+    const uint32_t length = 100 + static_cast<uint32_t>(splitmix64(seed) % 2000);
+    for (uint32_t v = start; v < start + length && v < universe; ++v) clustered.push_back(v);
+  }
+  std::sort(clustered.begin(), clustered.end());
+  clustered.erase(std::unique(clustered.begin(), clustered.end()), clustered.end());
+
+  cpp_features::Demo::print_value("Scattered IDs", scattered.size());
+  cpp_features::Demo::print_value("Clustered IDs", clustered.size());
+
+  // Build
+  cpp_features::Timer set_timer;
+  std::set<uint32_t> set_a(scattered.begin(), scattered.end());
+  std::set<uint32_t> set_b(clustered.begin(), clustered.end());
+  double set_build_ms = set_timer.elapsed_ms();
+
+  cpp_features::Timer roaring_timer;
+  auto roaring_a = roaring::RoaringBitmap::from_sorted(scattered);
+  auto roaring_b = roaring::RoaringBitmap::from_sorted(clustered);
+  roaring_a.run_optimize();
+  roaring_b.run_optimize();
+  double roaring_build_ms = roaring_timer.elapsed_ms();
+
+  cpp_features::Demo::print_value("std::set build (ms)", set_build_ms);
+  cpp_features::Demo::print_value("Roaring build (ms)", roaring_build_ms);
+
+  // Memory: std::set nodes carry three pointers and a color word besides the key
+  const size_t set_node_bytes = sizeof(uint32_t) + 3 * sizeof(void*) + sizeof(int);
+  const size_t total_ids = scattered.size() + clustered.size();
+  const auto stats_a = roaring_a.container_stats();
+  const auto stats_b = roaring_b.container_stats();
+  cpp_features::Demo::print_value("std::set (KB, est.)", total_ids * set_node_bytes / 1024);
+  cpp_features::Demo::print_value("sorted vector (KB)", total_ids * sizeof(uint32_t) / 1024);
+  cpp_features::Demo::print_value("Roaring (KB)",
+                                  (roaring_a.memory_bytes() + roaring_b.memory_bytes()) / 1024);
+  std::cout << "  Containers (array/bitmap/run): scattered " << stats_a[0] << "/" << stats_a[1]
+            << "/" << stats_a[2] << ", clustered " << stats_b[0] << "/" << stats_b[1] << "/"
+            << stats_b[2] << "\n";
+
+  // Membership probes
+  constexpr size_t kProbes = 1'000'000;
+  std::vector<uint32_t> probes(kProbes);
+  for (auto& p : probes) p = static_cast<uint32_t>(splitmix64(seed) % universe);
+
+  size_t set_hits = 0;
+  cpp_features::Timer set_probe_timer;
+  for (uint32_t p : probes) set_hits += set_a.count(p);
+  double set_probe_ms = set_probe_timer.elapsed_ms();
+
+  size_t vector_hits = 0;
+  cpp_features::Timer vector_probe_timer;
+  for (uint32_t p : probes) {
+    vector_hits += std::binary_search(scattered.begin(), scattered.end(), p);
+  }
+  double vector_probe_ms = vector_probe_timer.elapsed_ms();
+
+  size_t roaring_hits = 0;
+  cpp_features::Timer roaring_probe_timer;
+  for (uint32_t p : probes) roaring_hits += roaring_a.contains(p);
+  double roaring_probe_ms = roaring_probe_timer.elapsed_ms();
+
+  cpp_features::Demo::print_value("set contains (ns)", set_probe_ms * 1e6 / kProbes);
+  cpp_features::Demo::print_value("vector contains (ns)", vector_probe_ms * 1e6 / kProbes);
+  cpp_features::Demo::print_value("Roaring contains (ns)", roaring_probe_ms * 1e6 / kProbes);
+  cpp_features::Demo::print_value("Hits agree",
+                                  set_hits == roaring_hits && vector_hits == roaring_hits);
+
+  // Set algebra: sorted-vector merges vs container-wise Roaring operations
+  auto run_vector_op = [&](auto algorithm) {
+    std::vector<uint32_t> out;
+    algorithm(scattered.begin(), scattered.end(), clustered.begin(), clustered.end(),
+              std::back_inserter(out));
+    return out.size();
+  };
+  auto run_set_op = [&](auto algorithm) {
+    std::vector<uint32_t> out;
+    algorithm(set_a.begin(), set_a.end(), set_b.begin(), set_b.end(), std::back_inserter(out));
+    return out.size();
+  };
+
+  struct OpResult {
+    const char* name;
+    size_t set_size;
+    size_t vector_size;
+    uint64_t roaring_size;
+    double set_ms;
+    double vector_ms;
+    double roaring_ms;
+  };
+  std::vector<OpResult> results;
+
+  auto measure = [&](const char* name, auto algorithm, auto roaring_op) {
+    OpResult r{name, 0, 0, 0, 0, 0, 0};
+    cpp_features::Timer t1;
+    r.set_size = run_set_op(algorithm);
+    r.set_ms = t1.elapsed_ms();
+    cpp_features::Timer t2;
+    r.vector_size = run_vector_op(algorithm);
+    r.vector_ms = t2.elapsed_ms();
+    cpp_features::Timer t3;
+    r.roaring_size = roaring_op().cardinality();
+    r.roaring_ms = t3.elapsed_ms();
+    results.push_back(r);
+  };
+
+  using Out = std::back_insert_iterator<std::vector<uint32_t>>;
+  auto intersection = [](auto first1, auto last1, auto first2, auto last2, Out out) {
+    return std::set_intersection(first1, last1, first2, last2, out);
+  };
+  auto set_union = [](auto first1, auto last1, auto first2, auto last2, Out out) {
+    return std::set_union(first1, last1, first2, last2, out);
+  };
+  auto symmetric = [](auto first1, auto last1, auto first2, auto last2, Out out) {
+    return std::set_symmetric_difference(first1, last1, first2, last2, out);
+  };
+  auto difference = [](auto first1, auto last1, auto first2, auto last2, Out out) {
+    return std::set_difference(first1, last1, first2, last2, out);
+  };
+
+  measure("AND", intersection, [&] { return roaring_a & roaring_b; });
+  measure("OR", set_union, [&] { return roaring_a | roaring_b; });
+  measure("XOR", symmetric, [&] { return roaring_a ^ roaring_b; });
+  measure("ANDNOT", difference, [&] { return and_not(roaring_a, roaring_b); });
+
+  std::cout << "  " << std::left << std::setw(8) << "op" << std::setw(12) << "set ms"
+            << std::setw(12) << "vector ms" << std::setw(12) << "roaring ms" << "agree\n";
+  for (const auto& r : results) {
+    std::cout << "  " << std::left << std::setw(8) << r.name << std::setw(12) << r.set_ms
+              << std::setw(12) << r.vector_ms << std::setw(12) << r.roaring_ms
+              << (r.set_size == r.roaring_size && r.vector_size == r.roaring_size) << "\n";
+  }
+
+  // Serialisation round trip
+  cpp_features::Timer serialize_timer;
+  std::vector<uint8_t> bytes = roaring_b.serialize();
+  auto restored = roaring::RoaringBitmap::deserialize(bytes);
+  double serialize_ms = serialize_timer.elapsed_ms();
+
+  cpp_features::Demo::print_value("Serialized (KB)", bytes.size() / 1024);
+  cpp_features::Demo::print_value("Round trip (ms)", serialize_ms);
+  cpp_features::Demo::print_value("Round trip intact",
+                                  restored && (*restored ^ roaring_b).cardinality() == 0 &&
+                                      restored->cardinality() == clustered.size());
+
+  // Corrupt inputs must be rejected, not turned into a broken bitmap
+  auto encode = [](std::initializer_list<std::pair<uint64_t, int>> fields) {
+    std::vector<uint8_t> out = {'R', 'B', 'M', '1'};
+    for (auto [value, width] : fields) {
+      for (int i = 0; i < width; ++i) out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+    return out;
+  };
+  const std::vector<uint8_t> corrupt[] = {
+      // 12 bytes claiming 4G containers
+      encode({{0xffffffff, 4}, {0, 4}}),
+      // Array container claiming 1G values
+      encode({{1, 4}, {0, 2}, {0, 1}, {1, 4}, {0x40000000, 4}, {7, 2}}),
+      // Run container with an odd value count
+      encode({{1, 4}, {0, 2}, {2, 1}, {1, 4}, {1, 4}, {5, 2}}),
+      // Run reaching past 65535
+      encode({{1, 4}, {0, 2}, {2, 1}, {2, 4}, {2, 4}, {0xffff, 2}, {1, 2}}),
+      // Duplicate keys
+      encode({{2, 4}, {3, 2}, {0, 1}, {1, 4}, {1, 4}, {1, 2}, {3, 2}, {0, 1}, {1, 4}, {1, 4},
+              {2, 2}}),
+      // Array container with 4097 values
+      [&] {
+        std::vector<uint8_t> out = encode({{1, 4}, {0, 2}, {0, 1}, {4097, 4}, {4097, 4}});
+        for (uint32_t v = 0; v < 4097; ++v) {
+          out.push_back(static_cast<uint8_t>(v));
+          out.push_back(static_cast<uint8_t>(v >> 8));
+        }
+        return out;
+      }(),
+  };
+  size_t rejected = 0;
+  for (const auto& input : corrupt) {
+    const char* reason = nullptr;
+    if (!roaring::RoaringBitmap::deserialize(input, &reason)) {
+      ++rejected;
+      std::cout << "  rejected: " << reason << "\n";
+    }
+  }
+  cpp_features::Demo::print_value(
+      "Corrupt inputs rejected",
+      std::to_string(rejected) + "/" + std::to_string(std::size(corrupt)));
+}
+
 // C++20: Designated initializers
 struct Config {
   std::string name;
@@ -417,17 +908,20 @@ void demo_coroutines() {
 int main() {
   cpp_features::Demo::print_header("C++20 Features Showcase");
 
-  cpp20_features::demo_concepts();
-  cpp20_features::demo_ranges();
-  cpp20_features::demo_span();
-  cpp20_features::demo_three_way_comparison();
-  cpp20_features::demo_format();
-  cpp20_features::demo_math_constants();
-  cpp20_features::demo_bit_operations();
-  cpp20_features::demo_designated_initializers();
-  cpp20_features::demo_template_lambdas();
-  cpp20_features::demo_consteval();
-  cpp20_features::demo_coroutines();
+  cpp_features::run_demo("demo_concepts", cpp20_features::demo_concepts);
+  cpp_features::run_demo("demo_ranges", cpp20_features::demo_ranges);
+  cpp_features::run_demo("demo_span", cpp20_features::demo_span);
+  cpp_features::run_demo("demo_three_way_comparison", cpp20_features::demo_three_way_comparison);
+  cpp_features::run_demo("demo_format", cpp20_features::demo_format);
+  cpp_features::run_demo("demo_math_constants", cpp20_features::demo_math_constants);
+  cpp_features::run_demo("demo_bit_operations", cpp20_features::demo_bit_operations);
+  cpp_features::run_demo("demo_bitmap_kernels", cpp20_features::demo_bitmap_kernels);
+  cpp_features::run_demo("demo_roaring_bitmap", cpp20_features::demo_roaring_bitmap);
+  cpp_features::run_demo("demo_designated_initializers",
+                         cpp20_features::demo_designated_initializers);
+  cpp_features::run_demo("demo_template_lambdas", cpp20_features::demo_template_lambdas);
+  cpp_features::run_demo("demo_consteval", cpp20_features::demo_consteval);
+  cpp_features::run_demo("demo_coroutines", cpp20_features::demo_coroutines);
 
   std::cout << "\nC++20 features demonstration completed!\n";
   return 0;
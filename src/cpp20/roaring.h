@@ -0,0 +1,498 @@
+#ifndef CPP20_FEATURES_ROARING_H
+#define CPP20_FEATURES_ROARING_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "bitmap.h"
+
+// Roaring-style compressed bitmap for 32-bit IDs.
+// IDs are split into a 16-bit key (high half) and a 16-bit value (low half).
+// Each key owns one container, chosen by density:
+//   Array  - sorted uint16_t values, up to kArrayMaxCardinality entries
+//   Bitmap - 1024 x 64-bit words (8 KB), for dense chunks
+//   Run    - (start, length - 1) pairs, produced by run_optimize()
+namespace cpp20_features::roaring {
+
+constexpr uint32_t kArrayMaxCardinality = 4096;
+constexpr size_t kBitmapWords = 1024;
+
+struct Container {
+  enum class Kind : uint8_t { Array, Bitmap, Run };
+
+  Kind kind = Kind::Array;
+  uint32_t cardinality = 0;
+  std::vector<uint16_t> values;  // Array: sorted values; Run: (start, length - 1) pairs
+  std::vector<uint64_t> words;   // Bitmap: kBitmapWords words
+
+  bool contains(uint16_t low) const {
+    switch (kind) {
+      case Kind::Array:
+        return std::binary_search(values.begin(), values.end(), low);
+      case Kind::Bitmap:
+        return (words[low / 64] >> (low % 64)) & 1;
+      case Kind::Run: {
+        // Last run whose start <= low
+        size_t lo = 0;
+        size_t hi = values.size() / 2;
+        while (lo < hi) {
+          size_t mid = (lo + hi) / 2;
+          if (values[2 * mid] <= low) {
+            lo = mid + 1;
+          } else {
+            hi = mid;
+          }
+        }
+        if (lo == 0) return false;
+        const uint32_t start = values[2 * (lo - 1)];
+        return low <= start + values[2 * (lo - 1) + 1];
+      }
+    }
+    return false;
+  }
+
+  // Bitmap view of any container kind
+  std::vector<uint64_t> to_words() const {
+    if (kind == Kind::Bitmap) return words;
+    std::vector<uint64_t> result(kBitmapWords, 0);
+    if (kind == Kind::Array) {
+      for (uint16_t v : values) result[v / 64] |= uint64_t{1} << (v % 64);
+    } else {
+      for (size_t r = 0; r < values.size(); r += 2) {
+        const uint32_t end = uint32_t{values[r]} + values[r + 1];
+        for (uint32_t v = values[r]; v <= end; ++v) result[v / 64] |= uint64_t{1} << (v % 64);
+      }
+    }
+    return result;
+  }
+
+  template <typename F>
+  void for_each(uint32_t high_bits, F&& f) const {
+    switch (kind) {
+      case Kind::Array:
+        for (uint16_t v : values) f(high_bits | v);
+        break;
+      case Kind::Bitmap:
+        for (size_t w = 0; w < kBitmapWords; ++w) {
+          for (uint64_t word = words[w]; word != 0; word &= word - 1) {
+            f(high_bits | static_cast<uint32_t>(w * 64 + std::countr_zero(word)));
+          }
+        }
+        break;
+      case Kind::Run:
+        for (size_t r = 0; r < values.size(); r += 2) {
+          const uint32_t end = uint32_t{values[r]} + values[r + 1];
+          for (uint32_t v = values[r]; v <= end; ++v) f(high_bits | v);
+        }
+        break;
+    }
+  }
+
+  size_t memory_bytes() const {
+    return values.capacity() * sizeof(uint16_t) + words.capacity() * sizeof(uint64_t);
+  }
+
+  static Container from_words(std::vector<uint64_t> bitmap_words) {
+    Container c;
+    c.cardinality = static_cast<uint32_t>(bits::popcount(bitmap_words));
+    if (c.cardinality > kArrayMaxCardinality) {
+      c.kind = Kind::Bitmap;
+      c.words = std::move(bitmap_words);
+      return c;
+    }
+    c.values.reserve(c.cardinality);
+    for (size_t w = 0; w < kBitmapWords; ++w) {
+      for (uint64_t word = bitmap_words[w]; word != 0; word &= word - 1) {
+        c.values.push_back(static_cast<uint16_t>(w * 64 + std::countr_zero(word)));
+      }
+    }
+    return c;
+  }
+
+  static Container from_values(std::vector<uint16_t> sorted_values) {
+    if (sorted_values.size() > kArrayMaxCardinality) {
+      std::vector<uint64_t> bitmap_words(kBitmapWords, 0);
+      for (uint16_t v : sorted_values) bitmap_words[v / 64] |= uint64_t{1} << (v % 64);
+      Container c;
+      c.kind = Kind::Bitmap;
+      c.cardinality = static_cast<uint32_t>(sorted_values.size());
+      c.words = std::move(bitmap_words);
+      return c;
+    }
+    Container c;
+    c.cardinality = static_cast<uint32_t>(sorted_values.size());
+    c.values = std::move(sorted_values);
+    return c;
+  }
+
+  void add(uint16_t low) {
+    switch (kind) {
+      case Kind::Array: {
+        auto it = std::lower_bound(values.begin(), values.end(), low);
+        if (it != values.end() && *it == low) return;
+        values.insert(it, low);
+        ++cardinality;
+        if (cardinality > kArrayMaxCardinality) *this = from_words(to_words());
+        return;
+      }
+      case Kind::Bitmap: {
+        uint64_t& word = words[low / 64];
+        const uint64_t mask = uint64_t{1} << (low % 64);
+        if (!(word & mask)) {
+          word |= mask;
+          ++cardinality;
+        }
+        return;
+      }
+      case Kind::Run: {
+        if (contains(low)) return;
+        // Inserting into a run container is rare; rebuild through a bitmap
+        std::vector<uint64_t> bitmap_words = to_words();
+        bitmap_words[low / 64] |= uint64_t{1} << (low % 64);
+        *this = from_words(std::move(bitmap_words));
+        return;
+      }
+    }
+  }
+
+  // Convert to a run container when that is the smallest representation
+  void run_optimize() {
+    const std::vector<uint64_t> bitmap_words = to_words();
+    size_t run_count = 0;
+    uint64_t carry = 0;  // top bit of the previous word
+    for (uint64_t word : bitmap_words) {
+      run_count += std::popcount(word & ~((word << 1) | carry));
+      carry = word >> 63;
+    }
+
+    const size_t run_bytes = run_count * 2 * sizeof(uint16_t);
+    const size_t current_bytes = kind == Kind::Bitmap ? kBitmapWords * sizeof(uint64_t)
+                                                      : values.size() * sizeof(uint16_t);
+    if (kind == Kind::Run || run_bytes >= current_bytes) return;
+
+    std::vector<uint16_t> runs;
+    runs.reserve(run_count * 2);
+    uint32_t v = 0;
+    while (v < 65536) {
+      if (!((bitmap_words[v / 64] >> (v % 64)) & 1)) {
+        ++v;
+        continue;
+      }
+      const uint32_t start = v;
+      while (v < 65536 && ((bitmap_words[v / 64] >> (v % 64)) & 1)) ++v;
+      runs.push_back(static_cast<uint16_t>(start));
+      runs.push_back(static_cast<uint16_t>(v - start - 1));
+    }
+
+    kind = Kind::Run;
+    values = std::move(runs);
+    words.clear();
+    words.shrink_to_fit();
+  }
+};
+
+enum class SetOp { And, Or, Xor, AndNot };
+
+inline Container combine(const Container& a, const Container& b, SetOp op) {
+  using Kind = Container::Kind;
+
+  // Array x Array: sorted merges
+  if (a.kind == Kind::Array && b.kind == Kind::Array) {
+    std::vector<uint16_t> out;
+    auto sink = std::back_inserter(out);
+    switch (op) {
+      case SetOp::And:
+        std::set_intersection(a.values.begin(), a.values.end(), b.values.begin(),
+                              b.values.end(), sink);
+        break;
+      case SetOp::Or:
+        std::set_union(a.values.begin(), a.values.end(), b.values.begin(), b.values.end(),
+                       sink);
+        break;
+      case SetOp::Xor:
+        std::set_symmetric_difference(a.values.begin(), a.values.end(), b.values.begin(),
+                                      b.values.end(), sink);
+        break;
+      case SetOp::AndNot:
+        std::set_difference(a.values.begin(), a.values.end(), b.values.begin(), b.values.end(),
+                            sink);
+        break;
+    }
+    return Container::from_values(std::move(out));
+  }
+
+  // Small array against anything: probe instead of materialising a bitmap
+  if (a.kind == Kind::Array && (op == SetOp::And || op == SetOp::AndNot)) {
+    std::vector<uint16_t> out;
+    for (uint16_t v : a.values) {
+      if (b.contains(v) == (op == SetOp::And)) out.push_back(v);
+    }
+    return Container::from_values(std::move(out));
+  }
+  if (b.kind == Kind::Array && op == SetOp::And) return combine(b, a, op);
+
+  // General case: word-wise on bitmap views
+  std::vector<uint64_t> out = a.to_words();
+  const std::vector<uint64_t> rhs = b.to_words();
+  for (size_t i = 0; i < kBitmapWords; ++i) {
+    switch (op) {
+      case SetOp::And:
+        out[i] &= rhs[i];
+        break;
+      case SetOp::Or:
+        out[i] |= rhs[i];
+        break;
+      case SetOp::Xor:
+        out[i] ^= rhs[i];
+        break;
+      case SetOp::AndNot:
+        out[i] &= ~rhs[i];
+        break;
+    }
+  }
+  return Container::from_words(std::move(out));
+}
+
+class RoaringBitmap {
+ public:
+  RoaringBitmap() = default;
+
+  // Bulk build from sorted, de-duplicated IDs
+  static RoaringBitmap from_sorted(std::span<const uint32_t> ids) {
+    RoaringBitmap result;
+    size_t i = 0;
+    while (i < ids.size()) {
+      const uint16_t key = static_cast<uint16_t>(ids[i] >> 16);
+      std::vector<uint16_t> lows;
+      for (; i < ids.size() && (ids[i] >> 16) == key; ++i) {
+        lows.push_back(static_cast<uint16_t>(ids[i] & 0xffff));
+      }
+      result.keys_.push_back(key);
+      result.containers_.push_back(Container::from_values(std::move(lows)));
+    }
+    return result;
+  }
+
+  void add(uint32_t id) {
+    const uint16_t key = static_cast<uint16_t>(id >> 16);
+    auto it = std::lower_bound(keys_.begin(), keys_.end(), key);
+    const size_t index = static_cast<size_t>(it - keys_.begin());
+    if (it == keys_.end() || *it != key) {
+      keys_.insert(it, key);
+      containers_.insert(containers_.begin() + static_cast<std::ptrdiff_t>(index), Container{});
+    }
+    containers_[index].add(static_cast<uint16_t>(id & 0xffff));
+  }
+
+  bool contains(uint32_t id) const {
+    const uint16_t key = static_cast<uint16_t>(id >> 16);
+    auto it = std::lower_bound(keys_.begin(), keys_.end(), key);
+    if (it == keys_.end() || *it != key) return false;
+    return containers_[static_cast<size_t>(it - keys_.begin())].contains(
+        static_cast<uint16_t>(id & 0xffff));
+  }
+
+  uint64_t cardinality() const {
+    uint64_t total = 0;
+    for (const auto& c : containers_) total += c.cardinality;
+    return total;
+  }
+
+  template <typename F>
+  void for_each(F&& f) const {
+    for (size_t i = 0; i < keys_.size(); ++i) {
+      containers_[i].for_each(uint32_t{keys_[i]} << 16, f);
+    }
+  }
+
+  void run_optimize() {
+    for (auto& c : containers_) c.run_optimize();
+  }
+
+  size_t memory_bytes() const {
+    size_t total = keys_.capacity() * sizeof(uint16_t) + containers_.capacity() * sizeof(Container);
+    for (const auto& c : containers_) total += c.memory_bytes();
+    return total;
+  }
+
+  // Container counts by kind: {array, bitmap, run}
+  std::array<size_t, 3> container_stats() const {
+    std::array<size_t, 3> stats{};
+    for (const auto& c : containers_) ++stats[static_cast<size_t>(c.kind)];
+    return stats;
+  }
+
+  friend RoaringBitmap operator&(const RoaringBitmap& a, const RoaringBitmap& b) {
+    return merge(a, b, SetOp::And);
+  }
+  friend RoaringBitmap operator|(const RoaringBitmap& a, const RoaringBitmap& b) {
+    return merge(a, b, SetOp::Or);
+  }
+  friend RoaringBitmap operator^(const RoaringBitmap& a, const RoaringBitmap& b) {
+    return merge(a, b, SetOp::Xor);
+  }
+  friend RoaringBitmap and_not(const RoaringBitmap& a, const RoaringBitmap& b) {
+    return merge(a, b, SetOp::AndNot);
+  }
+
+  // Little-endian layout:
+  //   "RBM1" | u32 container count | per container:
+  //   u16 key | u8 kind | u32 cardinality | u32 payload element count | payload
+  // Payload is u16 values (array/run) or u64 words (bitmap).
+  std::vector<uint8_t> serialize() const {
+    std::vector<uint8_t> out = {'R', 'B', 'M', '1'};
+    put(out, static_cast<uint32_t>(keys_.size()), 4);
+    for (size_t i = 0; i < keys_.size(); ++i) {
+      const Container& c = containers_[i];
+      put(out, keys_[i], 2);
+      put(out, static_cast<uint8_t>(c.kind), 1);
+      put(out, c.cardinality, 4);
+      if (c.kind == Container::Kind::Bitmap) {
+        put(out, static_cast<uint32_t>(c.words.size()), 4);
+        for (uint64_t w : c.words) put(out, w, 8);
+      } else {
+        put(out, static_cast<uint32_t>(c.values.size()), 4);
+        for (uint16_t v : c.values) put(out, v, 2);
+      }
+    }
+    return out;
+  }
+
+  // Parses untrusted bytes. Returns nullopt (and sets *error when given) if the
+  // input is truncated or would break a container invariant: keys strictly
+  // increasing, no empty containers, arrays sorted and at most
+  // kArrayMaxCardinality long, bitmaps exactly kBitmapWords words, runs
+  // sorted, disjoint and inside [0, 65535], cardinality matching the payload.
+  // Every length is checked against the remaining bytes before allocating.
+  static std::optional<RoaringBitmap> deserialize(std::span<const uint8_t> in,
+                                                  const char** error = nullptr) {
+    auto fail = [error](const char* reason) -> std::optional<RoaringBitmap> {
+      if (error != nullptr) *error = reason;
+      return std::nullopt;
+    };
+    if (in.size() < 8 || in[0] != 'R' || in[1] != 'B' || in[2] != 'M' || in[3] != '1') {
+      return fail("bad header");
+    }
+    size_t pos = 4;
+    const auto count = static_cast<uint32_t>(get(in, pos, 4));
+    constexpr size_t kContainerHeader = 2 + 1 + 4 + 4;
+    if (count > (in.size() - pos) / kContainerHeader) return fail("container count too large");
+
+    RoaringBitmap result;
+    result.keys_.reserve(count);
+    result.containers_.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+      if (in.size() - pos < kContainerHeader) return fail("truncated input");
+      const auto key = static_cast<uint16_t>(get(in, pos, 2));
+      const auto kind = static_cast<uint8_t>(get(in, pos, 1));
+      const auto cardinality = static_cast<uint32_t>(get(in, pos, 4));
+      const auto elements = static_cast<uint32_t>(get(in, pos, 4));
+      if (!result.keys_.empty() && key <= result.keys_.back()) return fail("keys not increasing");
+      if (kind > static_cast<uint8_t>(Container::Kind::Run)) return fail("bad container kind");
+
+      Container c;
+      c.kind = static_cast<Container::Kind>(kind);
+      c.cardinality = cardinality;
+      const size_t element_bytes = c.kind == Container::Kind::Bitmap ? 8 : 2;
+      if (elements > (in.size() - pos) / element_bytes) return fail("truncated input");
+
+      uint64_t counted = 0;
+      switch (c.kind) {
+        case Container::Kind::Bitmap:
+          if (elements != kBitmapWords) return fail("bad bitmap size");
+          c.words.resize(elements);
+          for (auto& w : c.words) w = get(in, pos, 8);
+          counted = bits::popcount(c.words);
+          if (counted <= kArrayMaxCardinality) return fail("sparse bitmap container");
+          break;
+        case Container::Kind::Array:
+          if (elements > kArrayMaxCardinality) return fail("array container too large");
+          c.values.resize(elements);
+          for (size_t v = 0; v < elements; ++v) {
+            c.values[v] = static_cast<uint16_t>(get(in, pos, 2));
+            if (v > 0 && c.values[v] <= c.values[v - 1]) return fail("array not sorted");
+          }
+          counted = elements;
+          break;
+        case Container::Kind::Run: {
+          if (elements % 2 != 0) return fail("odd run length");
+          c.values.resize(elements);
+          for (auto& v : c.values) v = static_cast<uint16_t>(get(in, pos, 2));
+          int64_t previous_end = -1;
+          for (size_t r = 0; r < elements; r += 2) {
+            const uint32_t start = c.values[r];
+            const uint32_t end = start + c.values[r + 1];
+            if (end > 0xffff) return fail("run past container end");
+            if (static_cast<int64_t>(start) <= previous_end) return fail("runs overlap");
+            previous_end = end;
+            counted += end - start + 1;
+          }
+          break;
+        }
+      }
+      if (counted == 0) return fail("empty container");
+      if (counted != cardinality) return fail("cardinality mismatch");
+      result.keys_.push_back(key);
+      result.containers_.push_back(std::move(c));
+    }
+    return result;
+  }
+
+ private:
+  std::vector<uint16_t> keys_;  // sorted high halves
+  std::vector<Container> containers_;
+
+  static RoaringBitmap merge(const RoaringBitmap& a, const RoaringBitmap& b, SetOp op) {
+    RoaringBitmap result;
+    size_t i = 0;
+    size_t j = 0;
+    auto emit = [&result](uint16_t key, Container c) {
+      if (c.cardinality == 0) return;
+      result.keys_.push_back(key);
+      result.containers_.push_back(std::move(c));
+    };
+
+    while (i < a.keys_.size() && j < b.keys_.size()) {
+      if (a.keys_[i] < b.keys_[j]) {
+        if (op != SetOp::And) emit(a.keys_[i], a.containers_[i]);
+        ++i;
+      } else if (b.keys_[j] < a.keys_[i]) {
+        if (op == SetOp::Or || op == SetOp::Xor) emit(b.keys_[j], b.containers_[j]);
+        ++j;
+      } else {
+        emit(a.keys_[i], combine(a.containers_[i], b.containers_[j], op));
+        ++i;
+        ++j;
+      }
+    }
+    if (op != SetOp::And) {
+      for (; i < a.keys_.size(); ++i) emit(a.keys_[i], a.containers_[i]);
+    }
+    if (op == SetOp::Or || op == SetOp::Xor) {
+      for (; j < b.keys_.size(); ++j) emit(b.keys_[j], b.containers_[j]);
+    }
+    return result;
+  }
+
+  static void put(std::vector<uint8_t>& out, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+  }
+
+  // Caller has already checked that bytes are available
+  static uint64_t get(std::span<const uint8_t> in, size_t& pos, int bytes) {
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; ++i) value |= uint64_t{in[pos++]} << (8 * i);
+    return value;
+  }
+};
+
+}  // namespace cpp20_features::roaring
+
+#endif  // CPP20_FEATURES_ROARING_H
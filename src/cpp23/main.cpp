@@ -13,6 +13,7 @@
 #include <utility>
 #include <vector>
 
+#include "../include/alloc_tracker.h"
 #include "../include/utils.h"
 
 // Note: Many C++23 features may not be fully supported yet in all compilers
@@ -394,7 +395,7 @@ void demo_ranges_improvements() {
   // Enumerate-like functionality (C++23 might add std::views::enumerate)
   std::cout << "  Indexed elements:\n";
   for (size_t i = 0; auto value : numbers | std::views::take(5)) {
-    cpp_features::Demo::print_value("  [" + std::to_string(i++) + "]", value);
+    cpp_features::Demo::print_value("  [" + cpp_features::number_format::to_text(i++) + "]", value);
   }
 
   // Chunk view (if available)
@@ -448,15 +449,16 @@ int main() {
   std::cout << "Note: Many C++23 features are still being implemented by compilers.\n";
   std::cout << "This demo shows available features and fallbacks for others.\n\n";
 
-  cpp23_features::demo_print();
-  cpp23_features::demo_expected();
-  cpp23_features::demo_flat_containers();
-  cpp23_features::demo_multidimensional_subscript();
-  cpp23_features::demo_deducing_this();
-  cpp23_features::demo_if_consteval();
-  cpp23_features::demo_auto_cast();
-  cpp23_features::demo_ranges_improvements();
-  cpp23_features::demo_string_contains();
+  cpp_features::run_demo("demo_print", cpp23_features::demo_print);
+  cpp_features::run_demo("demo_expected", cpp23_features::demo_expected);
+  cpp_features::run_demo("demo_flat_containers", cpp23_features::demo_flat_containers);
+  cpp_features::run_demo("demo_multidimensional_subscript",
+                         cpp23_features::demo_multidimensional_subscript);
+  cpp_features::run_demo("demo_deducing_this", cpp23_features::demo_deducing_this);
+  cpp_features::run_demo("demo_if_consteval", cpp23_features::demo_if_consteval);
+  cpp_features::run_demo("demo_auto_cast", cpp23_features::demo_auto_cast);
+  cpp_features::run_demo("demo_ranges_improvements", cpp23_features::demo_ranges_improvements);
+  cpp_features::run_demo("demo_string_contains", cpp23_features::demo_string_contains);
 
   std::cout << "\nC++23 features demonstration completed!\n";
   std::cout << "Note: Full C++23 support varies by compiler and standard library implementation.\n";
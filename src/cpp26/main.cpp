@@ -7,6 +7,8 @@
 #include <type_traits>
 #include <vector>
 
+#include "../include/alloc_tracker.h"
+#include "../include/json_fields.h"
 #include "../include/utils.h"
 
 // C++26 Features Demonstration
@@ -15,6 +17,15 @@
 
 namespace cpp26_features {
 
+// No CPP_FEATURES_JSON_FIELDS needed when reflection is available: json_fields.h
+// enumerates the members of aggregates itself
+struct ReflectedPoint {
+  std::string label;
+  int x = 0;
+  int y = 0;
+  std::vector<double> weights;
+};
+
 // C++26: Reflection (Proposed)
 void demo_reflection() {
   cpp_features::Demo::print_section("Reflection (Proposed)");
@@ -25,9 +36,12 @@ void demo_reflection() {
   // If reflection is available (highly unlikely in current compilers)
   std::cout << "  Reflection is available!\n";
 
-  // Example of what reflection might look like:
-  // std::meta::info type_info = ^int;
-  // std::cout << "  Type name: " << std::meta::name_of(type_info) << "\n";
+  // Serialiser generated from std::meta::nonstatic_data_members_of(^^ReflectedPoint)
+  const ReflectedPoint point{"origin", 0, 0, {0.5, 1.5}};
+  const std::string text = cpp_features::to_json_text(point);
+  std::cout << "  Reflected JSON: " << text << "\n";
+  const auto back = cpp_features::from_json_text<ReflectedPoint>(text);
+  std::cout << "  Round trip label: " << back.label << "\n";
 #else
   std::cout << "  ❌ Reflection not available in this compiler\n";
   std::cout << "  📚 Proposed syntax example:\n";
@@ -38,7 +52,8 @@ void demo_reflection() {
 
   std::cout << "  🎯 Benefits:\n";
   std::cout << "     • Compile-time type introspection\n";
-  std::cout << "     • Automatic serialization/deserialization\n";
+  std::cout << "     • Automatic serialization/deserialization (json_fields.h derives\n";
+  std::cout << "       serialisers for aggregates once __cpp_lib_reflection is defined)\n";
   std::cout << "     • Generic programming improvements\n";
   std::cout << "     • Reduced boilerplate code\n";
 #endif
@@ -346,15 +361,15 @@ int main() {
   std::cout << "Most features shown here are proposed and not yet standardized.\n";
   std::cout << "Compiler support varies and many features are experimental.\n\n";
 
-  cpp26_features::demo_reflection();
-  cpp26_features::demo_pattern_matching();
-  cpp26_features::demo_contracts();
-  cpp26_features::demo_enhanced_constexpr();
-  cpp26_features::demo_improved_modules();
-  cpp26_features::demo_linear_algebra();
-  cpp26_features::demo_networking();
-  cpp26_features::demo_advanced_ranges();
-  cpp26_features::demo_hazard_pointers();
+  cpp_features::run_demo("demo_reflection", cpp26_features::demo_reflection);
+  cpp_features::run_demo("demo_pattern_matching", cpp26_features::demo_pattern_matching);
+  cpp_features::run_demo("demo_contracts", cpp26_features::demo_contracts);
+  cpp_features::run_demo("demo_enhanced_constexpr", cpp26_features::demo_enhanced_constexpr);
+  cpp_features::run_demo("demo_improved_modules", cpp26_features::demo_improved_modules);
+  cpp_features::run_demo("demo_linear_algebra", cpp26_features::demo_linear_algebra);
+  cpp_features::run_demo("demo_networking", cpp26_features::demo_networking);
+  cpp_features::run_demo("demo_advanced_ranges", cpp26_features::demo_advanced_ranges);
+  cpp_features::run_demo("demo_hazard_pointers", cpp26_features::demo_hazard_pointers);
 
   std::cout << "\n" << std::string(60, '=') << "\n";
   std::cout << "C++26 Features Preview Completed!\n\n";
@@ -0,0 +1,158 @@
+// Replacement global operator new/delete that counts allocations.
+// Linked into every target when configured with `xmake f --alloc_tracking=y`.
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <new>
+
+#include "../../include/alloc_tracker.h"
+
+namespace {
+
+std::atomic<uint64_t> g_allocations(0);
+std::atomic<uint64_t> g_deallocations(0);
+std::atomic<uint64_t> g_bytes_allocated(0);
+std::atomic<uint64_t> g_live_bytes(0);
+std::atomic<uint64_t> g_peak_live_bytes(0);
+
+// Stored just before every user pointer so delete knows the block size even
+// when the unsized operator delete is called
+struct BlockHeader {
+  void* raw;
+  std::size_t size;
+};
+
+void raise_peak(uint64_t live) {
+  uint64_t peak = g_peak_live_bytes.load(std::memory_order_relaxed);
+  while (live > peak &&
+         !g_peak_live_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+  }
+}
+
+// Returns nullptr when the request cannot be satisfied; a huge size whose
+// padded total would wrap around fails instead of returning a short block
+void* tracked_alloc(std::size_t size, std::size_t alignment) {
+  alignment = std::max(alignment, alignof(BlockHeader));
+  if (size > std::numeric_limits<std::size_t>::max() - sizeof(BlockHeader) - alignment) {
+    return nullptr;
+  }
+  const std::size_t total = size + sizeof(BlockHeader) + alignment;
+
+  void* raw = std::malloc(total);
+  while (raw == nullptr) {
+    std::new_handler handler = std::get_new_handler();
+    if (handler == nullptr) return nullptr;
+    handler();
+    raw = std::malloc(total);
+  }
+
+  std::uintptr_t user = reinterpret_cast<std::uintptr_t>(raw) + sizeof(BlockHeader);
+  user = (user + alignment - 1) & ~static_cast<std::uintptr_t>(alignment - 1);
+  BlockHeader* header = reinterpret_cast<BlockHeader*>(user) - 1;
+  header->raw = raw;
+  header->size = size;
+
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  g_bytes_allocated.fetch_add(size, std::memory_order_relaxed);
+  raise_peak(g_live_bytes.fetch_add(size, std::memory_order_relaxed) + size);
+  return reinterpret_cast<void*>(user);
+}
+
+void* tracked_alloc_or_throw(std::size_t size, std::size_t alignment) {
+  void* p = tracked_alloc(size, alignment);
+  if (p == nullptr) throw std::bad_alloc();
+  return p;
+}
+
+// The new_handler may throw bad_alloc; the nothrow operators must not
+void* tracked_alloc_nothrow(std::size_t size, std::size_t alignment) noexcept {
+  try {
+    return tracked_alloc(size, alignment);
+  } catch (const std::bad_alloc&) {
+    return nullptr;
+  }
+}
+
+void tracked_free(void* p) {
+  if (p == nullptr) return;
+  BlockHeader* header = static_cast<BlockHeader*>(p) - 1;
+  g_deallocations.fetch_add(1, std::memory_order_relaxed);
+  g_live_bytes.fetch_sub(header->size, std::memory_order_relaxed);
+  std::free(header->raw);
+}
+
+const std::size_t kDefaultAlignment = alignof(std::max_align_t);
+
+}  // namespace
+
+namespace cpp_features {
+namespace alloc_tracking {
+
+AllocStats snapshot() {
+  AllocStats stats;
+  stats.allocations = g_allocations.load(std::memory_order_relaxed);
+  stats.deallocations = g_deallocations.load(std::memory_order_relaxed);
+  stats.bytes_allocated = g_bytes_allocated.load(std::memory_order_relaxed);
+  stats.live_bytes = g_live_bytes.load(std::memory_order_relaxed);
+  stats.peak_live_bytes = g_peak_live_bytes.load(std::memory_order_relaxed);
+  return stats;
+}
+
+uint64_t reset_peak() {
+  return g_peak_live_bytes.exchange(g_live_bytes.load(std::memory_order_relaxed),
+                                    std::memory_order_relaxed);
+}
+
+void restore_peak(uint64_t peak) { raise_peak(peak); }
+
+}  // namespace alloc_tracking
+}  // namespace cpp_features
+
+void* operator new(std::size_t size) { return tracked_alloc_or_throw(size, kDefaultAlignment); }
+void* operator new[](std::size_t size) { return tracked_alloc_or_throw(size, kDefaultAlignment); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+  return tracked_alloc_nothrow(size, kDefaultAlignment);
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+  return tracked_alloc_nothrow(size, kDefaultAlignment);
+}
+
+void operator delete(void* p) noexcept { tracked_free(p); }
+void operator delete[](void* p) noexcept { tracked_free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { tracked_free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { tracked_free(p); }
+
+#ifdef __cpp_sized_deallocation
+void operator delete(void* p, std::size_t) noexcept { tracked_free(p); }
+void operator delete[](void* p, std::size_t) noexcept { tracked_free(p); }
+#endif
+
+#ifdef __cpp_aligned_new
+void* operator new(std::size_t size, std::align_val_t al) {
+  return tracked_alloc_or_throw(size, static_cast<std::size_t>(al));
+}
+void* operator new[](std::size_t size, std::align_val_t al) {
+  return tracked_alloc_or_throw(size, static_cast<std::size_t>(al));
+}
+void* operator new(std::size_t size, std::align_val_t al, const std::nothrow_t&) noexcept {
+  return tracked_alloc_nothrow(size, static_cast<std::size_t>(al));
+}
+void* operator new[](std::size_t size, std::align_val_t al, const std::nothrow_t&) noexcept {
+  return tracked_alloc_nothrow(size, static_cast<std::size_t>(al));
+}
+
+void operator delete(void* p, std::align_val_t) noexcept { tracked_free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { tracked_free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { tracked_free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { tracked_free(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+  tracked_free(p);
+}
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+  tracked_free(p);
+}
+#endif
@@ -0,0 +1,418 @@
+#ifndef CPP_FEATURES_COMBINED_JSON_INDEX_H
+#define CPP_FEATURES_COMBINED_JSON_INDEX_H
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// simdjson式两阶段JSON解析:
+//   第一阶段按64字节块分类字符, 用位运算求出转义、字符串内部和结构字符的位掩码,
+//   得到所有结构字符 ({}[]:, 以及未转义的引号) 的偏移数组;
+//   第二阶段的按需读取器沿着偏移数组前进, 只解码调用方要的字段, 其余整体跳过.
+// 分类有AVX2、SSE2和标量三种实现 (xmake f --simd=y 时启用AVX2和PCLMUL).
+// 读取器假定输入是合法JSON: 结构错误在影响到所读字段时报告, 不做完整的语法和UTF-8校验.
+namespace json_index {
+
+inline unsigned trailing_zeros(uint64_t x) {
+#if defined(_MSC_VER)
+  unsigned long index;
+  _BitScanForward64(&index, x);
+  return static_cast<unsigned>(index);
+#else
+  return static_cast<unsigned>(__builtin_ctzll(x));
+#endif
+}
+
+inline unsigned popcount64(uint64_t x) {
+#if defined(_MSC_VER)
+  return static_cast<unsigned>(__popcnt64(x));
+#else
+  return static_cast<unsigned>(__builtin_popcountll(x));
+#endif
+}
+
+// 一个64字节块的字符分类结果, 第i位对应块内第i个字节
+struct BlockMasks {
+  uint64_t quote;      // '"'
+  uint64_t backslash;  // '\\'
+  uint64_t op;         // { } [ ] : ,
+};
+
+inline BlockMasks classify_scalar(const char* p) {
+  BlockMasks m{0, 0, 0};
+  for (unsigned i = 0; i < 64; ++i) {
+    const char c = p[i];
+    const uint64_t bit = uint64_t{1} << i;
+    if (c == '"') m.quote |= bit;
+    if (c == '\\') m.backslash |= bit;
+    if (c == '{' || c == '}' || c == '[' || c == ']' || c == ':' || c == ',') m.op |= bit;
+  }
+  return m;
+}
+
+#if defined(__AVX2__)
+// c | 0x20 把 '[' ']' 映射到 '{' '}', 六个结构字符只需四次比较
+inline BlockMasks classify_simd(const char* p) {
+  auto block_mask = [p](auto&& match) {
+    const __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    const __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32));
+    return static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(match(lo)))) |
+           static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(match(hi)))) << 32;
+  };
+  auto eq = [](__m256i v, char c) { return _mm256_cmpeq_epi8(v, _mm256_set1_epi8(c)); };
+  BlockMasks m;
+  m.quote = block_mask([&](__m256i v) { return eq(v, '"'); });
+  m.backslash = block_mask([&](__m256i v) { return eq(v, '\\'); });
+  m.op = block_mask([&](__m256i v) {
+    const __m256i folded = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+    return _mm256_or_si256(_mm256_or_si256(eq(folded, '{'), eq(folded, '}')),
+                           _mm256_or_si256(eq(v, ':'), eq(v, ',')));
+  });
+  return m;
+}
+#elif defined(__SSE2__) || defined(_M_X64)
+inline BlockMasks classify_simd(const char* p) {
+  auto block_mask = [p](auto&& match) {
+    uint64_t mask = 0;
+    for (int i = 0; i < 4; ++i) {
+      const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * i));
+      const auto bits = static_cast<uint32_t>(_mm_movemask_epi8(match(v)));
+      mask |= static_cast<uint64_t>(bits) << (16 * i);
+    }
+    return mask;
+  };
+  auto eq = [](__m128i v, char c) { return _mm_cmpeq_epi8(v, _mm_set1_epi8(c)); };
+  BlockMasks m;
+  m.quote = block_mask([&](__m128i v) { return eq(v, '"'); });
+  m.backslash = block_mask([&](__m128i v) { return eq(v, '\\'); });
+  m.op = block_mask([&](__m128i v) {
+    const __m128i folded = _mm_or_si128(v, _mm_set1_epi8(0x20));
+    return _mm_or_si128(_mm_or_si128(eq(folded, '{'), eq(folded, '}')),
+                        _mm_or_si128(eq(v, ':'), eq(v, ',')));
+  });
+  return m;
+}
+#else
+inline BlockMasks classify_simd(const char* p) { return classify_scalar(p); }
+#endif
+
+// 前缀异或: 第i位 = x的第0..i位的异或, 即该位置是否处于一对引号之间
+inline uint64_t prefix_xor(uint64_t x) {
+#if defined(__PCLMUL__)
+  const __m128i all_ones = _mm_set1_epi8(static_cast<char>(0xFF));
+  return static_cast<uint64_t>(
+      _mm_cvtsi128_si64(_mm_clmulepi64_si128(_mm_set_epi64x(0, static_cast<long long>(x)),
+                                             all_ones, 0)));
+#else
+  x ^= x << 1;
+  x ^= x << 2;
+  x ^= x << 4;
+  x ^= x << 8;
+  x ^= x << 16;
+  x ^= x << 32;
+  return x;
+#endif
+}
+
+// 被反斜杠转义的字符位置 (simdjson的无分支算法): 连续反斜杠按奇偶配对,
+// 从偶数位开始的序列与从奇数位开始的序列分别处理; prev_escaped 跨块传递进位
+inline uint64_t escaped_mask(uint64_t backslash, uint64_t& prev_escaped) {
+  backslash &= ~prev_escaped;
+  const uint64_t follows_escape = backslash << 1 | prev_escaped;
+  const uint64_t even_bits = 0x5555555555555555ULL;
+  const uint64_t odd_sequence_starts = backslash & ~even_bits & ~follows_escape;
+  const uint64_t sequences_starting_on_even_bits = odd_sequence_starts + backslash;
+  prev_escaped = sequences_starting_on_even_bits < odd_sequence_starts ? 1 : 0;
+  const uint64_t invert_mask = sequences_starting_on_even_bits << 1;
+  return (even_bits ^ invert_mask) & follows_escape;
+}
+
+// 第一阶段: 返回所有结构字符的字节偏移 (升序). Classify 为块分类函数
+template <BlockMasks (*Classify)(const char*)>
+std::vector<uint32_t> build_index(std::string_view json) {
+  if (json.size() > UINT32_MAX) throw std::length_error("json_index: input exceeds 4 GB");
+
+  std::vector<uint32_t> positions;
+  positions.reserve(json.size() / 3);  // 学生数据约每3.4字节一个结构字符
+  uint64_t prev_escaped = 0;
+  uint64_t prev_in_string = 0;  // 全1表示上一块结束时仍在字符串内
+  char tail[64];
+
+  for (size_t base = 0; base < json.size(); base += 64) {
+    const char* block = json.data() + base;
+    if (json.size() - base < 64) {
+      std::memset(tail, ' ', sizeof(tail));
+      std::memcpy(tail, block, json.size() - base);
+      block = tail;
+    }
+
+    const BlockMasks m = Classify(block);
+    const uint64_t escaped = m.backslash ? escaped_mask(m.backslash, prev_escaped)
+                                         : std::exchange(prev_escaped, 0);
+    const uint64_t quotes = m.quote & ~escaped;
+    const uint64_t in_string = prefix_xor(quotes) ^ prev_in_string;
+    prev_in_string = static_cast<uint64_t>(static_cast<int64_t>(in_string) >> 63);
+
+    uint64_t structurals = (m.op & ~in_string) | quotes;
+    const size_t old_size = positions.size();
+    positions.resize(old_size + popcount64(structurals));
+    uint32_t* out = positions.data() + old_size;
+    while (structurals != 0) {
+      *out++ = static_cast<uint32_t>(base + trailing_zeros(structurals));
+      structurals &= structurals - 1;
+    }
+  }
+
+  if (prev_in_string != 0) throw std::runtime_error("json_index: unterminated string");
+  return positions;
+}
+
+inline std::vector<uint32_t> build_index_simd(std::string_view json) {
+  return build_index<classify_simd>(json);
+}
+inline std::vector<uint32_t> build_index_scalar(std::string_view json) {
+  return build_index<classify_scalar>(json);
+}
+
+// 第二阶段: 沿结构索引前进的按需读取器
+class OnDemandReader {
+ public:
+  OnDemandReader(std::string_view json, const std::vector<uint32_t>& index)
+      : json_(json), index_(index) {}
+
+  bool at_end() const { return pos_ >= index_.size(); }
+  char peek() const { return at_end() ? '\0' : json_[index_[pos_]]; }
+
+  void expect(char c) {
+    if (peek() != c) fail(std::string("expected '") + c + "'");
+    ++pos_;
+  }
+
+  bool consume(char c) {
+    if (peek() != c) return false;
+    ++pos_;
+    return true;
+  }
+
+  // 当前引号到下一个引号之间的原始内容 (未反转义)
+  std::string_view raw_string() {
+    if (at_end()) fail("expected string");
+    const uint32_t open = index_[pos_];
+    expect('"');
+    const uint32_t close = at_end() ? open : index_[pos_];
+    expect('"');
+    return json_.substr(open + 1, close - open - 1);
+  }
+
+  // 字符串值; 只有含反斜杠时才反转义到 scratch
+  std::string_view string_value(std::string& scratch) {
+    const std::string_view raw = raw_string();
+    if (raw.find('\\') == std::string_view::npos) return raw;
+    unescape(raw, scratch);
+    return scratch;
+  }
+
+  // 标量 (数字/true/false/null) 不是结构字符, 位于上一个和下一个结构字符之间
+  std::string_view scalar() const {
+    if (pos_ == 0 || at_end()) fail("expected value");
+    size_t begin = index_[pos_ - 1] + 1;
+    size_t end = index_[pos_];
+    while (begin < end && is_space(json_[begin])) ++begin;
+    while (end > begin && is_space(json_[end - 1])) --end;
+    if (begin == end) fail("expected value");
+    return json_.substr(begin, end - begin);
+  }
+
+  long long integer_value() const {
+    const std::string_view text = scalar();
+    long long value = 0;
+    const auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (result.ec != std::errc() || result.ptr != text.data() + text.size()) fail("bad integer");
+    return value;
+  }
+
+  double double_value() const {
+    const std::string_view text = scalar();
+    double value = 0.0;
+// 浮点 from_chars 在部分标准库中缺失, 退回 strtod (输入以结构字符结尾, 不会越界)
+#if defined(__cpp_lib_to_chars)
+    const auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (result.ec != std::errc() || result.ptr != text.data() + text.size()) fail("bad number");
+#else
+    char* end = nullptr;
+    value = std::strtod(text.data(), &end);
+    if (end != text.data() + text.size()) fail("bad number");
+#endif
+    return value;
+  }
+
+  // 跳过当前值: 字符串、对象/数组 (按括号配对), 标量不占结构位置无需处理
+  void skip_value() {
+    const char c = peek();
+    if (c == '"') {
+      pos_ += 2;
+    } else if (c == '{' || c == '[') {
+      int depth = 0;
+      do {
+        const char s = peek();
+        if (s == '{' || s == '[') ++depth;
+        if (s == '}' || s == ']') --depth;
+        if (s == '\0') fail("unbalanced brackets");
+        ++pos_;
+      } while (depth > 0);
+    }
+  }
+
+  [[noreturn]] void fail(const std::string& message) const {
+    const size_t offset = at_end() ? json_.size() : index_[pos_];
+    throw std::runtime_error("json_index: " + message + " at byte " + std::to_string(offset));
+  }
+
+ private:
+  std::string_view json_;
+  const std::vector<uint32_t>& index_;
+  size_t pos_ = 0;
+
+  static bool is_space(char c) { return c == ' ' || c == '\n' || c == '\r' || c == '\t'; }
+
+  static void append_utf8(std::string& out, uint32_t cp) {
+    if (cp < 0x80) {
+      out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+      out += static_cast<char>(0xC0 | (cp >> 6));
+      out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+      out += static_cast<char>(0xE0 | (cp >> 12));
+      out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+      out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+      out += static_cast<char>(0xF0 | (cp >> 18));
+      out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+      out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+      out += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+  }
+
+  uint32_t hex4(std::string_view raw, size_t at) const {
+    if (at + 4 > raw.size()) fail("truncated \\u escape");
+    uint32_t value = 0;
+    for (size_t i = at; i < at + 4; ++i) {
+      const char c = raw[i];
+      value <<= 4;
+      if (c >= '0' && c <= '9') {
+        value |= static_cast<uint32_t>(c - '0');
+      } else if ((c | 0x20) >= 'a' && (c | 0x20) <= 'f') {
+        value |= static_cast<uint32_t>((c | 0x20) - 'a' + 10);
+      } else {
+        fail("bad \\u escape");
+      }
+    }
+    return value;
+  }
+
+  void unescape(std::string_view raw, std::string& out) const {
+    out.clear();
+    for (size_t i = 0; i < raw.size(); ++i) {
+      if (raw[i] != '\\') {
+        out += raw[i];
+        continue;
+      }
+      if (++i == raw.size()) fail("truncated escape");
+      switch (raw[i]) {
+        case '"': out += '"'; break;
+        case '\\': out += '\\'; break;
+        case '/': out += '/'; break;
+        case 'b': out += '\b'; break;
+        case 'f': out += '\f'; break;
+        case 'n': out += '\n'; break;
+        case 'r': out += '\r'; break;
+        case 't': out += '\t'; break;
+        case 'u': {
+          uint32_t cp = hex4(raw, i + 1);
+          i += 4;
+          // UTF-16代理对
+          if (cp >= 0xD800 && cp < 0xDC00 && i + 6 < raw.size() && raw[i + 1] == '\\' &&
+              raw[i + 2] == 'u') {
+            const uint32_t low = hex4(raw, i + 3);
+            if (low >= 0xDC00 && low < 0xE000) {
+              cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+              i += 6;
+            }
+          }
+          append_utf8(out, cp);
+          break;
+        }
+        default: fail("bad escape");
+      }
+    }
+  }
+};
+
+// 按需解析学生数组: 只解码 from_json(Student) 使用的四个字段, 未知字段整体跳过.
+// 缺字段时抛出 std::runtime_error
+template <typename StudentT, typename Sink>
+size_t parse_students(std::string_view json, const std::vector<uint32_t>& index, Sink&& sink) {
+  OnDemandReader reader(json, index);
+  std::string scratch;
+  size_t records = 0;
+
+  reader.expect('[');
+  if (reader.consume(']')) return 0;
+  do {
+    reader.expect('{');
+    StudentT student;
+    unsigned seen = 0;
+    if (reader.peek() != '}') {
+      do {
+        const std::string_view key = reader.string_value(scratch);
+        reader.expect(':');
+        if (key == "name") {
+          student.name = reader.string_value(scratch);
+          seen |= 1;
+        } else if (key == "age") {
+          student.age = static_cast<int>(reader.integer_value());
+          seen |= 2;
+        } else if (key == "gpa") {
+          student.gpa = reader.double_value();
+          seen |= 4;
+        } else if (key == "courses") {
+          reader.expect('[');
+          if (!reader.consume(']')) {
+            do {
+              student.add_course(reader.string_value(scratch));
+            } while (reader.consume(','));
+            reader.expect(']');
+          }
+          seen |= 8;
+        } else {
+          reader.skip_value();
+        }
+      } while (reader.consume(','));
+    }
+    reader.expect('}');
+    if (seen != 15) reader.fail("student record is missing fields");
+    sink(std::move(student));
+    ++records;
+  } while (reader.consume(','));
+  reader.expect(']');
+  return records;
+}
+
+}  // namespace json_index
+
+#endif  // CPP_FEATURES_COMBINED_JSON_INDEX_H
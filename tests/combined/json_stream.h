@@ -0,0 +1,313 @@
+#ifndef CPP_FEATURES_COMBINED_JSON_STREAM_H
+#define CPP_FEATURES_COMBINED_JSON_STREAM_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+
+// 流式JSON读写: 不构建DOM, 内存占用与文件大小无关
+
+// 带固定缓冲区的文件写入器, 缓冲区满时整块写出 (stdio自身的缓冲关闭)
+class BufferedFileWriter {
+ public:
+  explicit BufferedFileWriter(const std::string& path, size_t buffer_bytes = size_t{1} << 20)
+      : file_(std::fopen(path.c_str(), "wb")), buffer_(buffer_bytes) {
+    if (file_ == nullptr) throw std::runtime_error("无法打开文件: " + path);
+    std::setvbuf(file_, nullptr, _IONBF, 0);
+  }
+
+  BufferedFileWriter(const BufferedFileWriter&) = delete;
+  BufferedFileWriter& operator=(const BufferedFileWriter&) = delete;
+
+  ~BufferedFileWriter() {
+    if (file_ == nullptr) return;
+    try {
+      close();
+    } catch (...) {
+      // 析构中不抛出; 需要错误信息时显式调用 close()
+    }
+  }
+
+  void write(std::string_view text) {
+    if (text.size() > buffer_.size() - used_) {
+      flush();
+      if (text.size() > buffer_.size()) {
+        write_through(text.data(), text.size());
+        return;
+      }
+    }
+    std::memcpy(buffer_.data() + used_, text.data(), text.size());
+    used_ += text.size();
+  }
+
+  void put(char c) {
+    if (used_ == buffer_.size()) flush();
+    buffer_[used_++] = c;
+  }
+
+  void flush() {
+    write_through(buffer_.data(), used_);
+    used_ = 0;
+  }
+
+  void close() {
+    flush();
+    std::FILE* file = std::exchange(file_, nullptr);
+    if (std::fclose(file) != 0) throw std::runtime_error("关闭文件失败");
+  }
+
+  size_t bytes_written() const { return bytes_written_ + used_; }
+
+ private:
+  std::FILE* file_;
+  std::vector<char> buffer_;
+  size_t used_ = 0;
+  size_t bytes_written_ = 0;
+
+  void write_through(const char* data, size_t size) {
+    if (size != 0 && std::fwrite(data, 1, size, file_) != size) {
+      throw std::runtime_error("写入文件失败");
+    }
+    bytes_written_ += size;
+  }
+};
+
+// 按JSON规则转义并加引号
+inline void write_json_string(BufferedFileWriter& out, std::string_view s) {
+  out.put('"');
+  size_t run = 0;  // 连续无需转义的字符整段写出
+  for (size_t i = 0; i < s.size(); ++i) {
+    const auto c = static_cast<unsigned char>(s[i]);
+    if (c >= 0x20 && c != '"' && c != '\\') continue;
+    out.write(s.substr(run, i - run));
+    run = i + 1;
+    switch (c) {
+      case '"': out.write("\\\""); break;
+      case '\\': out.write("\\\\"); break;
+      case '\n': out.write("\\n"); break;
+      case '\r': out.write("\\r"); break;
+      case '\t': out.write("\\t"); break;
+      default: {
+        char escaped[8];
+        auto result = fmt::format_to_n(escaped, sizeof(escaped), "\\u{:04x}", c);
+        out.write(std::string_view(escaped, result.size));
+      }
+    }
+  }
+  out.write(s.substr(run));
+  out.put('"');
+}
+
+// 与 nlohmann::json::dump 一致: 非有限值写null, 整数值的浮点数保留 ".0"
+inline void write_json_number(BufferedFileWriter& out, double value) {
+  if (!std::isfinite(value)) {
+    out.write("null");
+    return;
+  }
+  char text[32];
+  auto result = fmt::format_to_n(text, sizeof(text), "{}", value);
+  std::string_view digits(text, result.size);
+  out.write(digits);
+  if (digits.find_first_of(".e") == std::string_view::npos) out.write(".0");
+}
+
+inline void write_json_number(BufferedFileWriter& out, long long value) {
+  char text[24];
+  auto result = fmt::format_to_n(text, sizeof(text), "{}", value);
+  out.write(std::string_view(text, result.size));
+}
+
+// 一条学生记录, 字段与 to_json(json&, const Student&) 相同
+template <typename StudentT>
+void write_student_json(BufferedFileWriter& out, const StudentT& student) {
+  out.write("{\"name\":");
+  write_json_string(out, std::string_view(student.name));
+  out.write(",\"age\":");
+  write_json_number(out, static_cast<long long>(student.age));
+  out.write(",\"gpa\":");
+  write_json_number(out, student.gpa);
+  out.write(",\"courses\":[");
+  bool first = true;
+  for (const auto& course : student.courses) {
+    if (!first) out.put(',');
+    first = false;
+    write_json_string(out, std::string_view(course));
+  }
+  out.write("]}");
+}
+
+// SAX处理器: 顶层数组中的每个对象直接解析成StudentT交给sink, 不生成DOM.
+// 与 from_json 一样忽略未知字段; 缺字段、类型不符和语法错误记录在 error() 中并终止解析
+template <typename StudentT, typename Sink>
+class StudentSaxHandler {
+ public:
+  using json = nlohmann::json;
+
+  explicit StudentSaxHandler(Sink sink) : sink_(std::move(sink)) {}
+
+  const std::string& error() const { return error_; }
+  size_t records() const { return records_; }
+
+  bool null() { return ignored() || fail("字段类型错误: " + key_); }
+  bool boolean(bool) { return ignored() || fail("字段类型错误: " + key_); }
+  bool number_integer(json::number_integer_t value) { return number(value); }
+  bool number_unsigned(json::number_unsigned_t value) { return number(value); }
+  bool number_float(json::number_float_t value, const json::string_t&) {
+    if (ignored()) return true;
+    if (depth_ != 2 || field_ != Field::kGpa) return fail("字段类型错误: " + key_);
+    current_.gpa = value;
+    seen_ |= kSeenGpa;
+    return true;
+  }
+  bool binary(json::binary_t&) { return ignored() || fail("字段类型错误: " + key_); }
+
+  bool string(json::string_t& value) {
+    if (ignored()) return true;
+    if (depth_ == 2 && field_ == Field::kName) {
+      current_.name = value;
+      seen_ |= kSeenName;
+      return true;
+    }
+    if (depth_ == 3 && field_ == Field::kCourses) {
+      current_.add_course(value);
+      return true;
+    }
+    return fail("字段类型错误: " + key_);
+  }
+
+  bool start_object(std::size_t) {
+    if (enter_ignored()) return true;
+    if (depth_ != 1) return fail("期望学生对象");
+    ++depth_;
+    current_ = StudentT();
+    seen_ = 0;
+    field_ = Field::kOther;
+    return true;
+  }
+
+  bool key(json::string_t& name) {
+    if (skip_depth_ > 0) return true;
+    key_ = name;
+    if (name == "name") {
+      field_ = Field::kName;
+    } else if (name == "age") {
+      field_ = Field::kAge;
+    } else if (name == "gpa") {
+      field_ = Field::kGpa;
+    } else if (name == "courses") {
+      field_ = Field::kCourses;
+    } else {
+      field_ = Field::kOther;
+    }
+    return true;
+  }
+
+  bool end_object() {
+    if (skip_depth_ > 0) {
+      --skip_depth_;
+      return true;
+    }
+    --depth_;
+    if (seen_ != kSeenAll) return fail("学生记录缺少字段");
+    sink_(std::move(current_));
+    ++records_;
+    return true;
+  }
+
+  bool start_array(std::size_t) {
+    if (enter_ignored()) return true;
+    if (depth_ == 0 || (depth_ == 2 && field_ == Field::kCourses)) {
+      ++depth_;
+      return true;
+    }
+    return fail("意外的数组");
+  }
+
+  bool end_array() {
+    if (skip_depth_ > 0) {
+      --skip_depth_;
+      return true;
+    }
+    if (--depth_ == 2) seen_ |= kSeenCourses;
+    return true;
+  }
+
+  bool parse_error(std::size_t, const std::string&, const json::exception& ex) {
+    return fail(ex.what());
+  }
+
+ private:
+  enum class Field { kName, kAge, kGpa, kCourses, kOther };
+  static constexpr unsigned kSeenName = 1, kSeenAge = 2, kSeenGpa = 4, kSeenCourses = 8;
+  static constexpr unsigned kSeenAll = 15;
+
+  Sink sink_;
+  StudentT current_;
+  int depth_ = 0;       // 0: 顶层, 1: 学生数组, 2: 学生对象, 3: 课程数组
+  int skip_depth_ = 0;  // 正在跳过的未知字段的嵌套层数
+  Field field_ = Field::kOther;
+  std::string key_;
+  unsigned seen_ = 0;
+  size_t records_ = 0;
+  std::string error_;
+
+  // 未知字段的值 (及其内部) 直接忽略
+  bool ignored() const { return skip_depth_ > 0 || (depth_ == 2 && field_ == Field::kOther); }
+
+  bool enter_ignored() {
+    if (!ignored()) return false;
+    ++skip_depth_;
+    return true;
+  }
+
+  template <typename Integer>
+  bool number(Integer value) {
+    if (ignored()) return true;
+    if (depth_ != 2) return fail("意外的数字");
+    if (field_ == Field::kAge) {
+      current_.age = static_cast<int>(value);
+      seen_ |= kSeenAge;
+      return true;
+    }
+    if (field_ == Field::kGpa) {
+      current_.gpa = static_cast<double>(value);
+      seen_ |= kSeenGpa;
+      return true;
+    }
+    return fail("字段类型错误: " + key_);
+  }
+
+  bool fail(std::string message) {
+    if (error_.empty()) error_ = std::move(message);
+    return false;
+  }
+};
+
+// 从文件流式读取学生数组, 每条记录交给sink; 出错时抛出 std::runtime_error
+template <typename StudentT, typename Sink>
+size_t stream_students_from_file(const std::string& path, Sink sink) {
+  // sink 可能抛出异常, 文件由 unique_ptr 关闭
+  std::unique_ptr<std::FILE, decltype(&std::fclose)> file(std::fopen(path.c_str(), "rb"),
+                                                          &std::fclose);
+  if (file == nullptr) throw std::runtime_error("无法打开文件: " + path);
+  std::setvbuf(file.get(), nullptr, _IOFBF, size_t{1} << 20);
+
+  StudentSaxHandler<StudentT, Sink> handler(std::move(sink));
+  const bool ok = nlohmann::json::sax_parse(file.get(), &handler);
+  file.reset();
+  if (!ok) throw std::runtime_error(handler.error().empty() ? "JSON解析失败" : handler.error());
+  return handler.records();
+}
+
+#endif  // CPP_FEATURES_COMBINED_JSON_STREAM_H
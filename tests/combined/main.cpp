@@ -1,76 +1,264 @@
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <limits>
 #include <memory>
+#include <memory_resource>
 #include <random>
-#include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <fmt/color.h>
 #include <fmt/format.h>
 #include <nlohmann/json.hpp>
+#include <spdlog/async.h>
+#include <spdlog/details/null_mutex.h>
+#include <spdlog/sinks/base_sink.h>
 #include <spdlog/sinks/basic_file_sink.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/spdlog.h>
 
+#if defined(__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "alloc_tracker.h"
+#include "json_codec.h"
+#include "json_fields.h"
+#include "json_index.h"
+#include "json_stream.h"
+#include "memory_resources.h"
+#include "parallel_json.h"
+#include "small_containers.h"
+#include "student_snapshot.h"
+#include "student_store.h"
+#include "thread_pool.h"
+
 using json = nlohmann::json;
 
 // 数据模型类
-class Student {
+// 姓名/课程的字符串和列表类型可替换, 便于对比小缓冲优化(SBO)与标准容器
+template <typename String, typename CourseList>
+class BasicStudent {
  public:
-  std::string name;
+  String name;
   int age;
   double gpa;
-  std::vector<std::string> courses;
+  CourseList courses;
 
-  Student() : name(""), age(0), gpa(0.0) {}
-  Student(const std::string& n, int a, double g) : name(n), age(a), gpa(g) {}
+  BasicStudent() : name(""), age(0), gpa(0.0) {}
+  BasicStudent(std::string_view n, int a, double g) : name(n), age(a), gpa(g) {}
 
-  void add_course(const std::string& course) { courses.push_back(course); }
+  void add_course(std::string_view course) { courses.emplace_back(course); }
 };
 
-// JSON序列化支持
-void to_json(json& j, const Student& s) {
-  j = json{{"name", s.name}, {"age", s.age}, {"gpa", s.gpa}, {"courses", s.courses}};
-}
+// 姓名和课程名都在24字节内联缓冲区内 (std::string只有15字节SSO; 生成的姓名最长17字符,
+// 课程名最长16字符). 课程内联5门: DataGenerator 每人选3~7门, 五分之三的学生完全不分配堆,
+// 其余一次分配; 内联7门时 sizeof(Student) 从224涨到288字节, 全表扫描要多读三成内存,
+// 生成耗时却没有可测的差别
+using InlineString = cpp_features::SmallString<24>;
+using Student = BasicStudent<InlineString, cpp_features::small_vector<InlineString, 5>>;
+
+// 标准容器版本, 作为对比基准
+using StdStudent = BasicStudent<std::string, std::vector<std::string>>;
+
+// 让fmt/spdlog像std::string一样格式化SmallString
+template <size_t N>
+struct fmt::formatter<cpp_features::SmallString<N>> : fmt::formatter<fmt::string_view> {
+  template <typename FormatContext>
+  auto format(const cpp_features::SmallString<N>& s, FormatContext& ctx) const {
+    return fmt::formatter<fmt::string_view>::format(fmt::string_view(s.data(), s.size()), ctx);
+  }
+};
 
-void from_json(const json& j, Student& s) {
-  j.at("name").get_to(s.name);
-  j.at("age").get_to(s.age);
-  j.at("gpa").get_to(s.gpa);
-  j.at("courses").get_to(s.courses);
-}
+// pmr版本的学生: 姓名和课程列表都从同一个memory_resource分配
+struct PmrStudent {
+  using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
+  std::pmr::string name;
+  int age = 0;
+  double gpa = 0.0;
+  std::pmr::vector<std::pmr::string> courses;
+
+  explicit PmrStudent(allocator_type alloc = {}) : name(alloc), courses(alloc) {}
+  PmrStudent(std::string_view n, int a, double g, allocator_type alloc = {})
+      : name(n, alloc), age(a), gpa(g), courses(alloc) {}
+
+  // 容器复制/移动元素时传入自身的分配器 (uses-allocator construction)
+  PmrStudent(const PmrStudent& other, allocator_type alloc = {})
+      : name(other.name, alloc), age(other.age), gpa(other.gpa), courses(other.courses, alloc) {}
+  PmrStudent(PmrStudent&& other, allocator_type alloc)
+      : name(std::move(other.name), alloc),
+        age(other.age),
+        gpa(other.gpa),
+        courses(std::move(other.courses), alloc) {}
+  PmrStudent(PmrStudent&&) = default;
+  PmrStudent& operator=(const PmrStudent&) = default;
+  PmrStudent& operator=(PmrStudent&&) = default;
+
+  allocator_type get_allocator() const { return courses.get_allocator(); }
+};
 
-// 学生管理系统类
-class StudentManager {
- private:
-  std::vector<Student> students;
-  std::shared_ptr<spdlog::logger> logger;
+using PmrStudentList = std::pmr::vector<PmrStudent>;
+
+// JSON序列化支持: 由字段描述生成 to_json/from_json 和直接文本编解码 (json_fields.h)
+CPP_FEATURES_JSON_FIELDS(Student, name, age, gpa, courses)
+
+// 索引查询结果: 指向索引内部的连续行号, 不复制学生; 在下一次修改前有效
+struct RowSpan {
+  const uint32_t* first = nullptr;
+  const uint32_t* last = nullptr;
+  const uint32_t* begin() const { return first; }
+  const uint32_t* end() const { return last; }
+  size_t size() const { return static_cast<size_t>(last - first); }
+  bool empty() const { return first == last; }
+};
+
+// 以SmallString为键的哈希表 (姓名索引和课程索引共用). 查找时要先构造一个键,
+// 不超过 InlineString::inline_capacity() (23) 个字符时在内联缓冲内, 不需要堆分配
+struct SmallStringHash {
+  size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+};
+using NameIndex =
+    std::pmr::unordered_map<InlineString, std::pmr::vector<uint32_t>, SmallStringHash>;
+
+// 学生缓存文件的编码. 各格式往返耗时相差在测量误差以内 (demo_json_formats),
+// 选CBOR是因为体积约为文本的四分之三, 且是IETF标准 (RFC 8949), 其他语言都有现成的解码器
+constexpr cpp_features::JsonFormat kStudentCacheFormat = cpp_features::JsonFormat::kCbor;
 
+// 把记录转交给异步日志器的 sink: 只有文件写入交给后台线程
+class AsyncForwardSink : public spdlog::sinks::base_sink<spdlog::details::null_mutex> {
  public:
-  StudentManager() {
-    // 初始化日志系统
+  explicit AsyncForwardSink(std::shared_ptr<spdlog::async_logger> target)
+      : target_(std::move(target)) {}
+
+ protected:
+  void sink_it_(const spdlog::details::log_msg& msg) override {
+    target_->log(msg.time, msg.source, msg.level, msg.payload);
+  }
+  void flush_() override { target_->flush(); }
+
+ private:
+  std::shared_ptr<spdlog::async_logger> target_;
+};
+
+// 学生管理系统类
+// 所有 StudentManager 共用一个日志器. 控制台在调用线程上同步输出, 和 fmt::print 的
+// 顺序一致; student_system.log 经有界队列由spdlog的后台线程写入, 队列满时调用方等待
+// (block), 不丢任何记录. 警告及以上立即刷新, 其余由 flush_every 的刷新线程每秒刷新一次
+constexpr size_t kLogQueueSize = 8192;
+constexpr const char* kLogPattern = "[%Y-%m-%d %H:%M:%S] [%n] [%^%l%$] %v";
+
+std::shared_ptr<spdlog::logger> student_logger() {
+  static const std::shared_ptr<spdlog::logger> logger = [] {
+    std::vector<spdlog::sink_ptr> sinks{std::make_shared<spdlog::sinks::stdout_color_sink_mt>()};
     try {
-      auto console_sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
       auto file_sink =
           std::make_shared<spdlog::sinks::basic_file_sink_mt>("student_system.log", true);
+      if (spdlog::thread_pool() == nullptr) spdlog::init_thread_pool(kLogQueueSize, 1);
+      auto file_logger = std::make_shared<spdlog::async_logger>(
+          "StudentManager", file_sink, spdlog::thread_pool(), spdlog::async_overflow_policy::block);
+      file_logger->set_pattern(kLogPattern);
+      sinks.push_back(std::make_shared<AsyncForwardSink>(std::move(file_logger)));
+    } catch (const spdlog::spdlog_ex& ex) {
+      // 日志文件打不开时只写控制台
+      std::cout << "日志初始化失败: " << ex.what() << std::endl;
+    }
+    auto created = std::make_shared<spdlog::logger>("StudentManager", sinks.begin(), sinks.end());
+    spdlog::register_logger(created);
+    spdlog::flush_every(std::chrono::seconds(1));
+    created->set_level(spdlog::level::info);
+    created->set_pattern(kLogPattern);
+    created->flush_on(spdlog::level::warn);
+    return created;
+  }();
+  return logger;
+}
 
-      std::vector<spdlog::sink_ptr> sinks{console_sink, file_sink};
-      logger = std::make_shared<spdlog::logger>("StudentManager", sinks.begin(), sinks.end());
-
-      logger->set_level(spdlog::level::info);
-      logger->set_pattern("[%Y-%m-%d %H:%M:%S] [%n] [%^%l%$] %v");
+// 名册和全部索引都从构造时给定的 memory_resource 分配; Student 本身的姓名和课程是内联的
+class StudentManager {
+ private:
+  std::pmr::vector<Student> students;
+  std::shared_ptr<spdlog::logger> logger;
 
-      spdlog::register_logger(logger);
+  // 静默模式下 add_student 不逐条打印和记录, 退出时记录一条汇总
+  bool quiet = false;
+  size_t quiet_inserts = 0;
+
+  // 二级索引. GPA索引按(gpa, 行号)排序, 键和行号分两个数组存放, 二分查找只触碰键数组;
+  // add_student 只追加行, 下一次GPA区间查询时把新行排好序再归并进来 (O(n + k log k)),
+  // 逐条装载因此是线性的. 查询会更新索引, 所以 const 查询也不能和其他调用并发.
+  // 姓名和课程索引的每个列表按行号递增, 追加是均摊O(1), 随插入立即维护
+  mutable std::pmr::vector<double> gpa_keys;
+  mutable std::pmr::vector<uint32_t> gpa_rows;
+  NameIndex name_index;
+  NameIndex course_index;
+
+  void index_row(uint32_t row) {
+    const Student& student = students[row];
+    name_index[student.name].push_back(row);
+    for (const auto& course : student.courses) course_index[course].push_back(row);
+  }
 
-    } catch (const spdlog::spdlog_ex& ex) {
-      std::cout << "日志初始化失败: " << ex.what() << std::endl;
+  // gpa_rows 只覆盖前 gpa_rows.size() 行, 把之后追加的行归并进来
+  void refresh_gpa_index() const {
+    const size_t indexed = gpa_rows.size();
+    if (indexed == students.size()) return;
+    auto by_gpa = [this](uint32_t a, uint32_t b) {
+      return students[a].gpa < students[b].gpa || (students[a].gpa == students[b].gpa && a < b);
+    };
+    for (size_t row = indexed; row < students.size(); ++row) {
+      gpa_rows.push_back(static_cast<uint32_t>(row));
     }
+    const auto middle = gpa_rows.begin() + static_cast<std::ptrdiff_t>(indexed);
+    std::sort(middle, gpa_rows.end(), by_gpa);
+    std::inplace_merge(gpa_rows.begin(), middle, gpa_rows.end(), by_gpa);
+    gpa_keys.resize(students.size());
+    for (size_t i = 0; i < gpa_rows.size(); ++i) gpa_keys[i] = students[gpa_rows[i]].gpa;
+  }
+
+  void rebuild_indexes() {
+    gpa_rows.clear();
+    refresh_gpa_index();
+
+    name_index.clear();
+    course_index.clear();
+    for (uint32_t row = 0; row < students.size(); ++row) index_row(row);
+  }
+
+  static RowSpan lookup(const NameIndex& index, std::string_view key) {
+    auto it = index.find(InlineString(key));
+    if (it == index.end()) return {};
+    return {it->second.data(), it->second.data() + it->second.size()};
   }
 
+ public:
+  explicit StudentManager(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+      : students(resource),
+        logger(student_logger()),
+        gpa_keys(resource),
+        gpa_rows(resource),
+        name_index(resource),
+        course_index(resource) {}
+
   void add_student(const Student& student) {
     students.push_back(student);
+    index_row(static_cast<uint32_t>(students.size() - 1));
+
+    if (quiet) {
+      ++quiet_inserts;
+      return;
+    }
 
     logger->info("添加新学生: {}, 年龄: {}, GPA: {:.2f}", student.name, student.age, student.gpa);
 
@@ -78,6 +266,24 @@ class StudentManager {
     fmt::print(fg(fmt::color::green), "✅ 成功添加学生: {}\n", student.name);
   }
 
+  // 大批量逐条插入前打开, 结束后关闭
+  void set_quiet(bool enabled) {
+    if (quiet && !enabled && quiet_inserts > 0) {
+      logger->info("静默模式下添加 {} 名学生, 当前共 {} 名", quiet_inserts, students.size());
+    }
+    quiet = enabled;
+    quiet_inserts = 0;
+  }
+
+  // 批量导入: 只记录一条日志, 供基准测试装载大数据集
+  void add_students(std::vector<Student> batch) {
+    const size_t added = batch.size();
+    students.insert(students.end(), std::make_move_iterator(batch.begin()),
+                    std::make_move_iterator(batch.end()));
+    rebuild_indexes();
+    logger->info("批量添加 {} 名学生, 当前共 {} 名", added, students.size());
+  }
+
   std::vector<Student> find_students_by_gpa(double min_gpa) const {
     std::vector<Student> result;
 
@@ -92,17 +298,44 @@ class StudentManager {
     return result;
   }
 
-  void print_statistics() const {
-    if (students.empty()) {
-      fmt::print(fg(fmt::color::yellow), "⚠️  没有学生数据\n");
-      return;
-    }
+  // 索引查询: 返回行号, 用 student(row) 访问; 不写日志, 适合热路径
+  const Student& student(uint32_t row) const { return students[row]; }
+
+  // GPA在 [min_gpa, max_gpa) 内的学生, 按GPA升序
+  RowSpan find_rows_by_gpa(double min_gpa,
+                           double max_gpa = std::numeric_limits<double>::infinity()) const {
+    refresh_gpa_index();
+    auto lo = std::lower_bound(gpa_keys.begin(), gpa_keys.end(), min_gpa);
+    auto hi = std::lower_bound(lo, gpa_keys.end(), max_gpa);
+    const uint32_t* rows = gpa_rows.data();
+    return {rows + (lo - gpa_keys.begin()), rows + (hi - gpa_keys.begin())};
+  }
+
+  RowSpan find_rows_by_name(std::string_view name) const { return lookup(name_index, name); }
+
+  RowSpan find_rows_by_course(std::string_view course) const {
+    return lookup(course_index, course);
+  }
+
+  // 同时选了两门课的学生: 两个有序倒排列表求交集
+  std::vector<uint32_t> find_rows_by_courses(std::string_view a, std::string_view b) const {
+    RowSpan x = find_rows_by_course(a), y = find_rows_by_course(b);
+    std::vector<uint32_t> result;
+    result.reserve(std::min(x.size(), y.size()));
+    std::set_intersection(x.begin(), x.end(), y.begin(), y.end(), std::back_inserter(result));
+    return result;
+  }
+
+  // 行式统计: 每个学生整条记录(姓名、课程列表)都会被拉进缓存
+  StudentStats statistics() const {
+    StudentStats stats;
+    stats.count = students.size();
+    if (students.empty()) return stats;
 
-    // 计算统计信息
     double total_gpa = 0.0;
-    int total_age = 0;
-    double max_gpa = 0.0;
-    double min_gpa = 4.0;
+    long long total_age = 0;
+    double max_gpa = students.front().gpa;
+    double min_gpa = students.front().gpa;
 
     for (const auto& student : students) {
       total_gpa += student.gpa;
@@ -111,20 +344,33 @@ class StudentManager {
       min_gpa = std::min(min_gpa, student.gpa);
     }
 
-    double avg_gpa = total_gpa / students.size();
-    double avg_age = static_cast<double>(total_age) / students.size();
+    stats.avg_gpa = total_gpa / students.size();
+    stats.avg_age = static_cast<double>(total_age) / students.size();
+    stats.max_gpa = max_gpa;
+    stats.min_gpa = min_gpa;
+    return stats;
+  }
+
+  void print_statistics() const {
+    if (students.empty()) {
+      fmt::print(fg(fmt::color::yellow), "⚠️  没有学生数据\n");
+      return;
+    }
+
+    // 计算统计信息
+    const StudentStats stats = statistics();
 
     // 使用fmt格式化输出统计信息
     fmt::print("\n📊 学生统计信息\n");
     fmt::print("{}\n", std::string(40, '='));
-    fmt::print("总学生数: {}\n", students.size());
-    fmt::print("平均GPA: {:.2f}\n", avg_gpa);
-    fmt::print("最高GPA: {:.2f}\n", max_gpa);
-    fmt::print("最低GPA: {:.2f}\n", min_gpa);
-    fmt::print("平均年龄: {:.1f}\n", avg_age);
-
-    logger->info("统计信息 - 学生数: {}, 平均GPA: {:.2f}, 平均年龄: {:.1f}", students.size(),
-                 avg_gpa, avg_age);
+    fmt::print("总学生数: {}\n", stats.count);
+    fmt::print("平均GPA: {:.2f}\n", stats.avg_gpa);
+    fmt::print("最高GPA: {:.2f}\n", stats.max_gpa);
+    fmt::print("最低GPA: {:.2f}\n", stats.min_gpa);
+    fmt::print("平均年龄: {:.1f}\n", stats.avg_age);
+
+    logger->info("统计信息 - 学生数: {}, 平均GPA: {:.2f}, 平均年龄: {:.1f}", stats.count,
+                 stats.avg_gpa, stats.avg_age);
   }
 
   bool save_to_file(const std::string& filename) const {
@@ -167,6 +413,7 @@ class StudentManager {
         from_json(json_student, student);
         students.push_back(student);
       }
+      rebuild_indexes();
 
       logger->info("从文件加载了 {} 名学生: {}", students.size(), filename);
       fmt::print(fg(fmt::color::green), "✅ 从 {} 加载了 {} 名学生\n", filename, students.size());
@@ -174,6 +421,112 @@ class StudentManager {
       return true;
 
     } catch (const std::exception& e) {
+      rebuild_indexes();
+      logger->error("加载文件失败: {}", e.what());
+      fmt::print(fg(fmt::color::red), "❌ 加载失败: {}\n", e.what());
+
+      return false;
+    }
+  }
+
+  // 二进制缓存: kStudentCacheFormat 编码, 字段与 save_to_file 相同
+  bool save_cache(const std::string& filename) const {
+    try {
+      const auto bytes =
+          cpp_features::encode_json(json{{"students", students}}, kStudentCacheFormat);
+      std::ofstream file(filename, std::ios::binary);
+      file.write(reinterpret_cast<const char*>(bytes.data()),
+                 static_cast<std::streamsize>(bytes.size()));
+      if (!file) throw std::runtime_error("写入失败: " + filename);
+
+      logger->info("学生缓存已保存 ({}, {} 字节): {}",
+                   cpp_features::json_format_name(kStudentCacheFormat), bytes.size(), filename);
+      return true;
+
+    } catch (const std::exception& e) {
+      logger->error("保存缓存失败: {}", e.what());
+      return false;
+    }
+  }
+
+  bool load_cache(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+      logger->warn("缓存不存在: {}", filename);
+      return false;
+    }
+
+    try {
+      std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)),
+                                 std::istreambuf_iterator<char>());
+      const json j = cpp_features::decode_json<json>(bytes, kStudentCacheFormat);
+
+      students.clear();
+      for (const auto& json_student : j.at("students")) {
+        Student student;
+        from_json(json_student, student);
+        students.push_back(std::move(student));
+      }
+      rebuild_indexes();
+
+      logger->info("从缓存加载了 {} 名学生: {}", students.size(), filename);
+      return true;
+
+    } catch (const std::exception& e) {
+      students.clear();
+      rebuild_indexes();
+      logger->error("加载缓存失败: {}", e.what());
+      return false;
+    }
+  }
+
+  // 流式保存: 逐条写入带缓冲的文件, 不构建DOM, 额外内存与学生数无关
+  bool save_to_file_streaming(const std::string& filename) const {
+    try {
+      BufferedFileWriter out(filename);
+      out.write("[\n");
+      for (size_t i = 0; i < students.size(); ++i) {
+        if (i > 0) out.write(",\n");
+        write_student_json(out, students[i]);
+      }
+      out.write("\n]\n");
+      out.close();
+
+      logger->info("学生数据已流式保存到文件: {}", filename);
+      fmt::print(fg(fmt::color::green), "✅ 数据已流式保存到: {}\n", filename);
+
+      return true;
+
+    } catch (const std::exception& e) {
+      logger->error("保存文件失败: {}", e.what());
+      fmt::print(fg(fmt::color::red), "❌ 保存失败: {}\n", e.what());
+
+      return false;
+    }
+  }
+
+  // 流式加载: SAX事件直接填充Student, 不生成中间DOM
+  bool load_from_file_streaming(const std::string& filename) {
+    if (!std::ifstream(filename).is_open()) {
+      logger->warn("文件不存在: {}", filename);
+      fmt::print(fg(fmt::color::yellow), "⚠️  文件不存在: {}\n", filename);
+      return false;
+    }
+
+    try {
+      students.clear();
+      stream_students_from_file<Student>(
+          filename, [this](Student&& student) { students.push_back(std::move(student)); });
+      rebuild_indexes();
+
+      logger->info("从文件流式加载了 {} 名学生: {}", students.size(), filename);
+      fmt::print(fg(fmt::color::green), "✅ 从 {} 流式加载了 {} 名学生\n", filename,
+                 students.size());
+
+      return true;
+
+    } catch (const std::exception& e) {
+      rebuild_indexes();
       logger->error("加载文件失败: {}", e.what());
       fmt::print(fg(fmt::color::red), "❌ 加载失败: {}\n", e.what());
 
@@ -181,6 +534,27 @@ class StudentManager {
     }
   }
 
+  // 二进制快照: 先转成列式存储再整段写出, 读取端用 StudentSnapshot 直接mmap查询
+  bool save_snapshot(const std::string& filename) const {
+    try {
+      StudentStore store;
+      store.reserve(students.size());
+      for (const auto& student : students) store.append(student);
+      write_snapshot(filename, store);
+
+      logger->info("学生快照已保存到文件: {}", filename);
+      fmt::print(fg(fmt::color::green), "✅ 快照已保存到: {}\n", filename);
+
+      return true;
+
+    } catch (const std::exception& e) {
+      logger->error("保存快照失败: {}", e.what());
+      fmt::print(fg(fmt::color::red), "❌ 保存失败: {}\n", e.what());
+
+      return false;
+    }
+  }
+
   void print_student_list() const {
     if (students.empty()) {
       fmt::print(fg(fmt::color::yellow), "📋 学生列表为空\n");
@@ -243,9 +617,11 @@ class DataGenerator {
  public:
   DataGenerator() : gen(std::chrono::steady_clock::now().time_since_epoch().count()) {}
 
-  std::vector<Student> generate_students(size_t count) {
-    std::vector<Student> students;
-
+  // 逐个生成学生交给sink, 大规模测试可以不经过中间vector直接写入列式存储.
+  // make(name, age, gpa) 构造学生, 决定字符串/容器类型和分配器; 各版本共用同一套
+  // 随机数和课程去重, 对比时只有分配方式不同
+  template <typename StudentT = Student, typename Sink, typename Make>
+  void generate_each(size_t count, Sink&& sink, Make&& make) {
     std::uniform_int_distribution<size_t> first_name_dist(0, first_names.size() - 1);
     std::uniform_int_distribution<size_t> last_name_dist(0, last_names.size() - 1);
     std::uniform_int_distribution<> age_dist(18, 25);
@@ -253,28 +629,64 @@ class DataGenerator {
     std::uniform_int_distribution<> course_count_dist(3, 7);
     std::uniform_int_distribution<size_t> course_dist(0, course_list.size() - 1);
 
+    std::string name;
     for (size_t i = 0; i < count; ++i) {
-      std::string name = first_names[first_name_dist(gen)] + " " + last_names[last_name_dist(gen)];
+      name = first_names[first_name_dist(gen)];
+      name += ' ';
+      name += last_names[last_name_dist(gen)];
       int age = age_dist(gen);
       double gpa = gpa_dist(gen);
 
-      Student student(name, age, gpa);
+      StudentT student = make(std::string_view(name), age, gpa);
 
-      // 随机添加课程
+      // 随机添加课程: 用位掩码去重, 避免每个学生都分配std::set节点
       int num_courses = course_count_dist(gen);
-      std::set<int> selected_courses;
-
-      while (selected_courses.size() < num_courses) {
-        selected_courses.insert(course_dist(gen));
+      uint32_t selected_courses = 0;
+
+      for (int selected = 0; selected < num_courses;) {
+        const uint32_t bit = uint32_t{1} << course_dist(gen);
+        if (!(selected_courses & bit)) {
+          selected_courses |= bit;
+          ++selected;
+        }
       }
 
-      for (int course_idx : selected_courses) {
-        student.add_course(course_list[course_idx]);
+      for (size_t course_idx = 0; course_idx < course_list.size(); ++course_idx) {
+        if (selected_courses & (uint32_t{1} << course_idx)) {
+          student.courses.emplace_back(course_list[course_idx]);
+        }
       }
 
-      students.push_back(student);
+      sink(std::move(student));
     }
+  }
+
+  template <typename StudentT = Student, typename Sink>
+  void generate_each(size_t count, Sink&& sink) {
+    generate_each<StudentT>(count, std::forward<Sink>(sink),
+                            [](std::string_view name, int age, double gpa) {
+                              return StudentT(name, age, gpa);
+                            });
+  }
+
+  template <typename StudentT = Student>
+  std::vector<StudentT> generate_students(size_t count) {
+    std::vector<StudentT> students;
+    students.reserve(count);
+    generate_each<StudentT>(count,
+                            [&](StudentT&& student) { students.push_back(std::move(student)); });
+    return students;
+  }
 
+  // pmr版本: 名册、姓名和课程都从给定的memory_resource分配
+  PmrStudentList generate_students(size_t count, std::pmr::memory_resource* resource) {
+    PmrStudentList students(resource);
+    students.reserve(count);
+    generate_each<PmrStudent>(
+        count, [&](PmrStudent&& student) { students.push_back(std::move(student)); },
+        [resource](std::string_view name, int age, double gpa) {
+          return PmrStudent(name, age, gpa, resource);
+        });
     return students;
   }
 };
@@ -333,6 +745,17 @@ void demo_file_operations() {
 
   fmt::print("\n从文件加载后的数据:\n");
   new_manager.print_statistics();
+
+  // 二进制缓存往返
+  const std::string cache_file =
+      std::string("students.") + cpp_features::json_format_extension(kStudentCacheFormat);
+  StudentManager cached_manager;
+  if (manager.save_cache(cache_file) && cached_manager.load_cache(cache_file)) {
+    fmt::print(fg(fmt::color::green), "✅ {} 缓存往返: {} 名学生\n",
+               cpp_features::json_format_name(kStudentCacheFormat),
+               cached_manager.get_student_count());
+  }
+  std::remove(cache_file.c_str());
 }
 
 void demo_search_and_filter() {
@@ -371,10 +794,12 @@ void demo_search_and_filter() {
   }
 }
 
-void demo_performance_benchmark() {
+void demo_performance_benchmark(cpp_features::JsonFormat format) {
   fmt::print(fg(fmt::color::cyan), "\n⚡ 性能基准测试\n");
   fmt::print("{}\n", std::string(50, '='));
 
+  cpp_features::ThreadPool pool;
+
   std::vector<size_t> test_sizes = {1000, 5000, 10000, 50000};
 
   for (size_t size : test_sizes) {
@@ -393,18 +818,26 @@ void demo_performance_benchmark() {
     start = std::chrono::high_resolution_clock::now();
 
     StudentManager manager;
+    manager.set_quiet(true);
     for (const auto& student : students) {
       manager.add_student(student);
     }
+    manager.set_quiet(false);
 
     end = std::chrono::high_resolution_clock::now();
-    auto processing_time = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+    auto processing_time = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
 
-    // JSON序列化性能
+    // 序列化性能 (格式由 --format 选择). 文本格式不建DOM, 分块并行写出;
+    // 二进制格式经过DOM, BSON要求顶层为对象, 所以统一包一层
     start = std::chrono::high_resolution_clock::now();
 
-    json students_json = students;
-    std::string json_string = students_json.dump();
+    size_t encoded_bytes = 0;
+    if (format == cpp_features::JsonFormat::kText) {
+      encoded_bytes = total_bytes(serialize_array_chunks(students, pool));
+    } else {
+      json students_json = {{"students", students}};
+      encoded_bytes = cpp_features::encode_json(students_json, format).size();
+    }
 
     end = std::chrono::high_resolution_clock::now();
     auto serialization_time = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
@@ -418,13 +851,881 @@ void demo_performance_benchmark() {
     auto search_time = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
 
     fmt::print("  数据生成: {} ms\n", generation_time.count());
-    fmt::print("  数据处理: {} ms\n", processing_time.count());
-    fmt::print("  JSON序列化: {} ms ({:.1f} MB)\n", serialization_time.count(),
-               json_string.length() / (1024.0 * 1024.0));
+    fmt::print("  数据处理: {:.1f} ms ({:.0f} 次插入/秒)\n", processing_time.count() / 1000.0,
+               size * 1e6 / std::max<long long>(processing_time.count(), 1));
+    fmt::print("  {}序列化: {} ms ({:.1f} MB)\n", cpp_features::json_format_name(format),
+               serialization_time.count(), encoded_bytes / (1024.0 * 1024.0));
     fmt::print("  搜索操作: {} ms (找到{}名)\n", search_time.count(), high_gpa_students.size());
   }
 }
 
+void demo_memory_resources() {
+  fmt::print(fg(fmt::color::cyan), "\n🧠 内存资源(std::pmr)对比\n");
+  fmt::print("{}\n", std::string(50, '='));
+
+  // 分配密集路径: 生成学生 -> 复制进名册(模拟add_student) -> 按GPA筛选复制 -> 全部释放.
+  // 基准用 StdStudent, 和 PmrStudent 一样是 string + vector<string>, 生成算法也相同,
+  // 差别只在分配器
+  const size_t count = 50000;
+
+  auto run_default = [count] {
+    DataGenerator generator;
+    auto students = generator.generate_students<StdStudent>(count);
+    std::vector<StdStudent> roster;
+    for (const auto& student : students) roster.push_back(student);
+    std::vector<StdStudent> honors;
+    for (const auto& student : roster) {
+      if (student.gpa >= 3.5) honors.push_back(student);
+    }
+    return honors.size();
+  };
+
+  auto run_pmr = [count](std::pmr::memory_resource* resource) {
+    DataGenerator generator;
+    auto students = generator.generate_students(count, resource);
+    PmrStudentList roster(resource);
+    for (const auto& student : students) roster.push_back(student);
+    PmrStudentList honors(resource);
+    for (const auto& student : roster) {
+      if (student.gpa >= 3.5) honors.push_back(student);
+    }
+    return honors.size();
+  };
+
+  auto report = [](const char* name, const cpp_features::AllocScope& scope, size_t honors) {
+    auto stats = scope.stats();
+    fmt::print("  {:<28} {:>9.2f} ms", name, scope.elapsed_ms());
+    if (cpp_features::alloc_tracking::enabled()) {
+      fmt::print("  {:>8} 次operator new, 峰值 {:.1f} MB", stats.allocations,
+                 stats.peak_live_bytes / (1024.0 * 1024.0));
+    }
+    fmt::print("  (高GPA {} 名)\n", honors);
+  };
+
+  fmt::print("学生数: {}\n", count);
+  {
+    cpp_features::AllocScope scope;
+    size_t honors = run_default();
+    report("std::allocator", scope, honors);
+  }
+  {
+    cpp_features::AllocScope scope;
+    size_t honors = run_pmr(std::pmr::new_delete_resource());
+    report("pmr new_delete_resource", scope, honors);
+  }
+  {
+    cpp_features::AllocScope scope;
+    cpp_features::ArenaResource arena;
+    size_t honors = run_pmr(&arena);
+    report("ArenaResource", scope, honors);
+    fmt::print("    arena: 已用 {:.1f} MB / 保留 {:.1f} MB, 大页chunk {} 个\n",
+               arena.bytes_used() / (1024.0 * 1024.0), arena.bytes_reserved() / (1024.0 * 1024.0),
+               arena.huge_page_chunks());
+  }
+  {
+    cpp_features::AllocScope scope;
+    // 64字节块覆盖超出SSO的姓名/课程字符串
+    cpp_features::FixedPoolResource pool(64);
+    size_t honors = run_pmr(&pool);
+    report("FixedPoolResource(64)", scope, honors);
+    fmt::print("    pool: 池内分配 {} 次, 上游分配 {} 次\n", pool.pooled_allocations(),
+               pool.upstream_allocations());
+  }
+  {
+    cpp_features::AllocScope scope;
+    cpp_features::ThreadCachingResource caching;
+    size_t honors = run_pmr(&caching);
+    report("ThreadCachingResource", scope, honors);
+  }
+  {
+    cpp_features::AllocScope scope;
+    std::pmr::unsynchronized_pool_resource std_pool;
+    size_t honors = run_pmr(&std_pool);
+    report("std unsynchronized_pool", scope, honors);
+  }
+
+  // StudentManager 自身: 逐条 add_student 装入名册和索引, 再做一次GPA区间查询
+  fmt::print("StudentManager (名册 + 索引):\n");
+  DataGenerator generator;
+  const auto students = generator.generate_students(count);
+  auto run_manager = [&students](std::pmr::memory_resource* resource) {
+    StudentManager manager(resource);
+    manager.set_quiet(true);
+    for (const auto& student : students) manager.add_student(student);
+    manager.set_quiet(false);
+    return manager.find_rows_by_gpa(3.5).size();
+  };
+  {
+    cpp_features::AllocScope scope;
+    size_t honors = run_manager(std::pmr::get_default_resource());
+    report("default resource", scope, honors);
+  }
+  {
+    cpp_features::AllocScope scope;
+    cpp_features::ArenaResource arena;
+    size_t honors = run_manager(&arena);
+    report("ArenaResource", scope, honors);
+  }
+  {
+    cpp_features::AllocScope scope;
+    std::pmr::unsynchronized_pool_resource std_pool;
+    size_t honors = run_manager(&std_pool);
+    report("std unsynchronized_pool", scope, honors);
+  }
+}
+
+void demo_small_buffer_students() {
+  fmt::print(fg(fmt::color::cyan), "\n📦 小缓冲优化(SBO)对比\n");
+  fmt::print("{}\n", std::string(50, '='));
+
+  const size_t count = 50000;
+
+  fmt::print("sizeof(StdStudent) = {} 字节, sizeof(Student) = {} 字节\n", sizeof(StdStudent),
+             sizeof(Student));
+  fmt::print("内联容量: 字符串 {} 字符, 课程 {} 门\n", InlineString::inline_capacity(),
+             decltype(Student::courses)::inline_capacity());
+
+  auto run = [count](const char* name, auto generate) {
+    cpp_features::AllocScope scope;
+    DataGenerator generator;
+    auto students = generate(generator, count);
+    fmt::print("  {:<34} {:>8.2f} ms", name, scope.elapsed_ms());
+    if (cpp_features::alloc_tracking::enabled()) {
+      auto stats = scope.stats();
+      fmt::print("  {:>8} 次分配, 峰值 {:.1f} MB", stats.allocations,
+                 stats.peak_live_bytes / (1024.0 * 1024.0));
+    }
+    fmt::print("\n");
+    return students.size();
+  };
+
+  run("std::string + std::vector",
+      [](DataGenerator& g, size_t n) { return g.generate_students<StdStudent>(n); });
+  run("SmallString<24> + small_vector<5>",
+      [](DataGenerator& g, size_t n) { return g.generate_students<Student>(n); });
+
+  if (!cpp_features::alloc_tracking::enabled()) {
+    fmt::print("  (xmake f --alloc_tracking=y 可同时显示分配次数和峰值内存)\n");
+  }
+
+  // 边界情况: 满容量时追加自身元素, 超对齐元素扩容到堆上, 字符串赋值为自身的子串
+  cpp_features::small_vector<InlineString, 2> names{"Alice Johnson", "a name longer than 23 chars"};
+  names.push_back(names[0]);
+  names.push_back(names[1]);
+  struct alignas(64) Block {
+    double value;
+  };
+  cpp_features::small_vector<Block, 1> blocks;
+  for (int i = 0; i < 4; ++i) blocks.push_back(Block{static_cast<double>(i)});
+  InlineString text("a heap-allocated string of more than 23 characters");
+  text = text.view().substr(2, 30);
+  const bool edge_ok = names.size() == 4 && names[2] == names[0] && names[3] == names[1] &&
+                       reinterpret_cast<uintptr_t>(blocks.data()) % alignof(Block) == 0 &&
+                       blocks[3].value == 3.0 && text.view() == "heap-allocated string of more ";
+  fmt::print("  边界情况 (自引用追加/超对齐/自身子串赋值): {}\n", edge_ok ? "通过" : "失败");
+}
+
+// 列式存储对比: 默认测到1e6名学生, COMBINED_STORE_MAX_STUDENTS 可放大到1e8.
+// 行式版本每名学生占 sizeof(Student) 字节, 超过2 GB时只测列式存储
+void demo_columnar_store() {
+  fmt::print(fg(fmt::color::cyan), "\n🧱 列式存储 (SoA) vs 行式 StudentManager\n");
+  fmt::print("{}\n", std::string(50, '='));
+
+  size_t max_students = 1000000;
+  if (const char* env = std::getenv("COMBINED_STORE_MAX_STUDENTS")) {
+    max_students = std::max<size_t>(std::strtoull(env, nullptr, 10), 10000);
+  }
+  const size_t aos_budget_bytes = size_t{2} << 30;
+
+  auto time_ms = [](auto&& f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+        .count();
+  };
+
+  fmt::print("{:>10} | {:>9} {:>9} {:>7} | {:>9} {:>9} {:>7} | {:>9} {:>9}\n", "学生数",
+             "行统计ms", "列统计ms", "加速", "行过滤ms", "列过滤ms", "加速", "行MB", "列MB");
+
+  for (size_t n = 10000; n <= max_students; n *= 10) {
+    DataGenerator generator;
+    StudentStore store;
+    store.reserve(n);
+
+    const bool run_aos = n * sizeof(Student) <= aos_budget_bytes;
+    StudentManager manager;
+    if (run_aos) {
+      auto students = generator.generate_students(n);
+      for (const auto& student : students) store.append(student);
+      manager.add_students(std::move(students));
+    } else {
+      generator.generate_each(n, [&](Student&& student) { store.append(student); });
+    }
+
+    // 小规模重复多次, 保证每项至少扫描约1e7行
+    const size_t reps = std::max<size_t>(1, 10000000 / n);
+    StudentStats aos_stats, soa_stats;
+    double aos_stats_ms = 0.0;
+    if (run_aos) {
+      aos_stats_ms = time_ms([&] {
+        for (size_t r = 0; r < reps; ++r) aos_stats = manager.statistics();
+      }) / reps;
+    }
+    const double soa_stats_ms = time_ms([&] {
+      for (size_t r = 0; r < reps; ++r) soa_stats = store.statistics();
+    }) / reps;
+
+    size_t aos_hits = 0, soa_hits = 0;
+    double aos_filter_ms = 0.0;
+    if (run_aos) {
+      aos_filter_ms = time_ms([&] { aos_hits = manager.find_students_by_gpa(3.5).size(); });
+    }
+    const double soa_filter_ms =
+        time_ms([&] { soa_hits = store.filter_gpa_at_least(3.5).size(); });
+
+    const double store_mb = store.memory_bytes() / (1024.0 * 1024.0);
+    if (run_aos) {
+      const double aos_mb = n * sizeof(Student) / (1024.0 * 1024.0);
+      fmt::print("{:>10} | {:>9.3f} {:>9.3f} {:>6.1f}x | {:>9.3f} {:>9.3f} {:>6.1f}x | {:>9.1f} "
+                 "{:>9.1f}\n",
+                 n, aos_stats_ms, soa_stats_ms, aos_stats_ms / soa_stats_ms, aos_filter_ms,
+                 soa_filter_ms, aos_filter_ms / soa_filter_ms, aos_mb, store_mb);
+      const bool same = aos_hits == soa_hits && aos_stats.min_gpa == soa_stats.min_gpa &&
+                        aos_stats.max_gpa == soa_stats.max_gpa &&
+                        std::abs(aos_stats.avg_gpa - soa_stats.avg_gpa) < 1e-9 &&
+                        aos_stats.avg_age == soa_stats.avg_age;
+      if (!same) fmt::print(fg(fmt::color::red), "  ❌ 行式与列式结果不一致\n");
+    } else {
+      fmt::print("{:>10} | {:>9} {:>9.3f} {:>7} | {:>9} {:>9.3f} {:>7} | {:>9} {:>9.1f}\n", n,
+                 "-", soa_stats_ms, "", "-", soa_filter_ms, "", "-", store_mb);
+    }
+  }
+
+  fmt::print("行式过滤复制整条Student记录, 列式过滤只返回行号\n");
+}
+
+// 二级索引对比: 默认1e6名学生, COMBINED_INDEX_STUDENTS 可调整
+void demo_secondary_indexes() {
+  fmt::print(fg(fmt::color::cyan), "\n🗂️  二级索引 vs 线性扫描\n");
+  fmt::print("{}\n", std::string(50, '='));
+
+  size_t count = 1000000;
+  if (const char* env = std::getenv("COMBINED_INDEX_STUDENTS")) {
+    count = std::max<size_t>(std::strtoull(env, nullptr, 10), 1000);
+  }
+
+  auto time_us = [](size_t reps, auto&& f) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < reps; ++r) f();
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start)
+               .count() /
+           reps;
+  };
+
+  DataGenerator generator;
+  auto students = generator.generate_students(count);
+  StudentManager manager;
+  const double build_ms = time_us(1, [&] { manager.add_students(std::move(students)); }) / 1000.0;
+  fmt::print("{} 名学生, 装载并建立索引: {:.1f} ms\n", count, build_ms);
+
+  // 线性扫描, 只收集行号 (不复制), 作为比索引更公平的基准
+  auto scan = [&](auto&& predicate) {
+    std::vector<uint32_t> rows;
+    for (uint32_t row = 0; row < manager.get_student_count(); ++row) {
+      if (predicate(manager.student(row))) rows.push_back(row);
+    }
+    return rows;
+  };
+
+  const std::string name = std::string(manager.student(0).name);
+  const size_t scan_reps = 5, index_reps = 10000;
+  size_t scan_hits = 0, index_hits = 0;
+
+  fmt::print("{:<28} {:>12} {:>12} {:>10} {:>8}\n", "查询", "扫描 µs", "索引 µs", "加速", "结果");
+  auto report = [&](const char* query, double scan_us, double index_us) {
+    fmt::print("{:<28} {:>12.1f} {:>12.3f} {:>9.0f}x {:>8}", query, scan_us, index_us,
+               scan_us / index_us, index_hits);
+    if (scan_hits != index_hits) fmt::print(fg(fmt::color::red), "  ❌ 扫描得到 {}", scan_hits);
+    fmt::print("\n");
+  };
+
+  // 现有接口: 扫描并复制整条Student (每次调用还会写一条日志)
+  double copy_us =
+      time_us(scan_reps, [&] { scan_hits = manager.find_students_by_gpa(3.9).size(); });
+  double index_us = time_us(index_reps, [&] { index_hits = manager.find_rows_by_gpa(3.9).size(); });
+  report("gpa >= 3.9 (复制Student)", copy_us, index_us);
+
+  double scan_us = time_us(scan_reps, [&] {
+    scan_hits = scan([](const Student& s) { return s.gpa >= 3.9; }).size();
+  });
+  report("gpa >= 3.9 (行号)", scan_us, index_us);
+
+  scan_us = time_us(scan_reps, [&] {
+    scan_hits = scan([](const Student& s) { return s.gpa >= 3.0 && s.gpa < 3.01; }).size();
+  });
+  index_us = time_us(index_reps, [&] { index_hits = manager.find_rows_by_gpa(3.0, 3.01).size(); });
+  report("3.0 <= gpa < 3.01", scan_us, index_us);
+
+  scan_us = time_us(scan_reps, [&] {
+    scan_hits = scan([&](const Student& s) { return s.name.view() == name; }).size();
+  });
+  index_us = time_us(index_reps, [&] { index_hits = manager.find_rows_by_name(name).size(); });
+  report(("name == " + name).c_str(), scan_us, index_us);
+
+  auto takes = [](const Student& s, std::string_view course) {
+    return std::any_of(s.courses.begin(), s.courses.end(),
+                       [&](const InlineString& c) { return c.view() == course; });
+  };
+  scan_us = time_us(scan_reps, [&] {
+    scan_hits = scan([&](const Student& s) { return takes(s, "Physics"); }).size();
+  });
+  index_us =
+      time_us(index_reps, [&] { index_hits = manager.find_rows_by_course("Physics").size(); });
+  report("course == Physics", scan_us, index_us);
+
+  scan_us = time_us(scan_reps, [&] {
+    scan_hits =
+        scan([&](const Student& s) { return takes(s, "Physics") && takes(s, "Music"); }).size();
+  });
+  index_us = time_us(scan_reps, [&] {
+    index_hits = manager.find_rows_by_courses("Physics", "Music").size();
+  });
+  report("Physics 且 Music (交集)", scan_us, index_us);
+
+  // 逐条追加的行在下一次GPA查询时归并进索引
+  manager.set_quiet(true);
+  for (const auto& student : generator.generate_students(1000)) manager.add_student(student);
+  manager.set_quiet(false);
+  scan_hits = scan([](const Student& s) { return s.gpa >= 3.9; }).size();
+  index_hits = manager.find_rows_by_gpa(3.9).size();
+  const RowSpan sorted = manager.find_rows_by_gpa(0.0);
+  const bool ordered = std::is_sorted(sorted.begin(), sorted.end(), [&](uint32_t a, uint32_t b) {
+    return manager.student(a).gpa < manager.student(b).gpa;
+  });
+  fmt::print("追加1000名后 gpa >= 3.9: 索引 {} 名, 扫描 {} 名, 索引有序: {}\n", index_hits,
+             scan_hits, ordered);
+}
+
+// 流式JSON对比: DOM方式与流式方式的耗时和峰值堆内存.
+// 默认2e5名学生 (COMBINED_STREAM_STUDENTS), 同时测1/10规模以观察峰值是否随文件增长.
+// 流式的目标是内存而不是速度: 峰值不随文件增长, 加载耗时同样受JSON解析限制.
+// save_to_file 写带缩进的JSON, 流式写紧凑JSON, 文件大小不同, 所以吞吐按学生数计算
+void demo_streaming_json() {
+  fmt::print(fg(fmt::color::cyan), "\n🌊 流式JSON读写 vs DOM\n");
+  fmt::print("{}\n", std::string(50, '='));
+
+  size_t count = 200000;
+  if (const char* env = std::getenv("COMBINED_STREAM_STUDENTS")) {
+    count = std::max<size_t>(std::strtoull(env, nullptr, 10), 1000);
+  }
+  const std::string dom_file = "students_dom.json";
+  const std::string stream_file = "students_stream.json";
+
+  struct Row {
+    const char* op;
+    size_t students;
+    double ms;
+    size_t bytes;
+    size_t peak;
+  };
+  std::vector<Row> rows;
+
+  for (size_t n : {count / 10, count}) {
+    StudentManager manager;
+    DataGenerator generator;
+    manager.add_students(generator.generate_students(n));
+
+    auto measure = [&](const char* op, const std::string& file, auto&& action) {
+      cpp_features::AllocScope scope;
+      const bool ok = action();
+      const double ms = scope.elapsed_ms();
+      std::ifstream in(file, std::ios::binary | std::ios::ate);
+      rows.push_back({op, n, ok ? ms : 0.0, static_cast<size_t>(in.tellg()),
+                      scope.stats().peak_live_bytes});
+    };
+
+    measure("DOM 保存", dom_file, [&] { return manager.save_to_file(dom_file); });
+    measure("流式保存", stream_file, [&] { return manager.save_to_file_streaming(stream_file); });
+
+    StudentManager dom_loaded, stream_loaded;
+    measure("DOM 加载", dom_file, [&] { return dom_loaded.load_from_file(dom_file); });
+    measure("流式加载", stream_file,
+            [&] { return stream_loaded.load_from_file_streaming(stream_file); });
+  }
+
+  fmt::print("\n{:<10} {:>10} {:>10} {:>10} {:>12}", "操作", "学生数", "文件MB", "ms", "千学生/s");
+  const bool tracking = cpp_features::alloc_tracking::enabled();
+  if (tracking) fmt::print(" {:>12}", "峰值堆MB");
+  fmt::print("\n");
+  for (const Row& row : rows) {
+    const double mb = row.bytes / (1024.0 * 1024.0);
+    fmt::print("{:<10} {:>10} {:>10.1f} {:>10.1f} {:>12.1f}", row.op, row.students, mb, row.ms,
+               row.ms > 0 ? row.students / row.ms : 0.0);
+    if (tracking) fmt::print(" {:>12.1f}", row.peak / (1024.0 * 1024.0));
+    fmt::print("\n");
+  }
+  if (!tracking) fmt::print("(xmake f --alloc_tracking=y 可显示峰值堆内存)\n");
+  fmt::print("加载的峰值包含学生数据本身; DOM方式额外持有整棵json树和dump字符串\n");
+
+  std::remove(dom_file.c_str());
+  std::remove(stream_file.c_str());
+}
+
+// 进程当前RSS (Linux读 /proc/self/statm, 其他平台返回0)
+size_t current_rss_bytes() {
+#if defined(__linux__)
+  std::ifstream statm("/proc/self/statm");
+  size_t pages = 0, resident = 0;
+  statm >> pages >> resident;
+  return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#else
+  return 0;
+#endif
+}
+
+// 把文件从页缓存中逐出, 模拟冷启动 (只在Linux上有效)
+void evict_from_page_cache(const std::string& path) {
+#if defined(__linux__)
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) return;
+  ::fdatasync(fd);
+  ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+  ::close(fd);
+#else
+  (void)path;
+#endif
+}
+
+// 二进制快照 vs JSON: 冷加载时间和RSS增量. 默认1e6名学生, COMBINED_SNAPSHOT_STUDENTS
+// 可设为1e7; 超过1e6时JSON基准改用流式加载 (DOM方式需要的内存超出一般机器)
+void demo_binary_snapshot() {
+  fmt::print(fg(fmt::color::cyan), "\n💾 二进制快照 (mmap) vs JSON\n");
+  fmt::print("{}\n", std::string(50, '='));
+
+  size_t count = 1000000;
+  if (const char* env = std::getenv("COMBINED_SNAPSHOT_STUDENTS")) {
+    count = std::max<size_t>(std::strtoull(env, nullptr, 10), 1000);
+  }
+  const std::string snapshot_file = "students.snap";
+  const std::string json_file = "students_snapshot.json";
+
+  auto time_ms = [](auto&& f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+        .count();
+  };
+  auto mb = [](size_t bytes) { return bytes / (1024.0 * 1024.0); };
+
+  // 直接生成到列式存储再写快照, 不需要 count 个 Student 对象同时在内存里
+  {
+    StudentStore store;
+    store.reserve(count);
+    DataGenerator generator;
+    generator.generate_each(count, [&](Student&& student) { store.append(student); });
+    const double write_ms = time_ms([&] { write_snapshot(snapshot_file, store); });
+    fmt::print("{} 名学生, 写快照 {:.1f} ms\n", count, write_ms);
+  }
+  const double export_ms =
+      time_ms([&] { StudentSnapshot(snapshot_file).export_json(json_file); });
+  fmt::print("快照导出JSON {:.1f} ms\n", export_ms);
+
+  fmt::print("\n{:<24} {:>10} {:>12} {:>12}\n", "方式", "文件MB", "冷加载ms", "RSS增量MB");
+
+  // JSON: 解析后才能查询
+  {
+    const bool use_dom = count <= 1000000;
+    evict_from_page_cache(json_file);
+    const size_t rss_before = current_rss_bytes();
+    StudentManager manager;
+    StudentStats stats;
+    const double ms = time_ms([&] {
+      if (use_dom) {
+        manager.load_from_file(json_file);
+      } else {
+        manager.load_from_file_streaming(json_file);
+      }
+      stats = manager.statistics();
+    });
+    std::ifstream in(json_file, std::ios::binary | std::ios::ate);
+    fmt::print("{:<24} {:>10.1f} {:>12.1f} {:>12.1f}\n",
+               use_dom ? "JSON load_from_file" : "JSON 流式加载", mb(in.tellg()), ms,
+               mb(current_rss_bytes() - rss_before));
+  }
+
+  // 快照: mmap后直接查询; 分别统计打开、只读gpa/age列统计、随机访问姓名
+  {
+    evict_from_page_cache(snapshot_file);
+    const size_t rss_before = current_rss_bytes();
+    std::unique_ptr<StudentSnapshot> snap;
+    const double open_ms =
+        time_ms([&] { snap = std::make_unique<StudentSnapshot>(snapshot_file); });
+    const size_t rss_open = current_rss_bytes();
+    StudentStats stats;
+    const double stats_ms = time_ms([&] { stats = snap->statistics(); });
+    const size_t rss_stats = current_rss_bytes();
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<uint32_t> row_dist(0, static_cast<uint32_t>(snap->size() - 1));
+    size_t name_bytes = 0;
+    const double lookup_ms = time_ms([&] {
+      for (int i = 0; i < 1000; ++i) name_bytes += snap->name(row_dist(rng)).size();
+    });
+
+    fmt::print("{:<24} {:>10.1f} {:>12.3f} {:>12.1f}\n", "快照 mmap 打开", mb(snap->file_bytes()),
+               open_ms, mb(rss_open - rss_before));
+    fmt::print("{:<24} {:>10} {:>12.1f} {:>12.1f}\n", "  + gpa/age 统计", "", stats_ms,
+               mb(rss_stats - rss_before));
+    fmt::print("{:<24} {:>10} {:>12.1f} {:>12.1f}\n", "  + 1000次随机取姓名", "", lookup_ms,
+               mb(current_rss_bytes() - rss_before));
+    fmt::print("快照统计: 平均GPA {:.3f}, 平均年龄 {:.2f} ({} 字节姓名)\n", stats.avg_gpa,
+               stats.avg_age, name_bytes);
+  }
+
+  // 损坏的快照在打开时被拒绝, 不会在查询时越界
+  {
+    std::ifstream in(snapshot_file, std::ios::binary);
+    const std::string original((std::istreambuf_iterator<char>(in)),
+                               std::istreambuf_iterator<char>());
+    snapshot::Header header;
+    std::memcpy(&header, original.data(), sizeof(header));
+    auto patch = [&](uint64_t offset, auto value) {
+      std::string bytes = original;
+      std::memcpy(&bytes[offset], &value, sizeof(value));
+      return bytes;
+    };
+    const std::string corrupt[] = {
+        patch(offsetof(snapshot::Header, row_count), uint64_t{1} << 62),
+        patch(header.sections[snapshot::kNameOffsets].offset + sizeof(uint32_t), ~uint32_t{0}),
+        patch(header.sections[snapshot::kCourseIds].offset, uint16_t{0xffff}),
+    };
+    const std::string corrupt_file = "students_corrupt.snap";
+    for (const std::string& bytes : corrupt) {
+      std::ofstream out(corrupt_file, std::ios::binary);
+      out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+      out.close();
+      try {
+        StudentSnapshot snap(corrupt_file);
+        fmt::print(fg(fmt::color::red), "  ❌ 损坏的快照被接受\n");
+      } catch (const std::runtime_error& e) {
+        fmt::print("损坏快照被拒绝: {}\n", e.what());
+      }
+    }
+    std::remove(corrupt_file.c_str());
+  }
+
+  std::remove(snapshot_file.c_str());
+  std::remove(json_file.c_str());
+}
+
+// 大数组序列化: DOM (json students_json = students; dump()) 与分块并行直接写出对比,
+// 后者按块写入各自的缓冲区再用writev提交. 规模50k/1M/10M,
+// 默认只跑到1M (COMBINED_PARALLEL_MAX_STUDENTS=10000000 测1e7, 需要约4.5 GB内存)
+void demo_parallel_serialization() {
+  fmt::print(fg(fmt::color::cyan), "\n🧵 并行分块JSON序列化\n");
+  fmt::print("{}\n", std::string(50, '='));
+
+  size_t max_students = 1000000;
+  if (const char* env = std::getenv("COMBINED_PARALLEL_MAX_STUDENTS")) {
+    max_students = std::strtoull(env, nullptr, 10);
+  }
+
+  cpp_features::ThreadPool pool;
+  cpp_features::ThreadPool single(1);
+  fmt::print("线程池: {} 个线程\n", pool.size());
+  fmt::print("  {:>10} {:>10} {:>12} {:>12} {:>8}\n", "学生数", "DOM ms", "分块单线程", "分块并行",
+             "加速");
+
+  const std::string filename = "students_parallel.json";
+  auto time_ms = [](auto&& f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+        .count();
+  };
+
+  for (size_t count : {size_t{50000}, size_t{1000000}, size_t{10000000}}) {
+    if (count > max_students) break;
+    std::vector<Student> students;
+    students.reserve(count);
+    DataGenerator generator;
+    generator.generate_each(count,
+                            [&](Student&& student) { students.push_back(std::move(student)); });
+
+    // 1e7时DOM需要十几GB, 只在1e6及以下测
+    double dom_ms = 0.0;
+    if (count <= 1000000) {
+      dom_ms = time_ms([&] {
+        json students_json = students;
+        const std::string text = students_json.dump();
+        std::ofstream(filename, std::ios::binary).write(text.data(),
+                                                        static_cast<std::streamsize>(text.size()));
+      });
+    }
+
+    size_t single_bytes = 0;
+    const double single_ms = time_ms([&] {
+      const auto chunks = serialize_array_chunks(students, single);
+      write_chunks(filename, chunks);
+      single_bytes = total_bytes(chunks);
+    });
+
+    size_t parallel_bytes = 0;
+    const double parallel_ms = time_ms([&] {
+      const auto chunks = serialize_array_chunks(students, pool);
+      write_chunks(filename, chunks);
+      parallel_bytes = total_bytes(chunks);
+    });
+
+    if (dom_ms > 0.0) {
+      fmt::print("  {:>10} {:>10.1f} {:>12.1f} {:>12.1f} {:>7.1f}x\n", count, dom_ms, single_ms,
+                 parallel_ms, dom_ms / parallel_ms);
+    } else {
+      fmt::print("  {:>10} {:>10} {:>12.1f} {:>12.1f} {:>8}\n", count, "-", single_ms,
+                 parallel_ms, "-");
+    }
+
+    // 分块结果应是合法且完整的JSON数组
+    if (single_bytes != parallel_bytes) {
+      fmt::print(fg(fmt::color::red), "  ❌ 单线程与并行输出大小不一致\n");
+    } else if (count <= 50000) {
+      std::ifstream in(filename);
+      if (json::parse(in).size() != count) {
+        fmt::print(fg(fmt::color::red), "  ❌ 分块输出解析后记录数不符\n");
+      }
+    }
+  }
+  std::remove(filename.c_str());
+}
+
+// Student数据集在各编码格式下的完整缓存路径:
+// 编码 = Student -> json -> 字节, 解码 = 字节 -> json -> Student
+void demo_json_formats() {
+  fmt::print(fg(fmt::color::cyan), "\n📦 JSON编码格式对比 (Student)\n");
+  fmt::print("{}\n", std::string(50, '='));
+
+  const size_t count = 50000;
+  DataGenerator generator;
+  const auto students = generator.generate_students(count);
+
+  // 三次取最快
+  auto time_ms = [](auto&& f) {
+    double best = 0.0;
+    for (int run = 0; run < 3; ++run) {
+      auto start = std::chrono::steady_clock::now();
+      f();
+      const double ms =
+          std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+              .count();
+      if (run == 0 || ms < best) best = ms;
+    }
+    return best;
+  };
+
+  fmt::print("{} 名学生\n", count);
+  fmt::print("{:<10} {:>10} {:>8} {:>10} {:>10} {:>10}\n", "格式", "KB", "相对", "编码ms",
+             "解码ms", "合计ms");
+
+  size_t text_bytes = 0;
+  double best_ms = 0.0;
+  auto best = cpp_features::JsonFormat::kText;
+  for (auto format : cpp_features::kAllJsonFormats) {
+    std::vector<uint8_t> bytes;
+    std::vector<Student> decoded;
+    const double encode_ms = time_ms([&] {
+      bytes = cpp_features::encode_json(json{{"students", students}}, format);
+    });
+    const double decode_ms = time_ms([&] {
+      const json j = cpp_features::decode_json<json>(bytes, format);
+      decoded.clear();
+      decoded.reserve(j.at("students").size());
+      for (const auto& item : j.at("students")) {
+        Student student;
+        from_json(item, student);
+        decoded.push_back(std::move(student));
+      }
+    });
+    if (format == cpp_features::JsonFormat::kText) text_bytes = bytes.size();
+
+    fmt::print("{:<10} {:>10.1f} {:>7.2f}x {:>10.1f} {:>10.1f} {:>10.1f}",
+               cpp_features::json_format_name(format), bytes.size() / 1024.0,
+               static_cast<double>(bytes.size()) / text_bytes, encode_ms, decode_ms,
+               encode_ms + decode_ms);
+    const bool same = std::equal(
+        decoded.begin(), decoded.end(), students.begin(), students.end(),
+        [](const Student& a, const Student& b) {
+          return a.name == b.name && a.age == b.age && a.gpa == b.gpa && a.courses == b.courses;
+        });
+    if (!same) fmt::print(fg(fmt::color::red), "  ❌ 往返不一致");
+    fmt::print("\n");
+
+    if (best_ms == 0.0 || encode_ms + decode_ms < best_ms) {
+      best_ms = encode_ms + decode_ms;
+      best = format;
+    }
+  }
+  fmt::print("本次最快: {}, 缓存文件使用: {}\n", cpp_features::json_format_name(best),
+             cpp_features::json_format_name(kStudentCacheFormat));
+}
+
+// 字段描述生成的编解码: DOM路径 (json(students).dump() / json::parse + get) 与
+// 直接写入输出缓冲、完美哈希分派键的文本路径对比. 默认1e6名学生 (COMBINED_CODEC_STUDENTS)
+void demo_generated_codec() {
+  fmt::print(fg(fmt::color::cyan), "\n🧬 字段描述生成的JSON编解码\n");
+  fmt::print("{}\n", std::string(50, '='));
+
+  size_t count = 1000000;
+  if (const char* env = std::getenv("COMBINED_CODEC_STUDENTS")) {
+    count = std::max<size_t>(std::strtoull(env, nullptr, 10), 1);
+  }
+  DataGenerator generator;
+  const auto students = generator.generate_students(count);
+
+  auto time_ms = [](auto&& f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+        .count();
+  };
+
+  std::string dom_text;
+  std::string direct_text;
+  const double dom_encode = time_ms([&] { dom_text = json(students).dump(); });
+  const double direct_encode = time_ms([&] {
+    direct_text.reserve(dom_text.size());
+    cpp_features::append_json(direct_text, students);
+  });
+
+  std::vector<Student> dom_decoded;
+  std::vector<Student> direct_decoded;
+  const double dom_decode =
+      time_ms([&] { dom_decoded = json::parse(dom_text).get<std::vector<Student>>(); });
+  const double direct_decode = time_ms([&] {
+    direct_decoded.reserve(count);
+    cpp_features::read_json_text(direct_text, direct_decoded);
+  });
+
+  const double mb = direct_text.size() / (1024.0 * 1024.0);
+  fmt::print("{} 名学生, {:.1f} MB\n", count, mb);
+  fmt::print("  {:<24} {:>10} {:>10} {:>8}\n", "", "DOM ms", "直接 ms", "加速");
+  fmt::print("  {:<24} {:>10.1f} {:>10.1f} {:>7.1f}x\n", "编码", dom_encode, direct_encode,
+             dom_encode / direct_encode);
+  fmt::print("  {:<24} {:>10.1f} {:>10.1f} {:>7.1f}x\n", "解码", dom_decode, direct_decode,
+             dom_decode / direct_decode);
+  fmt::print("  直接路径: 编码 {:.0f} MB/s, 解码 {:.0f} MB/s\n", mb / direct_encode * 1000.0,
+             mb / direct_decode * 1000.0);
+
+  // 两条路径解码结果应与原数据一致 (DOM的键按字母序输出, 文本不同但等价)
+  auto same = [&](const std::vector<Student>& decoded) {
+    return decoded.size() == students.size() &&
+           std::equal(decoded.begin(), decoded.end(), students.begin(),
+                      [](const Student& a, const Student& b) {
+                        return a.name == b.name && a.age == b.age && a.gpa == b.gpa &&
+                               a.courses.size() == b.courses.size() &&
+                               std::equal(a.courses.begin(), a.courses.end(), b.courses.begin());
+                      });
+  };
+  if (same(dom_decoded) && same(direct_decoded)) {
+    fmt::print(fg(fmt::color::green), "  ✅ 两条路径往返结果一致\n");
+  } else {
+    fmt::print(fg(fmt::color::red), "  ❌ 往返结果不一致\n");
+  }
+}
+
+// 结构索引 + 按需读取 vs json::parse. 默认生成64 MB的学生JSON, COMBINED_JSON_MB=500
+// 测500 MB; DOM基准在文件超过128 MB时跳过 (json树约为文本的10倍内存)
+void demo_simd_json_parse() {
+  fmt::print(fg(fmt::color::cyan), "\n⚡ SIMD结构索引JSON解析 vs json::parse\n");
+  fmt::print("{}\n", std::string(50, '='));
+
+  size_t target_mb = 64;
+  if (const char* env = std::getenv("COMBINED_JSON_MB")) {
+    target_mb = std::max<size_t>(std::strtoull(env, nullptr, 10), 1);
+  }
+  const std::string filename = "students_large.json";
+
+  // 流式写出, 不需要把所有学生放在内存里
+  size_t written = 0;
+  {
+    BufferedFileWriter out(filename);
+    DataGenerator generator;
+    out.write("[\n");
+    bool first = true;
+    while (out.bytes_written() < target_mb * 1024 * 1024) {
+      generator.generate_each(10000, [&](Student&& student) {
+        if (!first) out.write(",\n");
+        first = false;
+        write_student_json(out, student);
+        ++written;
+      });
+    }
+    out.write("\n]\n");
+    out.close();
+  }
+
+  std::string text;
+  {
+    std::ifstream in(filename, std::ios::binary | std::ios::ate);
+    text.resize(static_cast<size_t>(in.tellg()));
+    in.seekg(0);
+    in.read(&text[0], static_cast<std::streamsize>(text.size()));
+  }
+  std::remove(filename.c_str());
+  const double gb = text.size() / (1024.0 * 1024.0 * 1024.0);
+  fmt::print("{} 名学生, {:.1f} MB\n", written, text.size() / (1024.0 * 1024.0));
+
+  auto time_s = [](auto&& f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  };
+  auto report = [&](const char* what, double seconds) {
+    fmt::print("  {:<32} {:>9.1f} ms {:>8.2f} GB/s\n", what, seconds * 1000.0, gb / seconds);
+  };
+
+  size_t dom_records = 0;
+  if (text.size() <= (size_t{128} << 20)) {
+    json doc;
+    report("json::parse (DOM)", time_s([&] { doc = json::parse(text); }));
+    std::vector<Student> students;
+    report("json::parse + from_json", time_s([&] {
+             doc = json::parse(text);
+             students.reserve(doc.size());
+             for (const auto& item : doc) students.push_back(item.get<Student>());
+           }));
+    dom_records = students.size();
+  } else {
+    fmt::print("  json::parse (DOM)                 跳过 (文件超过128 MB)\n");
+  }
+
+  std::vector<uint32_t> index;
+  report("第一阶段 结构索引 (标量)", time_s([&] { index = json_index::build_index_scalar(text); }));
+  index = {};  // 先释放, 避免两份索引同时驻留
+  report("第一阶段 结构索引 (SIMD)", time_s([&] { index = json_index::build_index_simd(text); }));
+  fmt::print("  {} 个结构字符, 索引 {:.1f} MB\n", index.size(),
+             index.size() * sizeof(uint32_t) / (1024.0 * 1024.0));
+
+  std::vector<Student> students;
+  students.reserve(written);
+  const double stage2 = time_s([&] {
+    json_index::parse_students<Student>(
+        text, index, [&](Student&& student) { students.push_back(std::move(student)); });
+  });
+  report("第二阶段 按需读取 -> Student", stage2);
+
+  students.clear();
+  index = {};
+  report("两阶段合计", time_s([&] {
+           index = json_index::build_index_simd(text);
+           json_index::parse_students<Student>(
+               text, index, [&](Student&& student) { students.push_back(std::move(student)); });
+         }));
+
+  if (students.size() != written || (dom_records != 0 && dom_records != written)) {
+    fmt::print(fg(fmt::color::red), "  ❌ 记录数不一致: {} / {}\n", students.size(), written);
+  }
+}
+
 void demo_error_handling() {
   fmt::print(fg(fmt::color::cyan), "\n⚠️  错误处理演示\n");
   fmt::print("{}\n", std::string(50, '='));
@@ -452,7 +1753,8 @@ void demo_error_handling() {
   manager.print_statistics();
 }
 
-int main() {
+// 用法: combined_example [--format=text|cbor|msgpack|ubjson|bson]
+int main(int argc, char** argv) {
   fmt::print(fg(fmt::color::magenta), "🚀 多库集成演示 - 学生管理系统\n");
   fmt::print(fg(fmt::color::magenta), "=====================================\n");
 
@@ -462,10 +1764,22 @@ int main() {
   fmt::print("  • {} - JSON解析和序列化\n", fmt::format(fg(fmt::color::yellow), "nlohmann/json"));
 
   try {
+    const auto format = cpp_features::json_format_from_args(argc, argv);
+
     demo_basic_operations();
     demo_file_operations();
     demo_search_and_filter();
-    demo_performance_benchmark();
+    demo_performance_benchmark(format);
+    demo_memory_resources();
+    demo_small_buffer_students();
+    demo_columnar_store();
+    demo_secondary_indexes();
+    demo_streaming_json();
+    demo_binary_snapshot();
+    demo_json_formats();
+    demo_parallel_serialization();
+    demo_generated_codec();
+    demo_simd_json_parse();
     demo_error_handling();
 
     fmt::print(fg(fmt::color::green), "\n✅ 多库集成演示完成!\n");
@@ -478,8 +1792,11 @@ int main() {
 
   } catch (const std::exception& e) {
     fmt::print(fg(fmt::color::red), "❌ 错误: {}\n", e.what());
+    spdlog::shutdown();
     return 1;
   }
 
+  // 等异步日志队列写完再退出
+  spdlog::shutdown();
   return 0;
 }
\ No newline at end of file
@@ -0,0 +1,104 @@
+#ifndef CPP_FEATURES_COMBINED_PARALLEL_JSON_H
+#define CPP_FEATURES_COMBINED_PARALLEL_JSON_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "json_fields.h"
+#include "thread_pool.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#define COMBINED_PARALLEL_JSON_WRITEV 1
+#endif
+
+// 大数组的并行JSON序列化: 按块切分, 每块在线程池上直接写入自己的缓冲区
+// (不经过DOM), 按顺序拼接后就是完整的JSON数组. 写文件时用writev一次提交所有块,
+// 不再复制到一个大字符串里.
+
+// 元素必须有 CPP_FEATURES_JSON_FIELDS 描述 (或能被 append_json 写出)
+template <typename T>
+std::vector<std::string> serialize_array_chunks(const std::vector<T>& items,
+                                                cpp_features::ThreadPool& pool,
+                                                size_t chunk_items = 16384) {
+  if (items.empty()) return {"[]\n"};
+  chunk_items = std::max<size_t>(chunk_items, 1);
+  const size_t chunk_count = (items.size() + chunk_items - 1) / chunk_items;
+
+  // 用第一条记录估计每块的大小, 避免块缓冲区反复扩容
+  const size_t estimate = cpp_features::to_json_text(items.front()).size() + 2;
+
+  std::vector<std::string> chunks(chunk_count);
+  pool.parallel_for(chunk_count, [&](size_t chunk) {
+    const size_t first = chunk * chunk_items;
+    const size_t last = std::min(first + chunk_items, items.size());
+    std::string& out = chunks[chunk];
+    out.reserve((last - first) * estimate * 5 / 4 + 4);
+    for (size_t i = first; i < last; ++i) {
+      out += i == 0 ? "[\n" : ",\n";
+      cpp_features::append_json(out, items[i]);
+    }
+    if (last == items.size()) out += "\n]\n";
+  });
+  return chunks;
+}
+
+inline size_t total_bytes(const std::vector<std::string>& chunks) {
+  size_t bytes = 0;
+  for (const auto& chunk : chunks) bytes += chunk.size();
+  return bytes;
+}
+
+// 按顺序写出所有块. POSIX上用writev, 每次最多IOV_MAX块, 处理部分写入;
+// 出错抛出 std::runtime_error
+inline void write_chunks(const std::string& path, const std::vector<std::string>& chunks) {
+#if defined(COMBINED_PARALLEL_JSON_WRITEV)
+  const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) throw std::runtime_error("无法打开文件: " + path);
+
+  std::vector<iovec> iov;
+  iov.reserve(chunks.size());
+  for (const auto& chunk : chunks) {
+    if (!chunk.empty()) iov.push_back({const_cast<char*>(chunk.data()), chunk.size()});
+  }
+
+  size_t next = 0;
+  while (next < iov.size()) {
+    const int batch = static_cast<int>(std::min<size_t>(iov.size() - next, IOV_MAX));
+    ssize_t written = ::writev(fd, iov.data() + next, batch);
+    if (written < 0) {
+      ::close(fd);
+      throw std::runtime_error("写入文件失败: " + path);
+    }
+    // 跳过已完整写出的块, 部分写出的块调整起点后重试
+    while (next < iov.size() && static_cast<size_t>(written) >= iov[next].iov_len) {
+      written -= static_cast<ssize_t>(iov[next].iov_len);
+      ++next;
+    }
+    if (written > 0) {
+      iov[next].iov_base = static_cast<char*>(iov[next].iov_base) + written;
+      iov[next].iov_len -= static_cast<size_t>(written);
+    }
+  }
+  if (::close(fd) != 0) throw std::runtime_error("关闭文件失败: " + path);
+#else
+  std::FILE* file = std::fopen(path.c_str(), "wb");
+  if (file == nullptr) throw std::runtime_error("无法打开文件: " + path);
+  for (const auto& chunk : chunks) {
+    if (std::fwrite(chunk.data(), 1, chunk.size(), file) != chunk.size()) {
+      std::fclose(file);
+      throw std::runtime_error("写入文件失败: " + path);
+    }
+  }
+  if (std::fclose(file) != 0) throw std::runtime_error("关闭文件失败: " + path);
+#endif
+}
+
+#endif  // CPP_FEATURES_COMBINED_PARALLEL_JSON_H
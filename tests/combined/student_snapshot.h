@@ -0,0 +1,324 @@
+#ifndef CPP_FEATURES_COMBINED_STUDENT_SNAPSHOT_H
+#define CPP_FEATURES_COMBINED_STUDENT_SNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "json_stream.h"
+#include "student_store.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define COMBINED_SNAPSHOT_MMAP 1
+#endif
+
+// 二进制学生快照: 与 StudentStore 相同的列式布局直接落盘, 打开时mmap整个文件,
+// 不解析、不复制, 查询按需触发缺页. 布局 (全部小端, 各段8字节对齐):
+//
+//   SnapshotHeader  magic "STUSNAP\0", version, 行数, 课程数, 段表{offset, bytes}
+//   gpa             double[rows]
+//   age             uint8[rows]
+//   name_offsets    uint32[rows + 1]   name(i) = name_heap[offsets[i], offsets[i+1])
+//   name_heap       char[]
+//   course_offsets  uint32[rows + 1]   CSR: courses(i) = course_ids[offsets[i], offsets[i+1])
+//   course_ids      uint16[]
+//   dict_offsets    uint32[courses + 1]
+//   dict_heap       char[]             课程名字典
+namespace snapshot {
+
+constexpr char kMagic[8] = {'S', 'T', 'U', 'S', 'N', 'A', 'P', '\0'};
+constexpr uint32_t kVersion = 1;
+
+enum Section : uint32_t {
+  kGpa,
+  kAge,
+  kNameOffsets,
+  kNameHeap,
+  kCourseOffsets,
+  kCourseIds,
+  kDictOffsets,
+  kDictHeap,
+  kSectionCount
+};
+
+struct SectionEntry {
+  uint64_t offset;
+  uint64_t bytes;
+};
+
+struct Header {
+  char magic[8];
+  uint32_t version;
+  uint32_t section_count;
+  uint64_t row_count;
+  uint64_t course_count;
+  SectionEntry sections[kSectionCount];
+};
+static_assert(std::is_trivially_copyable<Header>::value && sizeof(Header) == 160,
+              "snapshot header layout must be stable");
+
+// 列直接按内存表示写出, 所以只支持小端主机
+inline bool host_is_little_endian() {
+  const uint16_t probe = 1;
+  unsigned char first;
+  std::memcpy(&first, &probe, 1);
+  return first == 1;
+}
+
+inline uint64_t align8(uint64_t value) { return (value + 7) & ~uint64_t{7}; }
+
+}  // namespace snapshot
+
+// 把列式存储写成快照文件; 出错抛出 std::runtime_error
+inline void write_snapshot(const std::string& path, const StudentStore& store) {
+  using namespace snapshot;
+  if (!host_is_little_endian()) throw std::runtime_error("快照格式需要小端主机");
+
+  // 课程名字典展开为 偏移 + 字符堆
+  std::vector<uint32_t> dict_offsets{0};
+  std::string dict_heap;
+  for (const auto& course : store.course_names()) {
+    dict_heap += course;
+    dict_offsets.push_back(static_cast<uint32_t>(dict_heap.size()));
+  }
+
+  const void* data[kSectionCount] = {store.gpa_column().data(),     store.age_column().data(),
+                                     store.name_offsets().data(),   store.name_pool().data(),
+                                     store.course_offsets().data(), store.course_id_column().data(),
+                                     dict_offsets.data(),           dict_heap.data()};
+  const uint64_t bytes[kSectionCount] = {
+      store.gpa_column().size() * sizeof(double),
+      store.age_column().size(),
+      store.name_offsets().size() * sizeof(uint32_t),
+      store.name_pool().size(),
+      store.course_offsets().size() * sizeof(uint32_t),
+      store.course_id_column().size() * sizeof(StudentStore::CourseId),
+      dict_offsets.size() * sizeof(uint32_t),
+      dict_heap.size()};
+
+  Header header{};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.section_count = kSectionCount;
+  header.row_count = store.size();
+  header.course_count = store.course_count();
+  uint64_t offset = align8(sizeof(Header));
+  for (uint32_t i = 0; i < kSectionCount; ++i) {
+    header.sections[i] = {offset, bytes[i]};
+    offset = align8(offset + bytes[i]);
+  }
+
+  BufferedFileWriter out(path);
+  const char padding[8] = {};
+  out.write(std::string_view(reinterpret_cast<const char*>(&header), sizeof(header)));
+  uint64_t written = sizeof(header);
+  for (uint32_t i = 0; i < kSectionCount; ++i) {
+    out.write(std::string_view(padding, header.sections[i].offset - written));
+    out.write(std::string_view(static_cast<const char*>(data[i]), bytes[i]));
+    written = header.sections[i].offset + bytes[i];
+  }
+  out.write(std::string_view(padding, align8(written) - written));
+  out.close();
+}
+
+// 只读快照视图. POSIX上mmap整个文件, 其他平台读入内存; 构造时校验头部、段表、
+// 偏移数组和课程id, 其余列在第一次访问时才被读入 (RSS随查询触及的列增长)
+class StudentSnapshot {
+ public:
+  using RowId = StudentStore::RowId;
+  using CourseId = StudentStore::CourseId;
+  using CourseIds = StudentStore::CourseIds;
+
+  explicit StudentSnapshot(const std::string& path) {
+    if (!snapshot::host_is_little_endian()) throw std::runtime_error("快照格式需要小端主机");
+    map_file(path);
+    try {
+      validate();
+    } catch (...) {
+      unmap();
+      throw;
+    }
+  }
+
+  StudentSnapshot(const StudentSnapshot&) = delete;
+  StudentSnapshot& operator=(const StudentSnapshot&) = delete;
+
+  ~StudentSnapshot() { unmap(); }
+
+  size_t size() const { return static_cast<size_t>(header().row_count); }
+  size_t file_bytes() const { return size_; }
+
+  std::string_view name(RowId row) const {
+    const uint32_t* offsets = column<uint32_t>(snapshot::kNameOffsets);
+    return {column<char>(snapshot::kNameHeap) + offsets[row], offsets[row + 1] - offsets[row]};
+  }
+  int age(RowId row) const { return column<uint8_t>(snapshot::kAge)[row]; }
+  double gpa(RowId row) const { return column<double>(snapshot::kGpa)[row]; }
+  CourseIds courses(RowId row) const {
+    const uint32_t* offsets = column<uint32_t>(snapshot::kCourseOffsets);
+    const CourseId* ids = column<CourseId>(snapshot::kCourseIds);
+    return {ids + offsets[row], ids + offsets[row + 1]};
+  }
+
+  size_t course_count() const { return static_cast<size_t>(header().course_count); }
+  std::string_view course_name(CourseId id) const {
+    const uint32_t* offsets = column<uint32_t>(snapshot::kDictOffsets);
+    return {column<char>(snapshot::kDictHeap) + offsets[id], offsets[id + 1] - offsets[id]};
+  }
+
+  // 只触及gpa和age两列
+  StudentStats statistics() const {
+    return column_statistics(column<double>(snapshot::kGpa), column<uint8_t>(snapshot::kAge),
+                             size());
+  }
+
+  // 导出为与 StudentManager::save_to_file 相同字段的JSON, 供其他工具使用
+  void export_json(const std::string& path) const {
+    BufferedFileWriter out(path);
+    out.write("[\n");
+    for (RowId row = 0; row < size(); ++row) {
+      if (row > 0) out.write(",\n");
+      out.write("{\"name\":");
+      write_json_string(out, name(row));
+      out.write(",\"age\":");
+      write_json_number(out, static_cast<long long>(age(row)));
+      out.write(",\"gpa\":");
+      write_json_number(out, gpa(row));
+      out.write(",\"courses\":[");
+      bool first = true;
+      for (CourseId id : courses(row)) {
+        if (!first) out.put(',');
+        first = false;
+        write_json_string(out, course_name(id));
+      }
+      out.write("]}");
+    }
+    out.write("\n]\n");
+    out.close();
+  }
+
+ private:
+  const char* base_ = nullptr;
+  size_t size_ = 0;
+  bool mapped_ = false;
+  std::vector<uint64_t> buffer_;  // 无mmap时的后备存储, uint64_t保证8字节对齐
+
+  const snapshot::Header& header() const {
+    return *reinterpret_cast<const snapshot::Header*>(base_);
+  }
+
+  template <typename T>
+  const T* column(snapshot::Section section) const {
+    return reinterpret_cast<const T*>(base_ + header().sections[section].offset);
+  }
+
+  void map_file(const std::string& path) {
+#if defined(COMBINED_SNAPSHOT_MMAP)
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("无法打开快照: " + path);
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(snapshot::Header))) {
+      ::close(fd);
+      throw std::runtime_error("快照文件过小: " + path);
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) throw std::runtime_error("mmap失败: " + path);
+    base_ = static_cast<const char*>(p);
+    mapped_ = true;
+#else
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) throw std::runtime_error("无法打开快照: " + path);
+    std::fseek(file, 0, SEEK_END);
+    size_ = static_cast<size_t>(std::ftell(file));
+    std::fseek(file, 0, SEEK_SET);
+    buffer_.resize((size_ + 7) / 8);
+    const size_t read = std::fread(buffer_.data(), 1, size_, file);
+    std::fclose(file);
+    if (read != size_ || size_ < sizeof(snapshot::Header)) {
+      throw std::runtime_error("快照读取失败: " + path);
+    }
+    base_ = reinterpret_cast<const char*>(buffer_.data());
+#endif
+  }
+
+  void unmap() {
+#if defined(COMBINED_SNAPSHOT_MMAP)
+    if (mapped_) ::munmap(const_cast<char*>(base_), size_);
+#endif
+    mapped_ = false;
+    base_ = nullptr;
+  }
+
+  // 校验头部、段边界和各段长度, 再顺序扫描三个偏移数组和课程id列 (每行约14字节),
+  // 保证 name / courses / course_name 不会越界; gpa、age和两个字符堆不在这里读取.
+  // 长度乘法之前先用文件大小限制行数和课程数, 不会溢出
+  void validate() const {
+    using namespace snapshot;
+    const Header& h = header();
+    if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0) {
+      throw std::runtime_error("不是学生快照文件");
+    }
+    if (h.version != kVersion) {
+      throw std::runtime_error("不支持的快照版本: " + std::to_string(h.version));
+    }
+    if (h.section_count != kSectionCount) throw std::runtime_error("快照段表损坏");
+
+    for (const SectionEntry& section : h.sections) {
+      if (section.offset % 8 != 0 || section.offset > size_ ||
+          section.bytes > size_ - section.offset) {
+        throw std::runtime_error("快照段越界");
+      }
+    }
+
+    // 每行至少占一个double, 每门课至少占一个uint32偏移; 课程id是16位
+    const uint64_t rows = h.row_count;
+    const uint64_t courses = h.course_count;
+    if (rows > size_ / sizeof(double) || courses > size_ / sizeof(uint32_t) ||
+        courses > uint64_t{std::numeric_limits<CourseId>::max()} + 1) {
+      throw std::runtime_error("快照行数或课程数超出文件大小");
+    }
+
+    auto expect = [&](Section section, uint64_t bytes) {
+      if (h.sections[section].bytes != bytes) throw std::runtime_error("快照段长度不一致");
+    };
+    expect(kGpa, rows * sizeof(double));
+    expect(kAge, rows);
+    expect(kNameOffsets, (rows + 1) * sizeof(uint32_t));
+    expect(kCourseOffsets, (rows + 1) * sizeof(uint32_t));
+    expect(kDictOffsets, (courses + 1) * sizeof(uint32_t));
+    expect(kNameHeap, checked_offsets(kNameOffsets, rows));
+    expect(kCourseIds, checked_offsets(kCourseOffsets, rows) * uint64_t{sizeof(CourseId)});
+    expect(kDictHeap, checked_offsets(kDictOffsets, courses));
+
+    const CourseId* ids = column<CourseId>(kCourseIds);
+    const uint64_t id_count = h.sections[kCourseIds].bytes / sizeof(CourseId);
+    for (uint64_t i = 0; i < id_count; ++i) {
+      if (ids[i] >= courses) throw std::runtime_error("快照课程id越界");
+    }
+  }
+
+  // count + 1 个偏移必须从0开始单调不减; 返回最后一个偏移 (即对应堆的长度)
+  uint64_t checked_offsets(snapshot::Section section, uint64_t count) const {
+    const uint32_t* offsets = column<uint32_t>(section);
+    if (offsets[0] != 0) throw std::runtime_error("快照偏移数组损坏");
+    for (uint64_t i = 0; i < count; ++i) {
+      if (offsets[i + 1] < offsets[i]) throw std::runtime_error("快照偏移数组损坏");
+    }
+    return offsets[count];
+  }
+};
+
+#endif  // CPP_FEATURES_COMBINED_STUDENT_SNAPSHOT_H
@@ -0,0 +1,212 @@
+#ifndef CPP_FEATURES_COMBINED_STUDENT_STORE_H
+#define CPP_FEATURES_COMBINED_STUDENT_STORE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 统计结果, 行式(StudentManager)和列式(StudentStore)共用
+struct StudentStats {
+  size_t count = 0;
+  double avg_gpa = 0.0;
+  double min_gpa = 0.0;
+  double max_gpa = 0.0;
+  double avg_age = 0.0;
+};
+
+// 列统计内核, StudentStore 和内存映射的快照共用.
+// gpa用4路独立累加, 不依赖 -ffast-math 也能向量化; age为整数求和
+inline StudentStats column_statistics(const double* gpa, const uint8_t* age, size_t n) {
+  StudentStats stats;
+  stats.count = n;
+  if (n == 0) return stats;
+
+  constexpr size_t kLanes = 4;
+  double sum[kLanes] = {};
+  double lo[kLanes] = {gpa[0], gpa[0], gpa[0], gpa[0]};
+  double hi[kLanes] = {gpa[0], gpa[0], gpa[0], gpa[0]};
+  size_t i = 0;
+  for (; i + kLanes <= n; i += kLanes) {
+    for (size_t lane = 0; lane < kLanes; ++lane) {
+      const double v = gpa[i + lane];
+      sum[lane] += v;
+      lo[lane] = v < lo[lane] ? v : lo[lane];
+      hi[lane] = v > hi[lane] ? v : hi[lane];
+    }
+  }
+  for (; i < n; ++i) {
+    sum[0] += gpa[i];
+    lo[0] = std::min(lo[0], gpa[i]);
+    hi[0] = std::max(hi[0], gpa[i]);
+  }
+
+  uint64_t age_total = 0;
+  for (size_t r = 0; r < n; ++r) age_total += age[r];
+
+  stats.avg_gpa = (sum[0] + sum[1] + sum[2] + sum[3]) / static_cast<double>(n);
+  stats.min_gpa = std::min(std::min(lo[0], lo[1]), std::min(lo[2], lo[3]));
+  stats.max_gpa = std::max(std::max(hi[0], hi[1]), std::max(hi[2], hi[3]));
+  stats.avg_age = static_cast<double>(age_total) / static_cast<double>(n);
+  return stats;
+}
+
+// 列式(SoA)学生存储: gpa/age各自连续存放, 统计和过滤只扫描需要的列.
+// 姓名追加到一个字符串池里按偏移访问, 课程名字典编码为16位ID,
+// 每个学生的课程ID按CSR方式(偏移数组 + ID数组)存放.
+class StudentStore {
+ public:
+  using RowId = uint32_t;
+  using CourseId = uint16_t;
+  static constexpr CourseId kNoCourse = std::numeric_limits<CourseId>::max();
+
+  // 一行的课程ID范围
+  struct CourseIds {
+    const CourseId* first;
+    const CourseId* last;
+    const CourseId* begin() const { return first; }
+    const CourseId* end() const { return last; }
+    size_t size() const { return static_cast<size_t>(last - first); }
+  };
+
+  StudentStore() {
+    name_offsets_.push_back(0);
+    course_offsets_.push_back(0);
+  }
+
+  void reserve(size_t rows, size_t avg_name_bytes = 16, size_t avg_courses = 5) {
+    gpa_.reserve(rows);
+    age_.reserve(rows);
+    name_offsets_.reserve(rows + 1);
+    name_pool_.reserve(rows * avg_name_bytes);
+    course_offsets_.reserve(rows + 1);
+    course_ids_.reserve(rows * avg_courses);
+  }
+
+  // 任何带 name/age/gpa/courses 成员的学生类型都可以追加
+  template <typename StudentT>
+  RowId append(const StudentT& student) {
+    return append(std::string_view(student.name), student.age, student.gpa, student.courses);
+  }
+
+  template <typename CourseList>
+  RowId append(std::string_view name, int age, double gpa, const CourseList& courses) {
+    if (gpa_.size() >= std::numeric_limits<RowId>::max()) {
+      throw std::length_error("StudentStore: too many rows");
+    }
+    if (age < 0 || age > std::numeric_limits<uint8_t>::max()) {
+      throw std::out_of_range("StudentStore: age out of range");
+    }
+    if (name_pool_.size() + name.size() > std::numeric_limits<uint32_t>::max()) {
+      throw std::length_error("StudentStore: name pool exceeds 4 GB");
+    }
+
+    const auto row = static_cast<RowId>(gpa_.size());
+    gpa_.push_back(gpa);
+    age_.push_back(static_cast<uint8_t>(age));
+    name_pool_.insert(name_pool_.end(), name.begin(), name.end());
+    name_offsets_.push_back(static_cast<uint32_t>(name_pool_.size()));
+    for (const auto& course : courses) course_ids_.push_back(intern_course(course));
+    course_offsets_.push_back(static_cast<uint32_t>(course_ids_.size()));
+    return row;
+  }
+
+  size_t size() const { return gpa_.size(); }
+  bool empty() const { return gpa_.empty(); }
+
+  std::string_view name(RowId row) const {
+    return std::string_view(name_pool_.data() + name_offsets_[row],
+                            name_offsets_[row + 1] - name_offsets_[row]);
+  }
+  int age(RowId row) const { return age_[row]; }
+  double gpa(RowId row) const { return gpa_[row]; }
+  CourseIds courses(RowId row) const {
+    return {course_ids_.data() + course_offsets_[row],
+            course_ids_.data() + course_offsets_[row + 1]};
+  }
+
+  // 原始列, 供快照写出
+  const std::vector<double>& gpa_column() const { return gpa_; }
+  const std::vector<uint8_t>& age_column() const { return age_; }
+  const std::vector<uint32_t>& name_offsets() const { return name_offsets_; }
+  const std::vector<char>& name_pool() const { return name_pool_; }
+  const std::vector<uint32_t>& course_offsets() const { return course_offsets_; }
+  const std::vector<CourseId>& course_id_column() const { return course_ids_; }
+  const std::vector<std::string>& course_names() const { return course_names_; }
+
+  size_t course_count() const { return course_names_.size(); }
+  std::string_view course_name(CourseId id) const { return course_names_[id]; }
+  CourseId course_id(std::string_view course) const {
+    auto it = course_lookup_.find(course);
+    return it == course_lookup_.end() ? kNoCourse : it->second;
+  }
+
+  // 与 StudentManager::statistics() 结果一致
+  StudentStats statistics() const { return column_statistics(gpa_.data(), age_.data(), size()); }
+
+  size_t count_gpa_at_least(double min_gpa) const {
+    size_t count = 0;
+    for (double g : gpa_) count += g >= min_gpa;
+    return count;
+  }
+
+  // 返回行号而不是复制学生; 无分支写入, 命中与否都写, 只有命中才前进
+  std::vector<RowId> filter_gpa_at_least(double min_gpa) const {
+    std::vector<RowId> rows(gpa_.size());
+    const double* g = gpa_.data();
+    RowId* out = rows.data();
+    size_t hits = 0;
+    for (size_t i = 0; i < gpa_.size(); ++i) {
+      out[hits] = static_cast<RowId>(i);
+      hits += g[i] >= min_gpa;
+    }
+    rows.resize(hits);
+    return rows;
+  }
+
+  // 每门课程的选课人数, 直接扫描ID列
+  std::vector<size_t> enrollment_counts() const {
+    std::vector<size_t> counts(course_names_.size(), 0);
+    for (CourseId id : course_ids_) ++counts[id];
+    return counts;
+  }
+
+  size_t memory_bytes() const {
+    size_t bytes = gpa_.capacity() * sizeof(double) + age_.capacity() +
+                   name_offsets_.capacity() * sizeof(uint32_t) + name_pool_.capacity() +
+                   course_offsets_.capacity() * sizeof(uint32_t) +
+                   course_ids_.capacity() * sizeof(CourseId);
+    for (const auto& course : course_names_) bytes += sizeof(course) + course.capacity();
+    return bytes;
+  }
+
+ private:
+  std::vector<double> gpa_;
+  std::vector<uint8_t> age_;
+  std::vector<uint32_t> name_offsets_;  // size()+1 项, name(i) = [offsets[i], offsets[i+1])
+  std::vector<char> name_pool_;
+  std::vector<uint32_t> course_offsets_;
+  std::vector<CourseId> course_ids_;
+  std::vector<std::string> course_names_;
+  std::map<std::string, CourseId, std::less<>> course_lookup_;
+
+  CourseId intern_course(std::string_view course) {
+    auto it = course_lookup_.find(course);
+    if (it != course_lookup_.end()) return it->second;
+    if (course_names_.size() >= kNoCourse) {
+      throw std::length_error("StudentStore: too many distinct courses");
+    }
+    const auto id = static_cast<CourseId>(course_names_.size());
+    course_names_.emplace_back(course);
+    course_lookup_.emplace(course_names_.back(), id);
+    return id;
+  }
+};
+
+#endif  // CPP_FEATURES_COMBINED_STUDENT_STORE_H
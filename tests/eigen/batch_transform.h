@@ -0,0 +1,161 @@
+#ifndef CPP_FEATURES_EIGEN_BATCH_TRANSFORM_H
+#define CPP_FEATURES_EIGEN_BATCH_TRANSFORM_H
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "thread_pool.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// 批量点变换: 点按SoA存放 (x[], y[], z[]), 一个4x4齐次变换矩阵作用于所有点.
+// AVX2下每次处理4个点 (每个点占一个double通道), 矩阵元素广播到寄存器;
+// 仿射矩阵 (最后一行为 0 0 0 1) 跳过透视除法.
+
+namespace batch_transform {
+
+struct PointsSoA {
+  std::vector<double> x, y, z;
+
+  PointsSoA() = default;
+  explicit PointsSoA(size_t count) : x(count), y(count), z(count) {}
+
+  size_t size() const { return x.size(); }
+  void resize(size_t count) {
+    x.resize(count);
+    y.resize(count);
+    z.resize(count);
+  }
+};
+
+inline bool is_affine(const Eigen::Matrix4d& m) {
+  return m(3, 0) == 0.0 && m(3, 1) == 0.0 && m(3, 2) == 0.0 && m(3, 3) == 1.0;
+}
+
+namespace detail {
+
+// 标量尾部 (以及没有AVX2时的全部点)
+inline void transform_scalar(const Eigen::Matrix4d& m, bool affine, const PointsSoA& in,
+                             PointsSoA& out, size_t first, size_t last) {
+  for (size_t i = first; i < last; ++i) {
+    const double x = in.x[i], y = in.y[i], z = in.z[i];
+    double rx = m(0, 0) * x + m(0, 1) * y + m(0, 2) * z + m(0, 3);
+    double ry = m(1, 0) * x + m(1, 1) * y + m(1, 2) * z + m(1, 3);
+    double rz = m(2, 0) * x + m(2, 1) * y + m(2, 2) * z + m(2, 3);
+    if (!affine) {
+      const double inv_w = 1.0 / (m(3, 0) * x + m(3, 1) * y + m(3, 2) * z + m(3, 3));
+      rx *= inv_w;
+      ry *= inv_w;
+      rz *= inv_w;
+    }
+    out.x[i] = rx;
+    out.y[i] = ry;
+    out.z[i] = rz;
+  }
+}
+
+#if defined(__AVX2__)
+// 矩阵一行广播到4个寄存器后与4个点的点积: r = m0*x + m1*y + m2*z + m3
+struct BroadcastRow {
+  __m256d m0, m1, m2, m3;
+
+  BroadcastRow(const Eigen::Matrix4d& m, int row)
+      : m0(_mm256_set1_pd(m(row, 0))),
+        m1(_mm256_set1_pd(m(row, 1))),
+        m2(_mm256_set1_pd(m(row, 2))),
+        m3(_mm256_set1_pd(m(row, 3))) {}
+
+  __m256d dot(__m256d x, __m256d y, __m256d z) const {
+#if defined(__FMA__)
+    return _mm256_fmadd_pd(m2, z, _mm256_fmadd_pd(m1, y, _mm256_fmadd_pd(m0, x, m3)));
+#else
+    return _mm256_add_pd(
+        _mm256_mul_pd(m2, z),
+        _mm256_add_pd(_mm256_mul_pd(m1, y), _mm256_add_pd(_mm256_mul_pd(m0, x), m3)));
+#endif
+  }
+};
+
+inline void transform_avx2(const Eigen::Matrix4d& m, bool affine, const PointsSoA& in,
+                           PointsSoA& out, size_t first, size_t last) {
+  // 广播在循环外做好: 仿射时12个常量寄存器 + 3个输入, 正好放进16个ymm寄存器
+  const BroadcastRow r0(m, 0), r1(m, 1), r2(m, 2), r3(m, 3);
+  const double* in_x = in.x.data();
+  const double* in_y = in.y.data();
+  const double* in_z = in.z.data();
+  double* out_x = out.x.data();
+  double* out_y = out.y.data();
+  double* out_z = out.z.data();
+
+  size_t i = first;
+  for (; i + 4 <= last; i += 4) {
+    // 先全部读入再写出, 因此 out 与 in 相同时也正确
+    const __m256d x = _mm256_loadu_pd(in_x + i);
+    const __m256d y = _mm256_loadu_pd(in_y + i);
+    const __m256d z = _mm256_loadu_pd(in_z + i);
+    __m256d rx = r0.dot(x, y, z);
+    __m256d ry = r1.dot(x, y, z);
+    __m256d rz = r2.dot(x, y, z);
+    if (!affine) {
+      const __m256d inv_w = _mm256_div_pd(_mm256_set1_pd(1.0), r3.dot(x, y, z));
+      rx = _mm256_mul_pd(rx, inv_w);
+      ry = _mm256_mul_pd(ry, inv_w);
+      rz = _mm256_mul_pd(rz, inv_w);
+    }
+    _mm256_storeu_pd(out_x + i, rx);
+    _mm256_storeu_pd(out_y + i, ry);
+    _mm256_storeu_pd(out_z + i, rz);
+  }
+  transform_scalar(m, affine, in, out, i, last);
+}
+#endif
+
+}  // namespace detail
+
+// 变换 [first, last) 范围内的点; out 必须已有 in.size() 个元素 (可以就是 in)
+inline void transform_points(const Eigen::Matrix4d& m, const PointsSoA& in, PointsSoA& out,
+                             size_t first, size_t last) {
+  const bool affine = is_affine(m);
+#if defined(__AVX2__)
+  detail::transform_avx2(m, affine, in, out, first, last);
+#else
+  detail::transform_scalar(m, affine, in, out, first, last);
+#endif
+}
+
+inline void transform_points(const Eigen::Matrix4d& m, const PointsSoA& in, PointsSoA& out) {
+  out.resize(in.size());
+  transform_points(m, in, out, 0, in.size());
+}
+
+// 多线程版本: 按 chunk 个点切块交给线程池, 块大小是4的倍数, 只有最后一块有标量尾部
+inline void transform_points(const Eigen::Matrix4d& m, const PointsSoA& in, PointsSoA& out,
+                             cpp_features::ThreadPool& pool, size_t chunk = 65536) {
+  out.resize(in.size());
+  chunk = std::max<size_t>(4, chunk & ~size_t(3));
+  const size_t chunks = (in.size() + chunk - 1) / chunk;
+  pool.parallel_for(chunks, [&](size_t c) {
+    const size_t first = c * chunk;
+    transform_points(m, in, out, first, std::min(first + chunk, in.size()));
+  });
+}
+
+// 当前构建使用的内核名称, 便于基准输出
+inline const char* kernel_name() {
+#if defined(__AVX2__) && defined(__FMA__)
+  return "AVX2+FMA";
+#elif defined(__AVX2__)
+  return "AVX2";
+#else
+  return "标量 (xmake f --simd=y 启用AVX2)";
+#endif
+}
+
+}  // namespace batch_transform
+
+#endif  // CPP_FEATURES_EIGEN_BATCH_TRANSFORM_H
@@ -1,14 +1,21 @@
+#include <algorithm>
 #include <chrono>
 #include <cmath>
+#include <cstdlib>
 #include <iomanip>
 #include <iostream>
-#include <random>
+#include <sstream>
+#include <string>
 #include <vector>
 
 #include <Eigen/Dense>
 #include <Eigen/Eigenvalues>
+#include <Eigen/Geometry>
 #include <Eigen/Sparse>
 
+#include "batch_transform.h"
+#include "sparse_csr.h"
+
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
@@ -277,6 +284,149 @@ void demo_sparse_matrices() {
   }
 }
 
+namespace {
+
+long env_long(const char* name, long fallback) {
+  const char* value = std::getenv(name);
+  if (value == nullptr) return fallback;
+  long parsed = std::strtol(value, nullptr, 10);
+  return parsed > 0 ? parsed : fallback;
+}
+
+template <typename F>
+double time_ms(F&& work) {
+  auto start = std::chrono::steady_clock::now();
+  work();
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+// 每个问题跑哪些求解器: 三维泊松的LU填充元太多 (1e5 规模就要约 90 s), 只跑CG
+enum class SparseSolvers { kNone, kCg, kCgAndLu };
+
+// 一个稀疏问题的完整测试: 构建 (Eigen / 自己的CSR), SpMV, 以及对称正定问题的
+// 共轭梯度和 (规模不太大时) SparseLU
+void run_sparse_case(const std::string& name, sparse_bench::Triplets triplets, int rows,
+                     SparseSolvers solvers, cpp_features::ThreadPool& pool) {
+  using RowMatrix = SparseMatrix<double, RowMajor>;
+  const long lu_max = env_long("EIGEN_BENCH_LU_MAX", 250000);
+  const int cg_iterations = static_cast<int>(env_long("EIGEN_BENCH_CG_ITERS", 1000));
+
+  std::cout << "\n[" << name << "] " << rows << " 个未知数, " << triplets.size()
+            << " 个三元组\n";
+
+  RowMatrix A(rows, rows);
+  double eigen_build = time_ms([&] { A.setFromTriplets(triplets.begin(), triplets.end()); });
+  sparse_bench::CsrMatrix csr;
+  double csr_build = time_ms([&] {
+    csr = sparse_bench::build_csr(triplets, rows, rows);
+    sparse_bench::plan_row_splits(csr, pool.size() * 8);
+  });
+  std::cout << "  构建: setFromTriplets " << eigen_build << " ms, build_csr " << csr_build
+            << " ms (" << csr.non_zeros() << " 个非零元)\n";
+
+  const VectorXd x = VectorXd::LinSpaced(rows, 0.5, 1.5);
+  VectorXd y_coo;
+  double coo_ms = time_ms([&] { sparse_bench::spmv_coo(triplets, x, y_coo, rows); });
+  sparse_bench::Triplets().swap(triplets);  // 之后只用压缩格式, 先释放三元组
+
+  // SpMV 重复多次取平均; 每次约读 12 字节/非零元 + x 和 y
+  const size_t nnz = csr.non_zeros();
+  const int reps = static_cast<int>(std::clamp<size_t>(400000000 / (nnz + 1), 3, 50));
+  const double bytes = 12.0 * nnz + 16.0 * rows + 8.0 * rows;
+  auto report_spmv = [&](const char* label, double total_ms) {
+    double ms = total_ms / reps;
+    std::cout << "    " << std::left << std::setw(18) << label << std::right << std::setw(8)
+              << ms << " ms, " << std::setw(6)
+              << 2.0 * nnz / (ms * 1e6) << " GFLOP/s, " << std::setw(6) << bytes / (ms * 1e6)
+              << " GB/s\n";
+  };
+  VectorXd y_eigen(rows), y_csr(rows), y_pool(rows);
+  double eigen_ms = time_ms([&] {
+    for (int i = 0; i < reps; ++i) y_eigen.noalias() = A * x;
+  });
+  double csr_ms = time_ms([&] {
+    for (int i = 0; i < reps; ++i) sparse_bench::spmv(csr, x, y_csr);
+  });
+  double pool_ms = time_ms([&] {
+    for (int i = 0; i < reps; ++i) sparse_bench::spmv(csr, x, y_pool, pool);
+  });
+  std::cout << "  SpMV (" << reps << " 次平均, COO只跑一次):\n";
+  report_spmv("COO scatter", coo_ms * reps);
+  report_spmv("Eigen RowMajor", eigen_ms);
+  report_spmv("CSR", csr_ms);
+  report_spmv("CSR + ThreadPool", pool_ms);
+  const double scale = y_eigen.cwiseAbs().maxCoeff();
+  std::cout << std::scientific << std::setprecision(1) << "    与Eigen结果的最大相对差: CSR "
+            << (y_csr - y_eigen).cwiseAbs().maxCoeff() / scale << ", 线程池 "
+            << (y_pool - y_eigen).cwiseAbs().maxCoeff() / scale << ", COO "
+            << (y_coo - y_eigen).cwiseAbs().maxCoeff() / scale << std::fixed << "\n";
+
+  if (solvers == SparseSolvers::kNone) return;
+  const VectorXd b = VectorXd::Ones(rows);
+
+  ConjugateGradient<RowMatrix, Lower | Upper> cg;
+  cg.setMaxIterations(cg_iterations);
+  cg.setTolerance(1e-8);
+  VectorXd solution;
+  double cg_ms = time_ms([&] {
+    cg.compute(A);
+    solution = cg.solve(b);
+  });
+  std::cout << "  ConjugateGradient: " << cg_ms << " ms, "
+            << cg.iterations() << " 次迭代, 相对残差 " << std::scientific
+            << std::setprecision(2) << cg.error() << std::fixed << std::setprecision(1)
+            << (cg.info() == Success ? "" : " (达到迭代上限)") << "\n";
+
+  if (solvers != SparseSolvers::kCgAndLu) return;
+  if (rows > lu_max) {
+    std::cout << "  SparseLU: 跳过 (超过 EIGEN_BENCH_LU_MAX=" << lu_max << ")\n";
+    return;
+  }
+  SparseMatrix<double> A_col = A;
+  SparseLU<SparseMatrix<double>> lu;
+  double factor_ms = time_ms([&] {
+    lu.analyzePattern(A_col);
+    lu.factorize(A_col);
+  });
+  if (lu.info() != Success) {
+    std::cout << "  SparseLU 分解失败: " << lu.lastErrorMessage() << "\n";
+    return;
+  }
+  double solve_ms = time_ms([&] { solution = lu.solve(b); });
+  std::cout << "  SparseLU: " << factor_ms << " ms 分解, "
+            << solve_ms << " ms 求解, 残差 " << std::scientific << std::setprecision(2)
+            << (A * solution - b).norm() / b.norm() << std::fixed << std::setprecision(1)
+            << "\n";
+}
+
+}  // namespace
+
+// 大规模稀疏问题: 二维/三维泊松方程和幂律随机图, 规模 1e5 - 1e7 个未知数
+void demo_sparse_benchmark() {
+  print_separator("稀疏矩阵基准测试");
+
+  const long max_unknowns = env_long("EIGEN_BENCH_MAX_UNKNOWNS", 1000000);
+  cpp_features::ThreadPool pool;
+  std::cout << "线程池: " << pool.size() << " 个线程; 最大规模 " << max_unknowns
+            << " 个未知数 (EIGEN_BENCH_MAX_UNKNOWNS 调整, 最大 10000000)\n";
+  std::cout << std::setprecision(1);
+
+  for (long target : {100000L, 1000000L, 10000000L}) {
+    if (target > max_unknowns) break;
+    const int n2 = static_cast<int>(std::lround(std::sqrt(static_cast<double>(target))));
+    run_sparse_case("二维泊松 " + std::to_string(n2) + "^2", sparse_bench::poisson_2d(n2),
+                    n2 * n2, SparseSolvers::kCgAndLu, pool);
+    const int n3 = static_cast<int>(std::lround(std::cbrt(static_cast<double>(target))));
+    run_sparse_case("三维泊松 " + std::to_string(n3) + "^3", sparse_bench::poisson_3d(n3),
+                    n3 * n3 * n3, SparseSolvers::kCg, pool);
+    const int nodes = static_cast<int>(target);
+    run_sparse_case("幂律随机图 (平均度 8)", sparse_bench::power_law_graph(nodes, 8), nodes,
+                    SparseSolvers::kNone, pool);
+  }
+  std::cout << std::setprecision(4);
+}
+
 void demo_matrix_functions() {
   print_separator("矩阵函数和高级操作");
 
@@ -362,50 +512,156 @@ void demo_geometry_transformations() {
             << transformed_3d(2) << ")\n\n";
 }
 
-void demo_performance_optimization() {
-  print_separator("性能优化示例");
-
-  const int size = 1000;
-
-  // 生成随机矩阵
-  std::random_device rd;
-  std::mt19937 gen(rd());
-  std::uniform_real_distribution<double> dis(-10.0, 10.0);
-
-  MatrixXd A = MatrixXd::NullaryExpr(size, size, [&]() { return dis(gen); });
-  MatrixXd B = MatrixXd::NullaryExpr(size, size, [&]() { return dis(gen); });
-
-  std::cout << "测试 " << size << "x" << size << " 矩阵运算性能:\n\n";
-
-  // 矩阵乘法
-  auto start = std::chrono::high_resolution_clock::now();
-  MatrixXd C = A * B;
-  auto end = std::chrono::high_resolution_clock::now();
+// 本次构建的Eigen配置: 线程数, 是否走BLAS, 启用的SIMD指令集
+void print_eigen_configuration() {
+  std::cout << "Eigen " << EIGEN_WORLD_VERSION << "." << EIGEN_MAJOR_VERSION << "."
+            << EIGEN_MINOR_VERSION << ", SIMD: " << SimdInstructionSetsInUse() << "\n";
+#ifdef _OPENMP
+  std::cout << "OpenMP: 开启, Eigen线程数 " << nbThreads() << "\n";
+#else
+  std::cout << "OpenMP: 关闭 (xmake f --eigen_openmp=y)\n";
+#endif
+#ifdef EIGEN_USE_BLAS
+  std::cout << "BLAS: 稠密乘法/三角求解走外部BLAS (EIGEN_USE_BLAS)\n";
+#else
+  std::cout << "BLAS: Eigen内置内核 (xmake f --eigen_blas=y 改用OpenBLAS)\n";
+#endif
+}
 
-  auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
-  std::cout << "矩阵乘法时间: " << duration.count() << " ms\n";
+// 重复执行直到累计约 0.2 s (至少一次), 返回单次的毫秒数
+template <typename F>
+double average_ms(F&& work) {
+  int reps = 0;
+  double total = 0.0;
+  do {
+    total += time_ms(work);
+    ++reps;
+  } while (total < 200.0);
+  return total / reps;
+}
 
-  // LU分解
-  start = std::chrono::high_resolution_clock::now();
-  PartialPivLU<MatrixXd> lu(A);
-  end = std::chrono::high_resolution_clock::now();
+// 批量变换大量点: 逐点 Matrix4d * Vector4d (AoS), Eigen 的 4xN 矩阵乘法,
+// SoA + AVX2 内核 (单线程 / 线程池). 小规模数据在缓存内, 看内核本身的速度;
+// 大规模受内存带宽限制, SoA 每点读写 48 字节, AoS 齐次坐标是 64 字节
+void demo_batch_transformations() {
+  print_separator("批量点变换");
+
+  const Matrix4d transform = (Translation3d(5, -2, 3) *
+                              AngleAxisd(M_PI / 6, Vector3d::UnitZ()) * Scaling(1.5))
+                                 .matrix();
+  cpp_features::ThreadPool pool;
+  std::cout << "内核: " << batch_transform::kernel_name() << ", 线程池 " << pool.size()
+            << " 个线程\n";
+
+  const size_t large = static_cast<size_t>(env_long("EIGEN_BENCH_POINTS", 4000000));
+  for (size_t count : {size_t(16384), large}) {
+    std::cout << "\n" << count << " 个点:\n";
+    batch_transform::PointsSoA points(count);
+    std::vector<Vector4d> points_aos(count);
+    Matrix<double, 4, Dynamic> homogeneous(4, count);
+    for (size_t i = 0; i < count; ++i) {
+      points.x[i] = static_cast<double>(i % 1000) * 0.01;
+      points.y[i] = static_cast<double>(i % 777) * -0.02;
+      points.z[i] = static_cast<double>(i % 333) * 0.03;
+      points_aos[i] = Vector4d(points.x[i], points.y[i], points.z[i], 1.0);
+      homogeneous.col(i) = points_aos[i];
+    }
+
+    auto report = [&](const char* label, double ms) {
+      std::cout << "  " << std::left << std::setw(28) << label << std::right << std::setw(10)
+                << std::setprecision(3) << ms << " ms, " << std::setw(8) << std::setprecision(1)
+                << count / (ms * 1e3) << " M点/秒\n";
+    };
+
+    std::vector<Vector4d> per_point(count);
+    report("逐点 transform * point", average_ms([&] {
+             for (size_t i = 0; i < count; ++i) per_point[i] = transform * points_aos[i];
+           }));
+
+    Matrix<double, 4, Dynamic> product(4, count);
+    report("4xN 矩阵乘法", average_ms([&] { product.noalias() = transform * homogeneous; }));
+
+    batch_transform::PointsSoA batched(count), threaded(count);
+    report("SoA 批量内核", average_ms([&] {
+             batch_transform::transform_points(transform, points, batched);
+           }));
+    report("SoA 批量内核 + 线程池", average_ms([&] {
+             batch_transform::transform_points(transform, points, threaded, pool);
+           }));
+
+    double max_error = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+      max_error = std::max({max_error, std::abs(threaded.x[i] - per_point[i].x()),
+                            std::abs(threaded.y[i] - per_point[i].y()),
+                            std::abs(threaded.z[i] - per_point[i].z()),
+                            std::abs(batched.x[i] - product(0, i))});
+    }
+    std::cout << "  与逐点结果的最大误差: " << std::scientific << max_error << std::fixed << "\n";
+  }
+  std::cout << "\n数据在缓存里时 SoA 的6个数据流不占优势; 数百万个点受内存带宽限制时,\n"
+            << "SoA 每点少读写 16 字节, 批量内核明显更快\n";
+  std::cout << std::setprecision(4);
+}
 
-  duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
-  std::cout << "LU分解时间: " << duration.count() << " ms\n";
+void demo_performance_optimization() {
+  print_separator("性能优化示例");
+  print_eigen_configuration();
 
-  // SVD分解
-  start = std::chrono::high_resolution_clock::now();
-  JacobiSVD<MatrixXd> svd(A, ComputeFullU | ComputeFullV);
-  end = std::chrono::high_resolution_clock::now();
+  const int max_size = static_cast<int>(env_long("EIGEN_BENCH_MAX_SIZE", 1024));
+  const int jacobi_max = static_cast<int>(env_long("EIGEN_BENCH_JACOBI_MAX", 512));
+#ifdef _OPENMP
+  if (long threads = env_long("EIGEN_BENCH_THREADS", 0)) setNbThreads(static_cast<int>(threads));
+#endif
 
-  duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
-  std::cout << "SVD分解时间: " << duration.count() << " ms\n\n";
+  // GFLOP/s 按标准运算量估算: 乘法 2n^3, LU 2n^3/3, 带U/V的完整SVD约 22n^3
+  auto gflops = [](double flops, double ms) { return flops / (ms * 1e6); };
+  std::cout << "\n规模扫描 (EIGEN_BENCH_MAX_SIZE=" << max_size << "), 每格: 毫秒 / GFLOP/s\n";
+  std::cout << std::left << std::setw(6) << "n" << std::right << std::setw(20) << "C = A*B"
+            << std::setw(20) << "C.noalias() = A*B" << std::setw(20) << "PartialPivLU"
+            << std::setw(20) << "BDCSVD" << std::setw(20) << "JacobiSVD" << "\n";
+
+  auto cell = [](double ms, double rate) {
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(ms < 10 ? 2 : 0) << ms << " / " << std::setprecision(1)
+         << rate;
+    return text.str();
+  };
+
+  for (int n = 128; n <= max_size; n *= 2) {
+    const MatrixXd A = MatrixXd::Random(n, n);
+    const MatrixXd B = MatrixXd::Random(n, n);
+    MatrixXd C(n, n);
+    const double cube = static_cast<double>(n) * n * n;
+
+    // 不加 noalias() 时Eigen假设可能有别名, 先算到临时矩阵再拷贝
+    double product_ms = average_ms([&] { C = A * B; });
+    double noalias_ms = average_ms([&] { C.noalias() = A * B; });
+    double lu_ms = average_ms([&] { PartialPivLU<MatrixXd> lu(A); });
+    double bdc_ms = average_ms([&] { BDCSVD<MatrixXd> svd(A, ComputeFullU | ComputeFullV); });
+
+    std::cout << std::left << std::setw(6) << n << std::right << std::setw(20)
+              << cell(product_ms, gflops(2 * cube, product_ms)) << std::setw(20)
+              << cell(noalias_ms, gflops(2 * cube, noalias_ms)) << std::setw(20)
+              << cell(lu_ms, gflops(2 * cube / 3, lu_ms)) << std::setw(20)
+              << cell(bdc_ms, gflops(22 * cube, bdc_ms));
+    if (n <= jacobi_max) {
+      double jacobi_ms =
+          average_ms([&] { JacobiSVD<MatrixXd> svd(A, ComputeFullU | ComputeFullV); });
+      std::cout << std::setw(20) << cell(jacobi_ms, gflops(22 * cube, jacobi_ms));
+    } else {
+      std::cout << std::setw(20) << "-";
+    }
+    std::cout << "\n";
+  }
+  std::cout << "(JacobiSVD 只测到 EIGEN_BENCH_JACOBI_MAX=" << jacobi_max
+            << ", 大矩阵请用 BDCSVD)\n\n";
 
   std::cout << "性能提示:\n";
   std::cout << "• 使用固定大小矩阵 (Matrix3d) 比动态大小 (MatrixXd) 更快\n";
   std::cout << "• 使用 noalias() 避免不必要的临时对象\n";
-  std::cout << "• 编译时开启 -O3 优化和 -DNDEBUG\n";
-  std::cout << "• 对于大型矩阵，考虑使用多线程版本的BLAS库\n";
+  std::cout << "• 编译时开启 -O3 优化和 -DNDEBUG, xmake f --native=y 启用 -march=native\n";
+  std::cout << "• 大矩阵用 xmake f --eigen_openmp=y 多线程, 或 --eigen_blas=y 接入OpenBLAS\n";
+  std::cout << "• 大矩阵SVD用 BDCSVD, JacobiSVD 只适合小矩阵或需要最高精度的场合\n";
 }
 
 int main() {
@@ -422,8 +678,10 @@ int main() {
     demo_eigenvalues_eigenvectors();
     demo_linear_systems();
     demo_sparse_matrices();
+    demo_sparse_benchmark();
     demo_matrix_functions();
     demo_geometry_transformations();
+    demo_batch_transformations();
     demo_performance_optimization();
 
     std::cout << "\n✅ Eigen 演示完成!\n";
@@ -0,0 +1,217 @@
+#ifndef CPP_FEATURES_EIGEN_SPARSE_CSR_H
+#define CPP_FEATURES_EIGEN_SPARSE_CSR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Sparse>
+
+#include "thread_pool.h"
+
+// 稀疏矩阵基准测试用的问题生成器和自己的CSR SpMV内核.
+// 三元组列表 (Eigen::Triplet) 同时充当COO格式, 既可以交给 setFromTriplets,
+// 也可以直接转换成下面的CSR.
+
+namespace sparse_bench {
+
+using Triplets = std::vector<Eigen::Triplet<double>>;
+
+// 二维泊松方程 (5点差分), n x n 网格, n^2 个未知数; 对称正定
+inline Triplets poisson_2d(int n) {
+  Triplets t;
+  t.reserve(static_cast<size_t>(n) * n * 5);
+  for (int y = 0; y < n; ++y) {
+    for (int x = 0; x < n; ++x) {
+      const int row = y * n + x;
+      // 按列号递增的顺序生成, 转CSR时每行已经有序
+      if (y > 0) t.emplace_back(row, row - n, -1.0);
+      if (x > 0) t.emplace_back(row, row - 1, -1.0);
+      t.emplace_back(row, row, 4.0);
+      if (x + 1 < n) t.emplace_back(row, row + 1, -1.0);
+      if (y + 1 < n) t.emplace_back(row, row + n, -1.0);
+    }
+  }
+  return t;
+}
+
+// 三维泊松方程 (7点差分), n^3 个未知数; 对称正定
+inline Triplets poisson_3d(int n) {
+  Triplets t;
+  const int plane = n * n;
+  t.reserve(static_cast<size_t>(plane) * n * 7);
+  for (int z = 0; z < n; ++z) {
+    for (int y = 0; y < n; ++y) {
+      for (int x = 0; x < n; ++x) {
+        const int row = z * plane + y * n + x;
+        if (z > 0) t.emplace_back(row, row - plane, -1.0);
+        if (y > 0) t.emplace_back(row, row - n, -1.0);
+        if (x > 0) t.emplace_back(row, row - 1, -1.0);
+        t.emplace_back(row, row, 6.0);
+        if (x + 1 < n) t.emplace_back(row, row + 1, -1.0);
+        if (y + 1 < n) t.emplace_back(row, row + n, -1.0);
+        if (z + 1 < n) t.emplace_back(row, row + plane, -1.0);
+      }
+    }
+  }
+  return t;
+}
+
+// 幂律随机图的邻接矩阵: 行号和列号都偏向小编号 (u^3 分布), 少数"中心"节点
+// 拥有大量边, 每行非零元个数极不均匀. 边是无序生成的, 可能有重复 (会被累加).
+inline Triplets power_law_graph(int nodes, int average_degree, uint64_t seed = 42) {
+  Triplets t;
+  const size_t edges = static_cast<size_t>(nodes) * average_degree;
+  t.reserve(edges);
+  uint64_t state = seed;
+  // splitmix64
+  auto next = [&state] {
+    uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+  };
+  auto skewed = [&](uint64_t bits) {
+    const double u = static_cast<double>(bits >> 11) * (1.0 / 9007199254740992.0);
+    return std::min(nodes - 1, static_cast<int>(nodes * u * u * u));
+  };
+  for (size_t e = 0; e < edges; ++e) {
+    const uint64_t bits = next();
+    const int row = skewed(bits);
+    const int col = skewed(next());
+    t.emplace_back(row, col, 1.0 + static_cast<double>(bits & 0xff) / 256.0);
+  }
+  return t;
+}
+
+// 压缩行存储: 第r行的非零元是 [row_ptr[r], row_ptr[r+1]) 范围内的
+// (col_idx, values). 每行列号递增且不重复.
+struct CsrMatrix {
+  int rows = 0;
+  int cols = 0;
+  std::vector<size_t> row_ptr;
+  std::vector<int> col_idx;
+  std::vector<double> values;
+  // 多线程SpMV的任务边界: 任务i处理 [row_splits[i], row_splits[i+1]) 行,
+  // 各任务的非零元个数大致相等 (幂律图按行数均分会严重失衡)
+  std::vector<int> row_splits;
+
+  size_t non_zeros() const { return values.size(); }
+};
+
+// COO (三元组) -> CSR: 按行计数排序, 再对每行按列排序并合并重复项,
+// 结果与 Eigen 的 setFromTriplets 相同
+inline CsrMatrix build_csr(const Triplets& coo, int rows, int cols) {
+  CsrMatrix m;
+  m.rows = rows;
+  m.cols = cols;
+  m.row_ptr.assign(static_cast<size_t>(rows) + 1, 0);
+  for (const auto& t : coo) ++m.row_ptr[static_cast<size_t>(t.row()) + 1];
+  for (int r = 0; r < rows; ++r) m.row_ptr[r + 1] += m.row_ptr[r];
+
+  m.col_idx.resize(coo.size());
+  m.values.resize(coo.size());
+  std::vector<size_t> cursor(m.row_ptr.begin(), m.row_ptr.end() - 1);
+  for (const auto& t : coo) {
+    const size_t at = cursor[t.row()]++;
+    m.col_idx[at] = t.col();
+    m.values[at] = t.value();
+  }
+  cursor = std::vector<size_t>();
+
+  // 每行排序 + 合并重复列, 同时原地压紧
+  std::vector<std::pair<int, double>> scratch;
+  size_t out = 0;
+  for (int r = 0; r < rows; ++r) {
+    const size_t begin = m.row_ptr[r];
+    const size_t end = m.row_ptr[r + 1];
+    m.row_ptr[r] = out;
+    if (!std::is_sorted(m.col_idx.begin() + begin, m.col_idx.begin() + end)) {
+      scratch.clear();
+      for (size_t i = begin; i < end; ++i) scratch.emplace_back(m.col_idx[i], m.values[i]);
+      std::sort(scratch.begin(), scratch.end(),
+                [](const auto& a, const auto& b) { return a.first < b.first; });
+      for (size_t i = 0; i < scratch.size(); ++i) {
+        m.col_idx[begin + i] = scratch[i].first;
+        m.values[begin + i] = scratch[i].second;
+      }
+    }
+    for (size_t i = begin; i < end; ++i) {
+      if (out > m.row_ptr[r] && m.col_idx[out - 1] == m.col_idx[i]) {
+        m.values[out - 1] += m.values[i];
+      } else {
+        m.col_idx[out] = m.col_idx[i];
+        m.values[out] = m.values[i];
+        ++out;
+      }
+    }
+  }
+  m.row_ptr[rows] = out;
+  m.col_idx.resize(out);
+  m.values.resize(out);
+  m.col_idx.shrink_to_fit();
+  m.values.shrink_to_fit();
+  return m;
+}
+
+// 按非零元个数把行切成 tasks 段 (二分查找 row_ptr)
+inline void plan_row_splits(CsrMatrix& m, size_t tasks) {
+  tasks = std::max<size_t>(1, std::min<size_t>(tasks, static_cast<size_t>(m.rows)));
+  m.row_splits.assign(1, 0);
+  const size_t nnz = m.non_zeros();
+  for (size_t i = 1; i < tasks; ++i) {
+    const size_t target = nnz * i / tasks;
+    const int row = static_cast<int>(
+        std::lower_bound(m.row_ptr.begin(), m.row_ptr.end(), target) - m.row_ptr.begin());
+    if (row > m.row_splits.back() && row < m.rows) m.row_splits.push_back(row);
+  }
+  m.row_splits.push_back(m.rows);
+}
+
+// y[first, last) = A x 的对应行
+inline void spmv_rows(const CsrMatrix& m, const double* x, double* y, int first, int last) {
+  const size_t* row_ptr = m.row_ptr.data();
+  const int* col_idx = m.col_idx.data();
+  const double* values = m.values.data();
+  for (int r = first; r < last; ++r) {
+    double sum = 0.0;
+    for (size_t i = row_ptr[r], end = row_ptr[r + 1]; i < end; ++i) {
+      sum += values[i] * x[col_idx[i]];
+    }
+    y[r] = sum;
+  }
+}
+
+// y = A x, 单线程
+inline void spmv(const CsrMatrix& m, const Eigen::VectorXd& x, Eigen::VectorXd& y) {
+  y.resize(m.rows);
+  spmv_rows(m, x.data(), y.data(), 0, m.rows);
+}
+
+// y = A x, 在线程池上按 row_splits 并行; 每行只被一个任务写, 无需同步
+inline void spmv(const CsrMatrix& m, const Eigen::VectorXd& x, Eigen::VectorXd& y,
+                 cpp_features::ThreadPool& pool) {
+  y.resize(m.rows);
+  if (m.row_splits.size() < 2) {
+    spmv_rows(m, x.data(), y.data(), 0, m.rows);
+    return;
+  }
+  const double* in = x.data();
+  double* out = y.data();
+  pool.parallel_for(m.row_splits.size() - 1, [&](size_t task) {
+    spmv_rows(m, in, out, m.row_splits[task], m.row_splits[task + 1]);
+  });
+}
+
+// COO直接相乘 (散射写 y), 作为不做格式转换时的参照
+inline void spmv_coo(const Triplets& coo, const Eigen::VectorXd& x, Eigen::VectorXd& y,
+                     int rows) {
+  y.setZero(rows);
+  for (const auto& t : coo) y[t.row()] += t.value() * x[t.col()];
+}
+
+}  // namespace sparse_bench
+
+#endif  // CPP_FEATURES_EIGEN_SPARSE_CSR_H
@@ -1,14 +1,26 @@
+#include <charconv>
 #include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
 #include <iostream>
+#include <iterator>
 #include <map>
+#include <sstream>
+#include <string>
 #include <vector>
 
 #include <fmt/chrono.h>
 #include <fmt/color.h>
+#include <fmt/compile.h>
 #include <fmt/core.h>
 #include <fmt/format.h>
 #include <fmt/ranges.h>
 
+#include "alloc_tracker.h"
+#include "number_format.h"
+
 void demo_basic_formatting() {
   fmt::print("=== Basic Formatting Examples ===\n");
 
@@ -120,34 +132,246 @@ void demo_custom_formatting() {
   fmt::print("Point: {}\n", format_point(point));
 }
 
-void demo_performance_comparison() {
-  fmt::print("\n=== Performance Comparison ===\n");
+namespace {
+
+// One row of the formatting benchmark: time per call and heap allocations per
+// call (allocations need the alloc_tracking build option)
+struct BenchResult {
+  double ns_per_op = 0;
+  double allocs_per_op = 0;
+  size_t checksum = 0;
+};
+
+// Runs `format_once` `iterations` times; it returns the formatted length, which
+// is summed so the optimiser cannot drop the work
+template <typename F>
+BenchResult run_format_bench(size_t iterations, F format_once) {
+  BenchResult result;
+  cpp_features::AllocScope scope;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; ++i) result.checksum += format_once(i);
+  std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+  result.ns_per_op = elapsed.count() / static_cast<double>(iterations);
+  result.allocs_per_op =
+      static_cast<double>(scope.stats().allocations) / static_cast<double>(iterations);
+  return result;
+}
+
+void print_bench_header(const char* baseline_column) {
+  fmt::print("  {:<36} {:>9} {:>9}", "variant", "ns/op", baseline_column);
+  if (cpp_features::alloc_tracking::enabled()) fmt::print(" {:>12}", "allocs/op");
+  fmt::print("\n");
+}
 
-  const int iterations = 100000;
-  std::string name = "Performance Test";
-  int value = 42;
+void print_bench_row(const char* name, const BenchResult& result, double baseline_ns) {
+  fmt::print("  {:<36} {:>9.1f} {:>8.2f}x", name, result.ns_per_op,
+             baseline_ns / result.ns_per_op);
+  if (cpp_features::alloc_tracking::enabled()) {
+    fmt::print(" {:>12.2f}", result.allocs_per_op);
+  }
+  fmt::print("\n");
+}
 
-  // fmt::format timing
-  auto start = std::chrono::high_resolution_clock::now();
-  for (int i = 0; i < iterations; ++i) {
-    auto result = fmt::format("Name: {}, Value: {}", name, value);
-    (void)result;  // Suppress unused variable warning
+size_t env_count(const char* name, size_t fallback) {
+  if (const char* env = std::getenv(name)) {
+    size_t count = std::strtoull(env, nullptr, 10);
+    if (count > 0) return count;
   }
-  auto fmt_time = std::chrono::high_resolution_clock::now() - start;
+  return fallback;
+}
+
+// splitmix64: cheap, deterministic stream of benchmark inputs
+uint64_t mix_bits(uint64_t i) {
+  uint64_t z = i * 0x9e3779b97f4a7c15ULL + 0x9e3779b97f4a7c15ULL;
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+// Signed integers of every length from 1 to 19 digits
+int64_t bench_integer(size_t i) {
+  uint64_t bits = mix_bits(i);
+  return static_cast<int64_t>(bits) >> (bits & 63);
+}
+
+// Doubles with full 53-bit mantissas spread over 2^-32 .. 2^31
+double bench_double(size_t i) {
+  uint64_t bits = mix_bits(i);
+  return std::ldexp(static_cast<double>(bits >> 11), static_cast<int>(bits & 63) - 85);
+}
 
-  // printf timing for comparison
-  start = std::chrono::high_resolution_clock::now();
-  for (int i = 0; i < iterations; ++i) {
-    char buffer[256];
-    snprintf(buffer, sizeof(buffer), "Name: %s, Value: %d", name.c_str(), value);
+}  // namespace
+
+void demo_performance_comparison() {
+  fmt::print("\n=== Performance Comparison ===\n");
+
+  const size_t iterations = env_count("FMT_BENCH_ITERATIONS", 1000000);
+  const std::string name = "Performance Test";
+  const double ratio = 0.8125;
+
+  fmt::print("{} calls per variant, \"Name: {{}}, Value: {{}}, Ratio: {{:.3f}}\"\n", iterations);
+  print_bench_header("vs printf");
+
+  // Baseline: snprintf into a stack buffer
+  BenchResult printf_result = run_format_bench(iterations, [&](size_t i) {
+    char buffer[64];
+    int size = std::snprintf(buffer, sizeof(buffer), "Name: %s, Value: %d, Ratio: %.3f",
+                             name.c_str(), static_cast<int>(i), ratio);
+    return static_cast<size_t>(size);
+  });
+  const double baseline = printf_result.ns_per_op;
+  print_bench_row("snprintf (stack buffer)", printf_result, baseline);
+
+  // fmt::format parses the format string at run time and returns a new string
+  print_bench_row("fmt::format", run_format_bench(iterations, [&](size_t i) {
+                    return fmt::format("Name: {}, Value: {}, Ratio: {:.3f}", name, i, ratio)
+                        .size();
+                  }),
+                  baseline);
+
+  // FMT_COMPILE turns the format string into specialised code at compile time
+  print_bench_row("fmt::format(FMT_COMPILE)", run_format_bench(iterations, [&](size_t i) {
+                    return fmt::format(FMT_COMPILE("Name: {}, Value: {}, Ratio: {:.3f}"), name,
+                                       i, ratio)
+                        .size();
+                  }),
+                  baseline);
+
+  // A reused memory_buffer keeps its storage, so steady state never allocates
+  fmt::memory_buffer buffer;
+  print_bench_row("fmt::format_to(memory_buffer)", run_format_bench(iterations, [&](size_t i) {
+                    buffer.clear();
+                    fmt::format_to(std::back_inserter(buffer),
+                                   "Name: {}, Value: {}, Ratio: {:.3f}", name, i, ratio);
+                    return buffer.size();
+                  }),
+                  baseline);
+
+  print_bench_row("fmt::format_to(buffer, FMT_COMPILE)",
+                  run_format_bench(iterations,
+                                   [&](size_t i) {
+                                     buffer.clear();
+                                     fmt::format_to(
+                                         std::back_inserter(buffer),
+                                         FMT_COMPILE("Name: {}, Value: {}, Ratio: {:.3f}"), name,
+                                         i, ratio);
+                                     return buffer.size();
+                                   }),
+                  baseline);
+
+  // format_to_n writes into a fixed stack buffer and truncates instead of growing
+  print_bench_row("fmt::format_to_n(char[64])", run_format_bench(iterations, [&](size_t i) {
+                    char out[64];
+                    auto result = fmt::format_to_n(out, sizeof(out),
+                                                   "Name: {}, Value: {}, Ratio: {:.3f}", name,
+                                                   i, ratio);
+                    return static_cast<size_t>(result.out - out);
+                  }),
+                  baseline);
+
+  print_bench_row("fmt::format_to_n(char[64], COMPILE)",
+                  run_format_bench(iterations,
+                                   [&](size_t i) {
+                                     char out[64];
+                                     auto result = fmt::format_to_n(
+                                         out, sizeof(out),
+                                         FMT_COMPILE("Name: {}, Value: {}, Ratio: {:.3f}"), name,
+                                         i, ratio);
+                                     return static_cast<size_t>(result.out - out);
+                                   }),
+                  baseline);
+
+  // FMT_COMPILE only pays off with a growable output: format_to_n wraps the
+  // destination in a truncating iterator that the compiled path writes through
+  // one character at a time
+  fmt::print("Hot paths: FMT_COMPILE + format_to into a reused memory_buffer (no allocation).\n");
+  fmt::print("fmt::format is fine where a std::string is needed anyway.\n");
+  if (!cpp_features::alloc_tracking::enabled()) {
+    fmt::print("(configure with xmake f --alloc_tracking=y to also report allocations per call)\n");
   }
-  auto printf_time = std::chrono::high_resolution_clock::now() - start;
+}
 
-  fmt::print("fmt::format time: {}\n", fmt_time);
-  fmt::print("printf time: {}\n", printf_time);
-  fmt::print("fmt is {:.2f}x {} than printf\n",
-             std::chrono::duration<double>(printf_time) / std::chrono::duration<double>(fmt_time),
-             (fmt_time < printf_time) ? "faster" : "slower");
+// Number-to-text kernels behind cpp_features::Demo::print_value, against the
+// usual alternatives. Every variant formats the same inputs.
+void demo_number_formatting_kernels() {
+  fmt::print("\n=== Number Formatting Kernels ===\n");
+
+  const size_t count = env_count("FMT_NUMBER_VALUES", 10000000);
+  std::ostringstream stream;
+  char out[cpp_features::number_format::kMaxChars];
+  auto stream_length = [&stream] { return static_cast<size_t>(stream.tellp()); };
+
+  fmt::print("{} integers (1-19 digits, both signs)\n", count);
+  print_bench_header("vs stream");
+  BenchResult stream_int = run_format_bench(count, [&](size_t i) {
+    stream.seekp(0);
+    stream << bench_integer(i);
+    return stream_length();
+  });
+  const double int_baseline = stream_int.ns_per_op;
+  print_bench_row("(generating inputs only)", run_format_bench(count, [](size_t i) {
+                    return static_cast<size_t>(bench_integer(i) & 1);
+                  }),
+                  int_baseline);
+  print_bench_row("std::ostringstream <<", stream_int, int_baseline);
+  print_bench_row("std::to_string", run_format_bench(count, [&](size_t i) {
+                    return std::to_string(bench_integer(i)).size();
+                  }),
+                  int_baseline);
+  print_bench_row("fmt::format_to(char*, \"{}\")", run_format_bench(count, [&](size_t i) {
+                    return static_cast<size_t>(fmt::format_to(out, "{}", bench_integer(i)) - out);
+                  }),
+                  int_baseline);
+  print_bench_row("fmt::format_int", run_format_bench(count, [&](size_t i) {
+                    return fmt::format_int(bench_integer(i)).size();
+                  }),
+                  int_baseline);
+  print_bench_row("std::to_chars", run_format_bench(count, [&](size_t i) {
+                    return static_cast<size_t>(
+                        std::to_chars(out, out + sizeof(out), bench_integer(i)).ptr - out);
+                  }),
+                  int_baseline);
+  print_bench_row("number_format::format_number", run_format_bench(count, [&](size_t i) {
+                    return static_cast<size_t>(
+                        cpp_features::number_format::format_number(out, bench_integer(i)) - out);
+                  }),
+                  int_baseline);
+
+  // Only the last three print the shortest text that reads back exactly;
+  // the stream needs precision 17 to round-trip and to_string is "%f"
+  fmt::print("{} doubles (53-bit mantissa, 2^-32 .. 2^31)\n", count);
+  print_bench_header("vs stream");
+  stream.precision(17);
+  BenchResult stream_double = run_format_bench(count, [&](size_t i) {
+    stream.seekp(0);
+    stream << bench_double(i);
+    return stream_length();
+  });
+  const double double_baseline = stream_double.ns_per_op;
+  print_bench_row("(generating inputs only)", run_format_bench(count, [](size_t i) {
+                    return static_cast<size_t>(bench_double(i) > 1.0);
+                  }),
+                  double_baseline);
+  print_bench_row("std::ostringstream << (prec. 17)", stream_double, double_baseline);
+  print_bench_row("std::to_string (%f, lossy)", run_format_bench(count, [&](size_t i) {
+                    return std::to_string(bench_double(i)).size();
+                  }),
+                  double_baseline);
+  print_bench_row("fmt::format_to(char*, \"{}\")", run_format_bench(count, [&](size_t i) {
+                    return static_cast<size_t>(fmt::format_to(out, "{}", bench_double(i)) - out);
+                  }),
+                  double_baseline);
+  print_bench_row("std::to_chars", run_format_bench(count, [&](size_t i) {
+                    return static_cast<size_t>(
+                        std::to_chars(out, out + sizeof(out), bench_double(i)).ptr - out);
+                  }),
+                  double_baseline);
+  print_bench_row("number_format::format_number", run_format_bench(count, [&](size_t i) {
+                    return static_cast<size_t>(
+                        cpp_features::number_format::format_number(out, bench_double(i)) - out);
+                  }),
+                  double_baseline);
+  fmt::print("(FMT_NUMBER_VALUES sets the count, e.g. 100000000 for 1e8 values)\n");
 }
 
 void demo_error_handling() {
@@ -178,6 +402,7 @@ int main() {
   demo_container_formatting();
   demo_custom_formatting();
   demo_performance_comparison();
+  demo_number_formatting_kernels();
   demo_error_handling();
 
   fmt::print("\n✅ FMT library examples completed!\n");
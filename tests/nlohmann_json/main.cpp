@@ -1,5 +1,11 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <iterator>
 #include <map>
 #include <optional>
 #include <string>
@@ -7,6 +13,9 @@
 
 #include <nlohmann/json.hpp>
 
+#include "json_codec.h"
+#include "json_fields.h"
+
 // 使用便捷别名
 using json = nlohmann::json;
 
@@ -21,25 +30,9 @@ struct Person {
   Person(const std::string& n, int a) : name(n), age(a) {}
 };
 
-// 为Person类定义JSON序列化
-void to_json(json& j, const Person& p) {
-  j = json{{"name", p.name}, {"age", p.age}, {"hobbies", p.hobbies}};
-  if (p.email) {
-    j["email"] = *p.email;
-  }
-}
-
-// 为Person类定义JSON反序列化
-void from_json(const json& j, Person& p) {
-  j.at("name").get_to(p.name);
-  j.at("age").get_to(p.age);
-  j.at("hobbies").get_to(p.hobbies);
-
-  // 可选字段
-  if (j.contains("email")) {
-    p.email = j.at("email").get<std::string>();
-  }
-}
+// 字段描述生成 to_json/from_json 以及不经过DOM的文本编解码 (json_fields.h);
+// email 为 std::optional, 为空时不输出, 读取时可以缺省
+CPP_FEATURES_JSON_FIELDS(Person, name, age, hobbies, email)
 
 void demo_basic_json_operations() {
   std::cout << "\n=== 基础JSON操作 ===\n";
@@ -201,6 +194,9 @@ void demo_custom_serialization() {
   std::cout << "  Person1 JSON:\n" << j1.dump(2) << "\n\n";
   std::cout << "  Person2 JSON:\n" << j2.dump(2) << "\n\n";
 
+  // 直接写出文本, 字段按声明顺序
+  std::cout << "  Person1 直接编码: " << cpp_features::to_json_text(person1) << "\n\n";
+
   // 从JSON反序列化
   std::string person_json = R"({
         "name": "Eve Adams",
@@ -225,6 +221,10 @@ void demo_custom_serialization() {
       std::cout << "    邮箱: " << *person3.email << "\n";
     }
 
+    // 同一段文本直接解码, 键通过编译期完美哈希分派
+    const Person person4 = cpp_features::from_json_text<Person>(person_json);
+    std::cout << "    直接解码: " << person4.name << ", " << person4.age << "岁\n";
+
   } catch (const std::exception& e) {
     std::cout << "  ❌ 反序列化错误: " << e.what() << "\n";
   }
@@ -268,8 +268,8 @@ void demo_json_manipulation() {
   std::cout << "    连接超时 (默认): " << timeout << "\n";
 }
 
-void demo_json_file_io() {
-  std::cout << "\n=== JSON文件读写 ===\n";
+void demo_json_file_io(cpp_features::JsonFormat format) {
+  std::cout << "\n=== JSON文件读写 (" << cpp_features::json_format_name(format) << ") ===\n";
 
   // 创建测试数据
   json test_data = {
@@ -278,21 +278,31 @@ void demo_json_file_io() {
       {"settings", {{"theme", "dark"}, {"language", "en"}, {"auto_save", true}}},
       {"recent_files", {"/path/to/file1.txt", "/path/to/file2.txt", "/path/to/file3.txt"}}};
 
-  // 写入文件
+  const std::string filename =
+      std::string("test_config.") + cpp_features::json_format_extension(format);
+
+  // 写入文件: 文本格式保持缩进便于阅读, 二进制格式按字节写出
   try {
-    std::ofstream file("test_config.json");
-    file << test_data.dump(2);
-    file.close();
+    if (format == cpp_features::JsonFormat::kText) {
+      std::ofstream file(filename);
+      file << test_data.dump(2);
+    } else {
+      const auto bytes = cpp_features::encode_json(test_data, format);
+      std::ofstream file(filename, std::ios::binary);
+      file.write(reinterpret_cast<const char*>(bytes.data()),
+                 static_cast<std::streamsize>(bytes.size()));
+    }
 
-    std::cout << "  ✅ JSON已写入 test_config.json\n";
+    std::cout << "  ✅ JSON已写入 " << filename << "\n";
 
     // 从文件读取
-    std::ifstream input_file("test_config.json");
-    json loaded_data;
-    input_file >> loaded_data;
+    std::ifstream input_file(filename, std::ios::binary);
+    std::vector<std::uint8_t> bytes((std::istreambuf_iterator<char>(input_file)),
+                                    std::istreambuf_iterator<char>());
     input_file.close();
+    json loaded_data = cpp_features::decode_json<json>(bytes, format);
 
-    std::cout << "  ✅ JSON已从文件读取\n";
+    std::cout << "  ✅ JSON已从文件读取 (" << bytes.size() << " 字节)\n";
     std::cout << "  应用程序: " << loaded_data["application"] << "\n";
     std::cout << "  主题: " << loaded_data["settings"]["theme"] << "\n";
 
@@ -308,6 +318,79 @@ void demo_json_file_io() {
   }
 }
 
+// 各编码格式的体积和编解码吞吐, 数据集为 {"people": [Person...]}.
+// 人数默认1e5, 可用 JSON_BENCH_PEOPLE 调整
+void demo_binary_formats() {
+  std::cout << "\n=== 二进制编码对比 (CBOR / MessagePack / UBJSON / BSON) ===\n";
+
+  size_t count = 100000;
+  if (const char* env = std::getenv("JSON_BENCH_PEOPLE")) {
+    count = std::max<size_t>(std::strtoull(env, nullptr, 10), 1);
+  }
+
+  const std::vector<std::string> names = {"Alice", "Bob", "Charlie", "Diana", "Eve", "Frank"};
+  const std::vector<std::string> hobbies = {"reading", "swimming", "coding", "chess", "hiking"};
+  std::vector<Person> people;
+  people.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    Person p(names[i % names.size()] + "_" + std::to_string(i), 18 + static_cast<int>(i % 50));
+    for (size_t h = 0; h < 1 + i % 3; ++h) p.hobbies.push_back(hobbies[(i + h) % hobbies.size()]);
+    if (i % 2 == 0) p.email = "user" + std::to_string(i) + "@example.com";
+    people.push_back(std::move(p));
+  }
+  const json dataset = {{"people", people}};
+
+  // 三次取最快, 减少单次抖动
+  auto time_ms = [](auto&& f) {
+    double best = 0.0;
+    for (int run = 0; run < 3; ++run) {
+      auto start = std::chrono::steady_clock::now();
+      f();
+      const double ms =
+          std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+              .count();
+      if (run == 0 || ms < best) best = ms;
+    }
+    return best;
+  };
+
+  std::cout << "  " << count << " 个Person\n";
+  std::cout << "  " << std::left << std::setw(10) << "格式" << std::right << std::setw(12)
+            << "字节" << std::setw(10) << "相对" << std::setw(14) << "编码MB/s" << std::setw(14)
+            << "解码MB/s" << "\n";
+
+  const std::ios_base::fmtflags flags = std::cout.flags();
+  const std::streamsize precision = std::cout.precision();
+  size_t text_bytes = 0;
+  double best_ms = 0.0;
+  cpp_features::JsonFormat best = cpp_features::JsonFormat::kText;
+  for (cpp_features::JsonFormat format : cpp_features::kAllJsonFormats) {
+    std::vector<std::uint8_t> bytes;
+    json decoded;
+    const double encode_ms = time_ms([&] { bytes = cpp_features::encode_json(dataset, format); });
+    const double decode_ms =
+        time_ms([&] { decoded = cpp_features::decode_json<json>(bytes, format); });
+    if (format == cpp_features::JsonFormat::kText) text_bytes = bytes.size();
+
+    // 吞吐按文本JSON的大小折算, 各格式处理的是同一份数据
+    const double mb = text_bytes / (1024.0 * 1024.0);
+    std::cout << "  " << std::left << std::setw(10) << cpp_features::json_format_name(format)
+              << std::right << std::setw(12) << bytes.size() << std::setw(9) << std::fixed
+              << std::setprecision(2) << static_cast<double>(bytes.size()) / text_bytes << "x"
+              << std::setw(14) << std::setprecision(1) << mb / (encode_ms / 1000.0)
+              << std::setw(14) << mb / (decode_ms / 1000.0)
+              << (decoded == dataset ? "" : "  ❌ 往返不一致") << "\n";
+
+    if (best_ms == 0.0 || encode_ms + decode_ms < best_ms) {
+      best_ms = encode_ms + decode_ms;
+      best = format;
+    }
+  }
+  std::cout << "  编解码总耗时最短: " << cpp_features::json_format_name(best) << "\n";
+  std::cout.flags(flags);
+  std::cout.precision(precision);
+}
+
 void demo_advanced_features() {
   std::cout << "\n=== 高级特性 ===\n";
 
@@ -340,7 +423,8 @@ void demo_advanced_features() {
   std::cout << "\n  合并后的数据:\n" << data.dump(2) << "\n";
 }
 
-int main() {
+// 用法: json_example [--format=text|cbor|msgpack|ubjson|bson]
+int main(int argc, char** argv) {
   std::cout << "🚀 nlohmann/json 现代C++ JSON库演示\n";
   std::cout << "====================================\n";
 
@@ -351,8 +435,9 @@ int main() {
     demo_json_parsing();
     demo_custom_serialization();
     demo_json_manipulation();
-    demo_json_file_io();
+    demo_json_file_io(cpp_features::json_format_from_args(argc, argv));
     demo_advanced_features();
+    demo_binary_formats();
 
     std::cout << "\n✅ nlohmann/json 演示完成!\n";
     std::cout << "\n📚 主要特性:\n";
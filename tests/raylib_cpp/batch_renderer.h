@@ -0,0 +1,130 @@
+#ifndef CPP_FEATURES_RAYLIB_BATCH_RENDERER_H
+#define CPP_FEATURES_RAYLIB_BATCH_RENDERER_H
+
+#include <algorithm>
+#include <cstddef>
+
+#include "particle_system.h"
+#include "raylib.h"
+#include "rlgl.h"
+
+// 批量精灵渲染:
+// - 粒子: 每个粒子是一个贴了圆形纹理的四边形 (4个顶点), 全部写进一个专用的
+//   rlRenderBatch 顶点缓冲, 一帧一次 draw call; DrawCircleV 每个圆要36段,
+//   顶点数是它的十几倍, 而且 raylib 默认批次 (8192个四边形) 满了就要提交一次
+// - 球: 本体和两层光晕预先画进一张纹理, 每帧一个四边形, 代替三次 DrawCircleV
+// 要创建纹理和GL缓冲, 必须在 InitWindow 之后构造, CloseWindow 之前析构.
+
+class BatchRenderer {
+ public:
+  // 顶点缓冲按 max_quads 个四边形分配; 超过时分段提交
+  static constexpr int kDefaultMaxQuads = 1 << 17;
+
+  // rlgl 在顶点数接近容量时会自行提交, 所以批次多留一个四边形的余量
+  explicit BatchRenderer(float glow_radius, int max_quads = kDefaultMaxQuads)
+      : batch_(rlLoadRenderBatch(1, max_quads + 1)),
+        max_quads_(max_quads),
+        circle_(make_circle_texture()),
+        glow_(make_glow_texture(glow_radius)) {}
+
+  BatchRenderer(const BatchRenderer&) = delete;
+  BatchRenderer& operator=(const BatchRenderer&) = delete;
+
+  ~BatchRenderer() {
+    UnloadTexture(glow_);
+    UnloadTexture(circle_);
+    rlUnloadRenderBatch(batch_);
+  }
+
+  struct Circle {
+    Vector2 center;
+    float radius;
+    Color color;
+  };
+
+  // 快照里所有可见粒子画成边长 2 * radius 的四边形
+  void draw_particles(const ParticleRenderBuffer& frame, float radius) {
+    draw_circles(frame.count, [&](size_t i) {
+      return Circle{frame.position[i], radius, frame.color[i]};
+    });
+  }
+
+  // 通用版本: circle_at(i) 给出第 i 个圆, alpha 为0的跳过
+  template <typename CircleAt>
+  void draw_circles(size_t count, CircleAt&& circle_at) {
+    // 切换到专用批次时 rlgl 会先提交默认批次里已有的内容, 绘制顺序不变
+    rlSetRenderBatchActive(&batch_);
+    draw_calls_ = 0;
+    size_t i = 0;
+    while (i < count) {
+      const size_t end = std::min(count, i + static_cast<size_t>(max_quads_));
+      rlSetTexture(circle_.id);
+      rlBegin(RL_QUADS);
+      for (; i < end; ++i) {
+        const Circle circle = circle_at(i);
+        const Color c = circle.color;
+        if (c.a == 0) continue;
+        const Vector2 p = circle.center;
+        const float radius = circle.radius;
+        rlColor4ub(c.r, c.g, c.b, c.a);
+        rlTexCoord2f(0.0f, 0.0f);
+        rlVertex2f(p.x - radius, p.y - radius);
+        rlTexCoord2f(0.0f, 1.0f);
+        rlVertex2f(p.x - radius, p.y + radius);
+        rlTexCoord2f(1.0f, 1.0f);
+        rlVertex2f(p.x + radius, p.y + radius);
+        rlTexCoord2f(1.0f, 0.0f);
+        rlVertex2f(p.x + radius, p.y - radius);
+      }
+      rlEnd();
+      rlSetTexture(0);
+      ++draw_calls_;
+      if (i < count) rlDrawRenderBatch(&batch_);
+    }
+    // 切回默认批次时提交最后一段
+    rlSetRenderBatchActive(nullptr);
+  }
+
+  // 带光晕的球, 中心在 center; 纹理是白色的, 由 color 着色
+  void draw_glow_ball(Vector2 center, Color color) const {
+    DrawTextureV(glow_, Vector2{center.x - glow_.width / 2.0f, center.y - glow_.height / 2.0f},
+                 color);
+  }
+
+  // 上一次 draw_particles / draw_circles 提交的 draw call 数
+  int last_draw_calls() const { return draw_calls_; }
+
+ private:
+  rlRenderBatch batch_;
+  int max_quads_;
+  Texture2D circle_;
+  Texture2D glow_;
+  int draw_calls_ = 0;
+
+  // 粒子缩得很小, 用32像素的圆加双线性过滤, 边缘比较平滑
+  static Texture2D make_circle_texture() {
+    Image image = GenImageColor(32, 32, BLANK);
+    ImageDrawCircle(&image, 16, 16, 15, WHITE);
+    Texture2D texture = LoadTextureFromImage(image);
+    UnloadImage(image);
+    SetTextureFilter(texture, TEXTURE_FILTER_BILINEAR);
+    return texture;
+  }
+
+  // 与原来的三次绘制合成结果一致: 本体不透明, radius+2 以内 alpha 0.3 叠 0.1
+  // (合成后约0.37), radius+4 以内 0.1. 图像上直接画圆是覆盖而不是混合, 所以从外往里画
+  static Texture2D make_glow_texture(float radius) {
+    const int r = static_cast<int>(radius);
+    const int size = 2 * (r + 4) + 1;
+    const int center = r + 4;
+    Image image = GenImageColor(size, size, BLANK);
+    ImageDrawCircle(&image, center, center, r + 4, Color{255, 255, 255, 26});
+    ImageDrawCircle(&image, center, center, r + 2, Color{255, 255, 255, 94});
+    ImageDrawCircle(&image, center, center, r, WHITE);
+    Texture2D texture = LoadTextureFromImage(image);
+    UnloadImage(image);
+    return texture;
+  }
+};
+
+#endif  // CPP_FEATURES_RAYLIB_BATCH_RENDERER_H
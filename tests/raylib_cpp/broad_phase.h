@@ -0,0 +1,281 @@
+#ifndef CPP_FEATURES_RAYLIB_BROAD_PHASE_H
+#define CPP_FEATURES_RAYLIB_BROAD_PHASE_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "fast_rng.h"
+
+// 大量圆形物体的碰撞检测, 与 raylib 无关. 三种方法找出所有相交的圆对 (i < j):
+// - brute_force_pairs: 两两检查, O(n^2), 作为基准和正确性参照
+// - UniformGrid: 均匀网格, 格子边长不小于最大直径, 相交的圆一定在同一格或相邻格;
+//   按格子计数排序后每个格子只和自己以及右、左下、下、右下四个邻格比较, 每对只查一次
+// - SweepAndPrune: 按包围盒左边界排序, 沿x轴扫描, 只比较x区间重叠的物体
+// 回调 f(i, j) 对每个相交对调用一次, 返回值是实际做了精确检测的候选对数.
+
+namespace collision {
+
+// SoA存储的圆形物体
+struct Bodies {
+  std::vector<float> x, y;
+  std::vector<float> vx, vy;
+  std::vector<float> radius;
+
+  size_t size() const { return x.size(); }
+
+  void add(float px, float py, float pvx, float pvy, float r) {
+    x.push_back(px);
+    y.push_back(py);
+    vx.push_back(pvx);
+    vy.push_back(pvy);
+    radius.push_back(r);
+  }
+
+  float max_radius() const {
+    return radius.empty() ? 0.0f : *std::max_element(radius.begin(), radius.end());
+  }
+};
+
+inline bool circles_overlap(float dx, float dy, float r) { return dx * dx + dy * dy < r * r; }
+
+template <typename F>
+size_t brute_force_pairs(const Bodies& bodies, F&& f) {
+  const size_t n = bodies.size();
+  const float* x = bodies.x.data();
+  const float* y = bodies.y.data();
+  const float* r = bodies.radius.data();
+  for (size_t i = 0; i < n; ++i) {
+    for (size_t j = i + 1; j < n; ++j) {
+      if (circles_overlap(x[j] - x[i], y[j] - y[i], r[i] + r[j])) f(i, j);
+    }
+  }
+  return n < 2 ? 0 : n * (n - 1) / 2;
+}
+
+class UniformGrid {
+ public:
+  // 覆盖 [0, width) x [0, height); cell_size 不能小于最大直径.
+  // 超出范围的物体归入边上的格子, 结果仍然正确, 只是变慢
+  UniformGrid(float width, float height, float cell_size)
+      : cell_size_(cell_size),
+        inv_cell_(1.0f / cell_size),
+        cols_(std::max(1, static_cast<int>(std::ceil(width / cell_size)))),
+        rows_(std::max(1, static_cast<int>(std::ceil(height / cell_size)))),
+        cell_start_(static_cast<size_t>(cols_) * rows_ + 1) {}
+
+  float cell_size() const { return cell_size_; }
+
+  // 计数排序: 第c格的物体是排序后的 [cell_start_[c], cell_start_[c+1]);
+  // 坐标和半径按格子顺序复制一份, 查询时顺序读取
+  void build(const Bodies& bodies) {
+    const size_t n = bodies.size();
+    cell_of_.resize(n);
+    std::fill(cell_start_.begin(), cell_start_.end(), 0);
+    for (size_t i = 0; i < n; ++i) {
+      cell_of_[i] = cell_index(bodies.x[i], bodies.y[i]);
+      ++cell_start_[cell_of_[i] + 1];
+    }
+    for (size_t c = 1; c < cell_start_.size(); ++c) cell_start_[c] += cell_start_[c - 1];
+
+    order_.resize(n);
+    sorted_x_.resize(n);
+    sorted_y_.resize(n);
+    sorted_r_.resize(n);
+    cursor_.assign(cell_start_.begin(), cell_start_.end() - 1);
+    for (size_t i = 0; i < n; ++i) {
+      const uint32_t at = cursor_[cell_of_[i]]++;
+      order_[at] = static_cast<uint32_t>(i);
+      sorted_x_[at] = bodies.x[i];
+      sorted_y_[at] = bodies.y[i];
+      sorted_r_[at] = bodies.radius[i];
+    }
+  }
+
+  // 用最近一次 build 时的位置查询
+  template <typename F>
+  size_t for_each_overlap(F&& f) const {
+    size_t tested = 0;
+    for (int row = 0; row < rows_; ++row) {
+      for (int col = 0; col < cols_; ++col) {
+        const size_t cell = static_cast<size_t>(row) * cols_ + col;
+        const uint32_t begin = cell_start_[cell];
+        const uint32_t end = cell_start_[cell + 1];
+        if (begin == end) continue;
+        // 格内两两
+        for (uint32_t a = begin; a < end; ++a) {
+          tested += test_range(a, a + 1, end, f);
+        }
+        // 右, 左下, 下, 右下
+        const bool has_right = col + 1 < cols_;
+        const bool has_below = row + 1 < rows_;
+        if (has_right) tested += test_cells(begin, end, cell + 1, f);
+        if (has_below) {
+          const size_t below = cell + cols_;
+          if (col > 0) tested += test_cells(begin, end, below - 1, f);
+          tested += test_cells(begin, end, below, f);
+          if (has_right) tested += test_cells(begin, end, below + 1, f);
+        }
+      }
+    }
+    return tested;
+  }
+
+ private:
+  float cell_size_;
+  float inv_cell_;
+  int cols_, rows_;
+  std::vector<uint32_t> cell_start_;
+  std::vector<uint32_t> cell_of_;
+  std::vector<uint32_t> cursor_;
+  std::vector<uint32_t> order_;
+  std::vector<float> sorted_x_, sorted_y_, sorted_r_;
+
+  uint32_t cell_index(float x, float y) const {
+    const int col = std::min(cols_ - 1, std::max(0, static_cast<int>(x * inv_cell_)));
+    const int row = std::min(rows_ - 1, std::max(0, static_cast<int>(y * inv_cell_)));
+    return static_cast<uint32_t>(row * cols_ + col);
+  }
+
+  // 排序后的第a个物体与 [first, last) 逐个比较
+  template <typename F>
+  size_t test_range(uint32_t a, uint32_t first, uint32_t last, F& f) const {
+    const float ax = sorted_x_[a], ay = sorted_y_[a], ar = sorted_r_[a];
+    for (uint32_t b = first; b < last; ++b) {
+      if (circles_overlap(sorted_x_[b] - ax, sorted_y_[b] - ay, ar + sorted_r_[b])) {
+        const uint32_t i = order_[a], j = order_[b];
+        if (i < j) {
+          f(i, j);
+        } else {
+          f(j, i);
+        }
+      }
+    }
+    return last - first;
+  }
+
+  template <typename F>
+  size_t test_cells(uint32_t begin, uint32_t end, size_t other, F& f) const {
+    const uint32_t other_begin = cell_start_[other];
+    const uint32_t other_end = cell_start_[other + 1];
+    if (other_begin == other_end) return 0;
+    size_t tested = 0;
+    for (uint32_t a = begin; a < end; ++a) tested += test_range(a, other_begin, other_end, f);
+    return tested;
+  }
+};
+
+class SweepAndPrune {
+ public:
+  // 每次重新排序; 帧间物体移动不大时 std::sort 在近乎有序的输入上也很快
+  template <typename F>
+  size_t for_each_overlap(const Bodies& bodies, F&& f) {
+    const size_t n = bodies.size();
+    order_.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+      order_[i] = Entry{bodies.x[i] - bodies.radius[i], static_cast<uint32_t>(i)};
+    }
+    std::sort(order_.begin(), order_.end(),
+              [](const Entry& a, const Entry& b) { return a.min_x < b.min_x; });
+
+    size_t tested = 0;
+    for (size_t a = 0; a < n; ++a) {
+      const uint32_t i = order_[a].index;
+      const float max_x = bodies.x[i] + bodies.radius[i];
+      for (size_t b = a + 1; b < n && order_[b].min_x < max_x; ++b) {
+        const uint32_t j = order_[b].index;
+        ++tested;
+        if (circles_overlap(bodies.x[j] - bodies.x[i], bodies.y[j] - bodies.y[i],
+                            bodies.radius[i] + bodies.radius[j])) {
+          if (i < j) {
+            f(i, j);
+          } else {
+            f(j, i);
+          }
+        }
+      }
+    }
+    return tested;
+  }
+
+ private:
+  struct Entry {
+    float min_x;
+    uint32_t index;
+  };
+  std::vector<Entry> order_;
+};
+
+// 相交的一对圆: 沿连心线按质量 (半径平方) 分开, 再施加法向冲量;
+// restitution 为恢复系数, 默认完全弹性, 总动能守恒
+inline void resolve_pair(Bodies& bodies, size_t i, size_t j, float restitution = 1.0f) {
+  const float dx = bodies.x[j] - bodies.x[i];
+  const float dy = bodies.y[j] - bodies.y[i];
+  const float distance = std::sqrt(dx * dx + dy * dy);
+  // 圆心重合时随便取一个方向分开
+  float nx = 1.0f, ny = 0.0f;
+  if (distance > 1e-6f) {
+    nx = dx / distance;
+    ny = dy / distance;
+  }
+  const float inv_i = 1.0f / (bodies.radius[i] * bodies.radius[i]);
+  const float inv_j = 1.0f / (bodies.radius[j] * bodies.radius[j]);
+  const float inv_sum = inv_i + inv_j;
+
+  const float penetration = bodies.radius[i] + bodies.radius[j] - distance;
+  bodies.x[i] -= nx * penetration * inv_i / inv_sum;
+  bodies.y[i] -= ny * penetration * inv_i / inv_sum;
+  bodies.x[j] += nx * penetration * inv_j / inv_sum;
+  bodies.y[j] += ny * penetration * inv_j / inv_sum;
+
+  const float approach = (bodies.vx[j] - bodies.vx[i]) * nx + (bodies.vy[j] - bodies.vy[i]) * ny;
+  if (approach >= 0) return;
+  const float impulse = -(1.0f + restitution) * approach / inv_sum;
+  bodies.vx[i] -= impulse * inv_i * nx;
+  bodies.vy[i] -= impulse * inv_i * ny;
+  bodies.vx[j] += impulse * inv_j * nx;
+  bodies.vy[j] += impulse * inv_j * ny;
+}
+
+// 在 width x height 内随机撒 count 个物体: 约十分之一是"球" (半径 ball_radius),
+// 其余是"粒子" (半径 particle_radius)
+inline Bodies scatter_bodies(size_t count, float width, float height, float ball_radius,
+                             float particle_radius, uint64_t seed) {
+  Bodies bodies;
+  FastRng rng(seed);
+  for (size_t i = 0; i < count; ++i) {
+    const float r = (rng.next() % 10 == 0) ? ball_radius : particle_radius;
+    bodies.add(rng.uniform(r, width - r), rng.uniform(r, height - r), rng.uniform(-120, 120),
+               rng.uniform(-120, 120), r);
+  }
+  return bodies;
+}
+
+// 多体模式的一步: 积分, 墙壁反弹, 网格宽相位 + 逐对响应; 返回相交对数
+inline size_t step_bodies(Bodies& bodies, UniformGrid& grid, float width, float height,
+                          float dt) {
+  for (size_t i = 0; i < bodies.size(); ++i) {
+    bodies.x[i] += bodies.vx[i] * dt;
+    bodies.y[i] += bodies.vy[i] * dt;
+    const float r = bodies.radius[i];
+    if ((bodies.x[i] < r && bodies.vx[i] < 0) || (bodies.x[i] > width - r && bodies.vx[i] > 0)) {
+      bodies.vx[i] = -bodies.vx[i];
+    }
+    if ((bodies.y[i] < r && bodies.vy[i] < 0) || (bodies.y[i] > height - r && bodies.vy[i] > 0)) {
+      bodies.vy[i] = -bodies.vy[i];
+    }
+  }
+  grid.build(bodies);
+  size_t pairs = 0;
+  grid.for_each_overlap([&](size_t i, size_t j) {
+    resolve_pair(bodies, i, j);
+    ++pairs;
+  });
+  return pairs;
+}
+
+}  // namespace collision
+
+#endif  // CPP_FEATURES_RAYLIB_BROAD_PHASE_H
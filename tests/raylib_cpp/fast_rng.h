@@ -0,0 +1,39 @@
+#ifndef CPP_FEATURES_RAYLIB_FAST_RNG_H
+#define CPP_FEATURES_RAYLIB_FAST_RNG_H
+
+#include <cstdint>
+
+// xorshift128+, 用 splitmix64 展开种子; 给粒子效果和游戏模拟用, 不追求统计质量.
+// 同一个种子总是产生同一个序列, 不依赖标准库实现
+class FastRng {
+ public:
+  explicit FastRng(uint64_t seed = 0x9e3779b97f4a7c15ULL) {
+    s0_ = splitmix(seed);
+    s1_ = splitmix(seed);
+  }
+
+  uint64_t next() {
+    uint64_t x = s0_;
+    const uint64_t y = s1_;
+    s0_ = y;
+    x ^= x << 23;
+    s1_ = x ^ y ^ (x >> 17) ^ (y >> 26);
+    return s1_ + y;
+  }
+
+  // [0, 1) 内的float, 取高24位
+  float next_float() { return static_cast<float>(next() >> 40) * (1.0f / 16777216.0f); }
+  float uniform(float lo, float hi) { return lo + (hi - lo) * next_float(); }
+
+ private:
+  uint64_t s0_, s1_;
+
+  static uint64_t splitmix(uint64_t& state) {
+    uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+  }
+};
+
+#endif  // CPP_FEATURES_RAYLIB_FAST_RNG_H
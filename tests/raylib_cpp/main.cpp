@@ -1,20 +1,29 @@
+#include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
 #include <iostream>
-#include <memory>
+#include <memory_resource>
 #include <random>
 #include <string>
+#include <thread>
+#include <tuple>
 #include <vector>
 
+#include "batch_renderer.h"
+#include "broad_phase.h"
+#include "particle_system.h"
+#include "pong_core.h"
 #include "raylib.h"
 
 // 游戏常量
 const int SCREEN_WIDTH = 1024;
 const int SCREEN_HEIGHT = 768;
-const float BALL_RADIUS = 20.0f;
-const float PADDLE_WIDTH = 15.0f;
-const float PADDLE_HEIGHT = 80.0f;
-const float BALL_SPEED = 300.0f;
-const float PADDLE_SPEED = 400.0f;
+const float PARTICLE_RADIUS = 3.0f;
+// 多体模式和宽相位基准里"球"的半径 (Pong 的球由 pong::Config 决定)
+const float BODY_BALL_RADIUS = 10.0f;
 
 // 颜色主题
 const Color THEME_BACKGROUND = {15, 15, 35, 255};
@@ -26,214 +35,33 @@ const Color THEME_DANGER = {255, 100, 100, 255};
 // 游戏状态枚举
 enum class GameState { MENU, PLAYING, PAUSED, GAME_OVER };
 
-// 粒子系统
-struct Particle {
-  Vector2 position;
-  Vector2 velocity;
-  Color color;
-  float life;
-  float max_life;
-
-  Particle(Vector2 pos, Vector2 vel, Color col, float lifetime)
-      : position(pos), velocity(vel), color(col), life(lifetime), max_life(lifetime) {}
-
-  void update(float dt) {
-    position.x += velocity.x * dt;
-    position.y += velocity.y * dt;
-    life -= dt;
-
-    // 淡出效果
-    float alpha = life / max_life;
-    color.a = (unsigned char)(255 * alpha);
-  }
-
-  bool is_alive() const { return life > 0; }
-
-  void draw() const {
-    if (is_alive()) {
-      DrawCircleV(position, 3.0f, color);
-    }
-  }
-};
-
-// 粒子系统管理器
-class ParticleSystem {
- private:
-  std::vector<Particle> particles;
-
- public:
-  void emit(Vector2 position, int count, Color base_color) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<float> speed_dist(50.0f, 200.0f);
-    std::uniform_real_distribution<float> angle_dist(0.0f, 2.0f * PI);
-    std::uniform_real_distribution<float> life_dist(0.5f, 2.0f);
+inline Vector2 to_vector2(pong::Vec2 v) { return Vector2{v.x, v.y}; }
 
-    for (int i = 0; i < count; ++i) {
-      float angle = angle_dist(gen);
-      float speed = speed_dist(gen);
-
-      Vector2 velocity = {std::cos(angle) * speed, std::sin(angle) * speed};
-
-      particles.emplace_back(position, velocity, base_color, life_dist(gen));
-    }
-  }
-
-  void update(float dt) {
-    for (auto& particle : particles) {
-      particle.update(dt);
-    }
-
-    // 移除死亡的粒子
-    particles.erase(std::remove_if(particles.begin(), particles.end(),
-                                   [](const Particle& p) { return !p.is_alive(); }),
-                    particles.end());
-  }
-
-  void draw() const {
-    for (const auto& particle : particles) {
-      particle.draw();
-    }
-  }
-
-  size_t get_count() const { return particles.size(); }
-};
-
-// 游戏球类
-class Ball {
- public:
-  Vector2 position;
-  Vector2 velocity;
-  float radius;
-  Color color;
-
-  Ball(Vector2 pos, float r) : position(pos), radius(r), color(THEME_FOREGROUND) {
-    reset_velocity();
-  }
-
-  void reset_velocity() {
-    // 随机初始方向
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<float> angle_dist(-PI / 4, PI / 4);
-    std::uniform_int_distribution<int> direction_dist(0, 1);
-
-    float angle = angle_dist(gen);
-    int direction = direction_dist(gen) ? 1 : -1;
-
-    velocity.x = std::cos(angle) * BALL_SPEED * direction;
-    velocity.y = std::sin(angle) * BALL_SPEED;
-  }
-
-  void update(float dt) {
-    position.x += velocity.x * dt;
-    position.y += velocity.y * dt;
-
-    // 上下边界碰撞
-    if (position.y - radius <= 0 || position.y + radius >= SCREEN_HEIGHT) {
-      velocity.y = -velocity.y;
-      position.y = std::max(radius, std::min((float)SCREEN_HEIGHT - radius, position.y));
-    }
-  }
-
-  void draw() const {
-    DrawCircleV(position, radius, color);
-
-    // 添加发光效果
-    DrawCircleV(position, radius + 2, Fade(color, 0.3f));
-    DrawCircleV(position, radius + 4, Fade(color, 0.1f));
-  }
-
-  Rectangle get_bounds() const {
-    return {position.x - radius, position.y - radius, radius * 2, radius * 2};
-  }
-};
-
-// 游戏板类
-class Paddle {
- public:
-  Vector2 position;
-  Vector2 size;
-  Color color;
-  float speed;
-  bool is_ai;
-
-  Paddle(Vector2 pos, bool ai = false)
-      : position(pos),
-        size{PADDLE_WIDTH, PADDLE_HEIGHT},
-        color(THEME_FOREGROUND),
-        speed(PADDLE_SPEED),
-        is_ai(ai) {}
-
-  void update(float dt, const Ball& ball) {
-    if (is_ai) {
-      // AI逻辑：跟踪球
-      float target_y = ball.position.y - size.y / 2;
-      float diff = target_y - position.y;
-
-      if (std::abs(diff) > 5.0f) {
-        float move_direction = diff > 0 ? 1.0f : -1.0f;
-        position.y += move_direction * speed * dt * 0.8f;  // AI稍微慢一点
-      }
-    } else {
-      // 玩家控制
-      if (IsKeyDown(KEY_UP) || IsKeyDown(KEY_W)) {
-        position.y -= speed * dt;
-      }
-      if (IsKeyDown(KEY_DOWN) || IsKeyDown(KEY_S)) {
-        position.y += speed * dt;
-      }
-    }
-
-    // 边界检查
-    position.y = std::max(0.0f, std::min((float)SCREEN_HEIGHT - size.y, position.y));
-  }
-
-  void draw() const {
-    Rectangle paddle_rect = {position.x, position.y, size.x, size.y};
-    DrawRectangleRec(paddle_rect, color);
-
-    // 添加边框效果
-    DrawRectangleLinesEx(paddle_rect, 2, THEME_ACCENT);
-  }
-
-  Rectangle get_bounds() const { return {position.x, position.y, size.x, size.y}; }
-};
-
-// 主游戏类
+// 主游戏类: 游戏逻辑在 pong::Simulation 里按固定步长运行, 这里只负责输入、状态机、
+// 特效和绘制
 class PongGame {
  private:
   GameState state;
-  std::unique_ptr<Ball> ball;
-  std::unique_ptr<Paddle> left_paddle;
-  std::unique_ptr<Paddle> right_paddle;
+  pong::Simulation sim;
+  // 本局的种子和每个tick的输入, 足以用 pong::replay 重现整局
+  pong::Replay recording;
+  // 还没模拟掉的时间, 不足一个tick的部分留到下一帧
+  float accumulator;
+  // 粒子在线程池上模拟, 同时主线程绘制上一帧的快照; 线程池要比粒子系统活得久
+  cpp_features::ThreadPool particle_pool;
   ParticleSystem particles;
-
-  int left_score;
-  int right_score;
-  const int winning_score = 5;
+  // 需要GL上下文, 所以 PongGame 必须在 InitWindow 之后创建
+  BatchRenderer renderer;
 
   float game_time;
   std::string winner_message;
 
  public:
-  PongGame() : state(GameState::MENU), left_score(0), right_score(0), game_time(0.0f) {
-    initialize_game();
-  }
-
-  void initialize_game() {
-    // 创建游戏对象
-    ball = std::make_unique<Ball>(Vector2{SCREEN_WIDTH / 2.0f, SCREEN_HEIGHT / 2.0f}, BALL_RADIUS);
-
-    left_paddle = std::make_unique<Paddle>(Vector2{50, SCREEN_HEIGHT / 2.0f - PADDLE_HEIGHT / 2.0f},
-                                           false  // 玩家控制
-    );
-
-    right_paddle = std::make_unique<Paddle>(
-        Vector2{SCREEN_WIDTH - 50 - PADDLE_WIDTH, SCREEN_HEIGHT / 2.0f - PADDLE_HEIGHT / 2.0f},
-        true  // AI控制
-    );
-  }
+  PongGame()
+      : state(GameState::MENU),
+        accumulator(0.0f),
+        renderer(sim.config().ball_radius),
+        game_time(0.0f) {}
 
   void handle_input() {
     switch (state) {
@@ -275,80 +103,66 @@ class PongGame {
 
   void update(float dt) {
     game_time += dt;
-    particles.update(dt);
+    // 等待上一帧开始的粒子模拟, 之后才能 emit
+    particles.finish_update();
 
     if (state == GameState::PLAYING) {
-      // 更新游戏对象
-      ball->update(dt);
-      left_paddle->update(dt, *ball);
-      right_paddle->update(dt, *ball);
-
-      // 碰撞检测
-      check_collisions();
-
-      // 检查得分
-      check_scoring();
+      // 固定步长: 这一帧的时间换算成整数个tick, 卡顿时最多追 0.25 秒
+      accumulator += std::min(dt, 0.25f);
+      const uint8_t input = read_player_input();
+      const float tick = sim.config().tick;
+      while (accumulator >= tick && !sim.game_over()) {
+        accumulator -= tick;
+        recording.inputs.push_back(input);
+        play_effects(sim.step(input));
+      }
 
-      // 检查游戏结束条件
-      if (left_score >= winning_score || right_score >= winning_score) {
-        winner_message = (left_score >= winning_score) ? "玩家获胜!" : "AI获胜!";
+      if (sim.game_over()) {
+        winner_message = sim.left_won() ? "玩家获胜!" : "AI获胜!";
         state = GameState::GAME_OVER;
+        report_recording();
       }
     }
-  }
 
-  void check_collisions() {
-    Rectangle ball_rect = ball->get_bounds();
-
-    // 左挡板碰撞
-    if (CheckCollisionRecs(ball_rect, left_paddle->get_bounds()) && ball->velocity.x < 0) {
-      ball->velocity.x = -ball->velocity.x;
-
-      // 根据击中位置调整角度
-      float hit_pos = (ball->position.y - left_paddle->position.y) / left_paddle->size.y - 0.5f;
-      ball->velocity.y += hit_pos * 200.0f;
-
-      // 生成粒子效果
-      particles.emit(ball->position, 10, THEME_ACCENT);
-    }
-
-    // 右挡板碰撞
-    if (CheckCollisionRecs(ball_rect, right_paddle->get_bounds()) && ball->velocity.x > 0) {
-      ball->velocity.x = -ball->velocity.x;
-
-      float hit_pos = (ball->position.y - right_paddle->position.y) / right_paddle->size.y - 0.5f;
-      ball->velocity.y += hit_pos * 200.0f;
+    // 本帧发射的粒子也参与模拟; draw() 期间在后台运行
+    particles.begin_update(dt, particle_pool);
+  }
 
-      particles.emit(ball->position, 10, THEME_ACCENT);
-    }
+  uint8_t read_player_input() const {
+    uint8_t input = pong::kInputNone;
+    if (IsKeyDown(KEY_UP) || IsKeyDown(KEY_W)) input |= pong::kInputUp;
+    if (IsKeyDown(KEY_DOWN) || IsKeyDown(KEY_S)) input |= pong::kInputDown;
+    return input;
   }
 
-  void check_scoring() {
-    // 左边得分 (球出右边界)
-    if (ball->position.x > SCREEN_WIDTH) {
-      left_score++;
+  // 模拟产生的事件转成粒子效果
+  void play_effects(uint32_t events) {
+    if (events & (pong::kLeftHit | pong::kRightHit)) {
+      particles.emit(to_vector2(sim.ball().position), 10, THEME_ACCENT);
+    }
+    if (events & pong::kLeftScored) {
       particles.emit(Vector2{SCREEN_WIDTH - 50, SCREEN_HEIGHT / 2}, 20, THEME_SUCCESS);
-      reset_ball();
     }
-
-    // 右边得分 (球出左边界)
-    if (ball->position.x < 0) {
-      right_score++;
+    if (events & pong::kRightScored) {
       particles.emit(Vector2{50, SCREEN_HEIGHT / 2}, 20, THEME_DANGER);
-      reset_ball();
     }
   }
 
-  void reset_ball() {
-    ball->position = Vector2{SCREEN_WIDTH / 2.0f, SCREEN_HEIGHT / 2.0f};
-    ball->reset_velocity();
-  }
-
   void reset_game() {
-    left_score = 0;
-    right_score = 0;
+    // 每局一个新种子; 同一个种子加上同样的输入可以重现整局, 所以种子打印出来
+    recording.seed = std::random_device{}();
+    recording.inputs.clear();
+    sim.reset(pong::game_seed(recording.seed, 0));
+    accumulator = 0.0f;
     game_time = 0.0f;
-    reset_ball();
+    std::cout << "新的一局, 种子 " << recording.seed << "\n";
+  }
+
+  // 一局结束: 用录像重放核对最终状态, 打印种子和tick数
+  void report_recording() const {
+    const bool same = pong::replay(recording, sim.config()).state_hash() == sim.state_hash();
+    std::cout << "本局结束, 种子 " << recording.seed << ", " << recording.inputs.size()
+              << " ticks, 重放" << (same ? "一致" : "不一致!") << "\n";
   }
 
   void draw() {
@@ -375,12 +189,13 @@ class PongGame {
         break;
     }
 
-    // 绘制粒子效果
-    particles.draw();
+    // 绘制粒子效果: 所有粒子一次 draw call
+    renderer.draw_particles(particles.front_buffer(), PARTICLE_RADIUS);
 
     // FPS显示
     DrawText(TextFormat("FPS: %d", GetFPS()), 10, 10, 20, THEME_ACCENT);
-    DrawText(TextFormat("Particles: %zu", particles.get_count()), 10, 35, 16, THEME_ACCENT);
+    DrawText(TextFormat("Particles: %zu", particles.front_buffer().count), 10, 35, 16,
+             THEME_ACCENT);
 
     EndDrawing();
   }
@@ -414,6 +229,14 @@ class PongGame {
     }
   }
 
+  void draw_paddle(const pong::Paddle& paddle) const {
+    Rectangle paddle_rect = {paddle.position.x, paddle.position.y, paddle.size.x, paddle.size.y};
+    DrawRectangleRec(paddle_rect, THEME_FOREGROUND);
+
+    // 添加边框效果
+    DrawRectangleLinesEx(paddle_rect, 2, THEME_ACCENT);
+  }
+
   void draw_game() {
     // 绘制中线
     for (int y = 0; y < SCREEN_HEIGHT; y += 20) {
@@ -421,13 +244,14 @@ class PongGame {
     }
 
     // 绘制游戏对象
-    ball->draw();
-    left_paddle->draw();
-    right_paddle->draw();
+    // 本体和发光效果预先画在一张纹理里, 一个四边形画完
+    renderer.draw_glow_ball(to_vector2(sim.ball().position), THEME_FOREGROUND);
+    draw_paddle(sim.left_paddle());
+    draw_paddle(sim.right_paddle());
 
     // 绘制分数
-    std::string left_score_text = std::to_string(left_score);
-    std::string right_score_text = std::to_string(right_score);
+    std::string left_score_text = std::to_string(sim.left_score());
+    std::string right_score_text = std::to_string(sim.right_score());
 
     DrawText(left_score_text.c_str(), SCREEN_WIDTH / 4, 50, 48, THEME_FOREGROUND);
     DrawText(right_score_text.c_str(), 3 * SCREEN_WIDTH / 4, 50, 48, THEME_FOREGROUND);
@@ -478,7 +302,7 @@ class PongGame {
 
     // 最终分数
     std::string final_score =
-        "最终比分: " + std::to_string(left_score) + " - " + std::to_string(right_score);
+        "最终比分: " + std::to_string(sim.left_score()) + " - " + std::to_string(sim.right_score());
     int score_width = MeasureText(final_score.c_str(), 20);
     DrawText(final_score.c_str(), (SCREEN_WIDTH - score_width) / 2, SCREEN_HEIGHT / 2 + 80, 20,
              THEME_FOREGROUND);
@@ -487,7 +311,576 @@ class PongGame {
   bool should_close() const { return WindowShouldClose(); }
 };
 
-int main() {
+// 改写前的粒子系统 (AoS, 逐个update, 每帧remove_if, 每次emit构造random_device),
+// 只作为 --particle-bench 的对照
+namespace legacy {
+
+struct Particle {
+  Vector2 position;
+  Vector2 velocity;
+  Color color;
+  float life;
+  float max_life;
+
+  void update(float dt) {
+    position.x += velocity.x * dt;
+    position.y += velocity.y * dt;
+    life -= dt;
+    color.a = (unsigned char)(255 * (life / max_life));
+  }
+};
+
+class AosParticleSystem {
+ public:
+  void emit(Vector2 position, int count, Color base_color) {
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_real_distribution<float> speed_dist(50.0f, 200.0f);
+    std::uniform_real_distribution<float> angle_dist(0.0f, 2.0f * PI);
+    std::uniform_real_distribution<float> life_dist(0.5f, 2.0f);
+    for (int i = 0; i < count; ++i) {
+      float angle = angle_dist(gen);
+      float speed = speed_dist(gen);
+      float lifetime = life_dist(gen);
+      particles.push_back(Particle{position,
+                                   {std::cos(angle) * speed, std::sin(angle) * speed},
+                                   base_color,
+                                   lifetime,
+                                   lifetime});
+    }
+  }
+
+  void update(float dt) {
+    for (auto& particle : particles) particle.update(dt);
+    particles.erase(std::remove_if(particles.begin(), particles.end(),
+                                   [](const Particle& p) { return p.life <= 0; }),
+                    particles.end());
+  }
+
+  size_t get_count() const { return particles.size(); }
+
+ private:
+  std::vector<Particle> particles;
+};
+
+}  // namespace legacy
+
+// 多线程 update 与同种子的单线程 update 逐帧比较: 粒子顺序不同, 但快照里的
+// (位置, 颜色) 多重集合和存活数必须相同. 块取最小的8和不整除粒子数的24; 每10帧
+// 有一帧步长1.6秒, 大部分粒子同时死亡, 空洞成片跨越块边界, 覆盖 close_gaps
+// 从多个块倒着取粒子的路径. 奇数帧走 begin_update / finish_update
+bool check_parallel_update() {
+  cpp_features::ThreadPool pool(4);
+  const Vector2 origin{SCREEN_WIDTH / 2.0f, SCREEN_HEIGHT / 2.0f};
+  auto snapshot = [](const ParticleSystem& system) {
+    const ParticleRenderBuffer& frame = system.front_buffer();
+    std::vector<std::tuple<float, float, uint32_t>> rows(frame.count);
+    for (size_t i = 0; i < frame.count; ++i) {
+      const Color c = frame.color[i];
+      rows[i] = {frame.position[i].x, frame.position[i].y,
+                 uint32_t(c.r) << 24 | uint32_t(c.g) << 16 | uint32_t(c.b) << 8 | c.a};
+    }
+    std::sort(rows.begin(), rows.end());
+    return rows;
+  };
+
+  bool same = true;
+  for (size_t chunk : {size_t(8), size_t(24)}) {
+    ParticleSystem serial(std::pmr::get_default_resource(), 4096);
+    ParticleSystem parallel(std::pmr::get_default_resource(), 4096);
+    for (int frame = 0; frame < 40 && same; ++frame) {
+      const Color color = frame % 2 == 0 ? THEME_ACCENT : THEME_DANGER;
+      serial.emit(origin, 97, color);
+      parallel.emit(origin, 97, color);
+      const float dt = frame % 10 == 9 ? 1.6f : 0.1f;
+      serial.update(dt);
+      if (frame % 2 == 0) {
+        parallel.update(dt, pool, chunk);
+      } else {
+        parallel.begin_update(dt, pool, chunk);
+        parallel.finish_update();
+      }
+      same = serial.get_count() == parallel.get_count() && snapshot(serial) == snapshot(parallel);
+    }
+  }
+  std::cout << "  多线程 update 与单线程一致 (块 8/24, 40 帧): " << (same ? "通过" : "不一致!")
+            << "\n";
+  return same;
+}
+
+// 无窗口的粒子更新基准: 维持约 target 个存活粒子, 每帧按游戏里的方式
+// (每次50个) 补发死亡的粒子, 分别统计 emit 和 update 的耗时. 先做多线程一致性检查,
+// 返回值可直接作为进程退出码
+int run_particle_update_benchmark(size_t target) {
+  std::cout << "粒子系统更新基准 (无窗口, " << target << " 个粒子, 300 帧 @ 60 Hz)\n";
+  const bool ok = check_parallel_update();
+  const int frames = 300;
+  const int burst = 50;
+  const float dt = 1.0f / 60.0f;
+  const Vector2 origin{SCREEN_WIDTH / 2.0f, SCREEN_HEIGHT / 2.0f};
+
+  auto run = [&](const char* name, auto& system) {
+    double emit_ms = 0.0, update_ms = 0.0;
+    size_t updated = 0;
+    for (int frame = 0; frame < frames; ++frame) {
+      auto t0 = std::chrono::steady_clock::now();
+      while (system.get_count() + burst <= target) system.emit(origin, burst, THEME_ACCENT);
+      auto t1 = std::chrono::steady_clock::now();
+      updated += system.get_count();
+      system.update(dt);
+      auto t2 = std::chrono::steady_clock::now();
+      // 第一帧是初始填充, 不计入emit
+      if (frame > 0) emit_ms += std::chrono::duration<double, std::milli>(t1 - t0).count();
+      update_ms += std::chrono::duration<double, std::milli>(t2 - t1).count();
+    }
+    std::cout << "  " << name << ": update " << update_ms / frames << " ms/帧 ("
+              << updated / (update_ms * 1e3) << " M粒子/秒), 补发 " << emit_ms / (frames - 1)
+              << " ms/帧\n";
+  };
+
+  {
+    legacy::AosParticleSystem aos;
+    run("AoS + remove_if (改写前)", aos);
+  }
+  {
+    ParticleSystem soa(std::pmr::get_default_resource(), target);
+    run("SoA + 交换删除        ", soa);
+  }
+  return ok ? 0 : 1;
+}
+
+// 无窗口压力测试: 每帧在线程池上异步模拟, 主线程同时读取前台快照 (代替绘制),
+// 然后补发死亡的粒子. 对每个线程数, 找出帧时间仍在 60 Hz 预算内的最大粒子数.
+// RAYLIB_STRESS_MAX 设置搜索上限 (默认 2^24)
+void run_particle_stress_benchmark() {
+  const double budget_ms = 1000.0 / 60.0;
+  const char* max_env = std::getenv("RAYLIB_STRESS_MAX");
+  const size_t max_particles = max_env ? std::strtoull(max_env, nullptr, 10) : size_t(1) << 24;
+  const unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+  const Vector2 origin{SCREEN_WIDTH / 2.0f, SCREEN_HEIGHT / 2.0f};
+  volatile unsigned sink = 0;
+
+  // 维持 target 个粒子, 返回预热后的平均帧时间
+  auto frame_ms = [&](cpp_features::ThreadPool& pool, size_t target) {
+    ParticleSystem system(std::pmr::get_default_resource(), target);
+    const int warmup = 5;
+    const int frames = 30;
+    double total_ms = 0.0;
+    for (int frame = 0; frame < warmup + frames; ++frame) {
+      auto start = std::chrono::steady_clock::now();
+      system.begin_update(1.0f / 60.0f, pool);
+      const ParticleRenderBuffer& visible = system.front_buffer();
+      unsigned alpha = 0;
+      for (size_t i = 0; i < visible.count; ++i) alpha += visible.color[i].a;
+      sink = sink + alpha;
+      system.finish_update();
+      while (system.get_count() + 256 <= target) system.emit(origin, 256, THEME_ACCENT);
+      const std::chrono::duration<double, std::milli> elapsed =
+          std::chrono::steady_clock::now() - start;
+      if (frame >= warmup) total_ms += elapsed.count();
+    }
+    return total_ms / frames;
+  };
+
+  std::cout << "粒子系统压力测试 (无窗口, 60 Hz 预算 " << budget_ms << " ms/帧, 硬件线程 "
+            << hardware << ")\n";
+  std::vector<unsigned> thread_counts;
+  for (unsigned threads = 1; threads < hardware; threads *= 2) thread_counts.push_back(threads);
+  thread_counts.push_back(hardware);
+
+  for (unsigned threads : thread_counts) {
+    cpp_features::ThreadPool pool(threads);
+    // 先倍增找到超出预算的规模, 再二分几次
+    size_t fits = 0, fails = 0;
+    double fits_ms = 0.0;
+    for (size_t n = size_t(1) << 17; n <= max_particles; n *= 2) {
+      const double ms = frame_ms(pool, n);
+      if (ms > budget_ms) {
+        fails = n;
+        break;
+      }
+      fits = n;
+      fits_ms = ms;
+    }
+    for (int step = 0; step < 4 && fails > fits + 1; ++step) {
+      const size_t mid = fits + (fails - fits) / 2;
+      const double ms = frame_ms(pool, mid);
+      if (ms > budget_ms) {
+        fails = mid;
+      } else {
+        fits = mid;
+        fits_ms = ms;
+      }
+    }
+    std::cout << "  " << threads << " 线程: ";
+    if (fits == 0) {
+      std::cout << "131072 个粒子已超出预算\n";
+      continue;
+    }
+    std::cout << fits << " 粒子/帧 (" << fits_ms << " ms/帧, " << fits / (fits_ms * 1e3)
+              << " M粒子/秒)" << (fails == 0 ? " [达到搜索上限]" : "") << "\n";
+  }
+}
+
+// 离屏渲染基准: 隐藏窗口, 画进 RenderTexture, 比较逐个 DrawCircleV 和 BatchRenderer.
+// 需要GL上下文, 无显示器的机器上用 xvfb-run 运行; LIBGL_ALWAYS_SOFTWARE=1 强制软件渲染
+int run_render_benchmark(size_t count) {
+  SetConfigFlags(FLAG_WINDOW_HIDDEN);
+  InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "raylib render benchmark");
+  if (!IsWindowReady()) {
+    std::cerr << "无法创建GL上下文; 可以试试 xvfb-run -a raylib_example --render-bench\n";
+    return 1;
+  }
+
+  {
+    RenderTexture2D target = LoadRenderTexture(SCREEN_WIDTH, SCREEN_HEIGHT);
+    const float ball_radius = pong::Config().ball_radius;
+    BatchRenderer renderer(ball_radius, static_cast<int>(count));
+
+    // 粒子散布在整个屏幕上, 模拟一步得到快照
+    ParticleSystem particles(std::pmr::get_default_resource(), count);
+    FastRng rng(42);
+    while (particles.get_count() < count) {
+      const Vector2 origin{rng.uniform(0.0f, SCREEN_WIDTH), rng.uniform(0.0f, SCREEN_HEIGHT)};
+      particles.emit(origin, 100, THEME_ACCENT);
+    }
+    particles.update(0.1f);
+    const ParticleRenderBuffer& frame = particles.front_buffer();
+    // 球的数量取粒子的十分之一
+    const size_t balls = std::max<size_t>(1, frame.count / 10);
+
+    // 读回像素作为栅栏, 保证计时包含GPU (或软件光栅器) 完成绘制的时间
+    auto finish_gpu = [&] { UnloadImage(LoadImageFromTexture(target.texture)); };
+    auto render_frames = [&](int frames, auto& draw) {
+      for (int f = 0; f < frames; ++f) {
+        BeginTextureMode(target);
+        ClearBackground(THEME_BACKGROUND);
+        draw();
+        EndTextureMode();
+      }
+      finish_gpu();
+    };
+    auto time_frames = [&](const char* name, size_t items, auto&& draw) {
+      const int frames = 30;
+      render_frames(3, draw);
+      auto start = std::chrono::steady_clock::now();
+      render_frames(frames, draw);
+      const std::chrono::duration<double, std::milli> elapsed =
+          std::chrono::steady_clock::now() - start;
+      const double ms = elapsed.count() / frames;
+      std::cout << "  " << name << ": " << ms << " ms/帧, 每10万个 " << ms * 1e5 / items
+                << " ms\n";
+    };
+
+    std::cout << "离屏渲染基准 (" << frame.count << " 个粒子, " << balls << " 个球, "
+              << SCREEN_WIDTH << "x" << SCREEN_HEIGHT << ")\n";
+    time_frames("粒子 DrawCircleV   ", frame.count, [&] { particles.draw(); });
+    time_frames("粒子 BatchRenderer ", frame.count,
+                [&] { renderer.draw_particles(frame, PARTICLE_RADIUS); });
+    std::cout << "  BatchRenderer 每帧 draw call: " << renderer.last_draw_calls() << "\n";
+    time_frames("球 3 x DrawCircleV ", balls, [&] {
+      for (size_t i = 0; i < balls; ++i) {
+        DrawCircleV(frame.position[i], ball_radius, THEME_FOREGROUND);
+        DrawCircleV(frame.position[i], ball_radius + 2, Fade(THEME_FOREGROUND, 0.3f));
+        DrawCircleV(frame.position[i], ball_radius + 4, Fade(THEME_FOREGROUND, 0.1f));
+      }
+    });
+    time_frames("球 光晕纹理        ", balls, [&] {
+      for (size_t i = 0; i < balls; ++i) {
+        renderer.draw_glow_ball(frame.position[i], THEME_FOREGROUND);
+      }
+    });
+    UnloadRenderTexture(target);
+  }
+  CloseWindow();
+  return 0;
+}
+
+// 无窗口时代替玩家: 多数tick追球, 偶尔乱按, 这样既有来回也会失分
+uint8_t bot_input(const pong::Simulation& sim, FastRng& rng) {
+  if ((rng.next() & 7) == 0) return static_cast<uint8_t>(rng.next() % 3);
+  const pong::Paddle& paddle = sim.left_paddle();
+  const float diff = sim.ball().position.y - (paddle.position.y + paddle.size.y / 2);
+  if (diff > 10.0f) return pong::kInputDown;
+  if (diff < -10.0f) return pong::kInputUp;
+  return pong::kInputNone;
+}
+
+// check_collisions / check_scoring / 结束条件 / 重放一致性的回归检查
+bool run_pong_regression() {
+  int failures = 0;
+  auto check = [&failures](const char* name, bool ok) {
+    if (!ok) {
+      ++failures;
+      std::cout << "  失败: " << name << "\n";
+    }
+  };
+
+  {
+    // 球压在左挡板上并向左运动: 反弹, 击中点在挡板 3/4 高度处, vy 增加 50
+    pong::Simulation sim(1);
+    const pong::Paddle& left = sim.left_paddle();
+    sim.ball().position = {left.position.x + left.size.x + 19, left.position.y + 60};
+    sim.ball().velocity = {-300, 0};
+    check("左挡板击球事件", sim.check_collisions() == pong::kLeftHit);
+    check("左挡板击球后向右", sim.ball().velocity.x == 300);
+    check("左挡板偏转", sim.ball().velocity.y == 50);
+    // 已经在离开挡板: 不再反弹
+    check("离开左挡板不反弹", sim.check_collisions() == 0 && sim.ball().velocity.x == 300);
+  }
+  {
+    // 球的边缘恰好贴着挡板, 与 CheckCollisionRecs 一样不算相交
+    pong::Simulation sim(1);
+    const pong::Paddle& left = sim.left_paddle();
+    sim.ball().position = {left.position.x + left.size.x + 20, left.position.y + 40};
+    sim.ball().velocity = {-300, 0};
+    check("边缘相接不算碰撞", sim.check_collisions() == 0 && sim.ball().velocity.x == -300);
+  }
+  {
+    // 右挡板正中击球: 只反转水平速度
+    pong::Simulation sim(1);
+    const pong::Paddle& right = sim.right_paddle();
+    sim.ball().position = {right.position.x - 19, right.position.y + 40};
+    sim.ball().velocity = {300, 10};
+    check("右挡板击球事件", sim.check_collisions() == pong::kRightHit);
+    check("右挡板击球后", sim.ball().velocity.x == -300 && sim.ball().velocity.y == 10);
+  }
+  {
+    // 出右边界左边得分, 出左边界右边得分; 重新发球回到中心, 速率不变
+    pong::Simulation sim(1);
+    const pong::Config& config = sim.config();
+    sim.ball().position = {config.width + 1, 100};
+    check("出右边界", sim.check_scoring() == pong::kLeftScored && sim.left_score() == 1);
+    const pong::Ball& ball = sim.ball();
+    check("重新发球在中心",
+          ball.position.x == config.width / 2 && ball.position.y == config.height / 2);
+    check("发球速率",
+          std::abs(std::hypot(ball.velocity.x, ball.velocity.y) - config.ball_speed) < 1e-3f);
+    sim.ball().position = {-1, 100};
+    check("出左边界", sim.check_scoring() == pong::kRightScored && sim.right_score() == 1);
+    sim.ball().position = {config.width / 2, 100};
+    check("界内不得分", sim.check_scoring() == 0);
+  }
+  {
+    // 赛点得分后一局结束, 之后 step 不再改变状态
+    pong::Simulation sim(1);
+    sim.set_score(sim.config().winning_score - 1, 0);
+    sim.ball().position = {sim.config().width + 5, 300};
+    sim.ball().velocity = {300, 0};
+    const uint32_t events = sim.step(pong::kInputNone);
+    check("赛点得分事件", events == (pong::kLeftScored | pong::kGameOver));
+    check("玩家获胜", sim.game_over() && sim.left_won());
+    const uint64_t hash = sim.state_hash();
+    check("结束后静止", sim.step(pong::kInputUp) == 0 && sim.state_hash() == hash);
+  }
+  {
+    // 录下一段输入, 重放后状态逐位相同; 换种子则不同
+    pong::Replay recording;
+    recording.seed = 7;
+    pong::Simulation sim(pong::game_seed(recording.seed, 0));
+    FastRng rng(99);
+    uint64_t game = 0;
+    for (int t = 0; t < 200000; ++t) {
+      recording.inputs.push_back(bot_input(sim, rng));
+      pong::step_session(sim, recording.seed, game, recording.inputs.back());
+    }
+    check("重放一致", pong::replay(recording).state_hash() == sim.state_hash());
+    recording.seed = 8;
+    check("换种子结果不同", pong::replay(recording).state_hash() != sim.state_hash());
+  }
+
+  std::cout << "  回归检查: " << (failures == 0 ? "全部通过" : "有失败") << "\n";
+  return failures == 0;
+}
+
+// 无窗口运行固定步长模拟: 先跑回归检查, 再由机器人玩家连续打 ticks 个tick测吞吐,
+// 最后重放录像核对状态哈希. 返回值可直接作为进程退出码
+int run_pong_headless(uint64_t ticks) {
+  std::cout << "Pong 确定性模拟 (无窗口, " << ticks << " ticks, 每tick "
+            << pong::Config().tick * 1000 << " ms)\n";
+  bool ok = run_pong_regression();
+
+  pong::Replay recording;
+  recording.seed = 2024;
+  recording.inputs.reserve(ticks);
+  pong::Simulation sim(pong::game_seed(recording.seed, 0));
+  FastRng rng(1);
+  uint64_t game = 0, hits = 0, points = 0;
+
+  auto start = std::chrono::steady_clock::now();
+  for (uint64_t t = 0; t < ticks; ++t) {
+    const uint8_t input = bot_input(sim, rng);
+    recording.inputs.push_back(input);
+    const uint32_t events = pong::step_session(sim, recording.seed, game, input);
+    hits += (events & (pong::kLeftHit | pong::kRightHit)) != 0;
+    points += (events & (pong::kLeftScored | pong::kRightScored)) != 0;
+  }
+  const std::chrono::duration<double, std::milli> run_ms = std::chrono::steady_clock::now() - start;
+
+  start = std::chrono::steady_clock::now();
+  const pong::Simulation replayed = pong::replay(recording);
+  const std::chrono::duration<double, std::milli> replay_ms =
+      std::chrono::steady_clock::now() - start;
+
+  std::cout << "  模拟 (含机器人输入和录制): " << run_ms.count() << " ms, "
+            << ticks / (run_ms.count() * 1e3) << " M ticks/秒, " << game + 1 << " 局, " << hits
+            << " 次击球, " << points << " 次得分\n";
+  std::cout << "  重放: " << replay_ms.count() << " ms, " << ticks / (replay_ms.count() * 1e3)
+            << " M ticks/秒 (相当于 " << ticks * pong::Config().tick / 3600 << " 小时的游戏)\n";
+  const bool same = replayed.state_hash() == sim.state_hash();
+  std::cout << "  重放状态哈希: " << std::hex << replayed.state_hash() << std::dec
+            << (same ? " 一致\n" : " 不一致\n");
+  return ok && same ? 0 : 1;
+}
+
+// 宽相位基准: 物体密度固定 (每个物体平均占 20x20 像素), 世界随数量变大;
+// 比较暴力 O(n^2)、均匀网格和扫描排序找出全部相交对的耗时, 并核对三者结果一致
+int run_collision_benchmark() {
+  std::cout << "宽相位碰撞检测基准 (球半径 " << BODY_BALL_RADIUS << ", 粒子半径 " << PARTICLE_RADIUS
+            << ", 每物体 400 像素^2)\n";
+  std::cout << "  " << std::setw(7) << "n" << std::setw(9) << "pairs" << std::setw(12) << "brute ms"
+            << std::setw(11) << "grid ms" << std::setw(10) << "SAP ms" << std::setw(15)
+            << "grid Mpairs/s" << std::setw(10) << "speedup" << "\n";
+  const std::ios_base::fmtflags flags = std::cout.flags();
+  const std::streamsize precision = std::cout.precision();
+  std::cout << std::fixed << std::setprecision(3);
+
+  const char* max_env = std::getenv("RAYLIB_COLLISION_MAX");
+  const size_t max_bodies = max_env ? std::strtoull(max_env, nullptr, 10) : 256000;
+  const size_t brute_max = 32000;
+  bool all_same = true;
+
+  for (size_t n = 1000; n <= max_bodies; n *= 2) {
+    const float side = std::sqrt(static_cast<float>(n) * 400.0f);
+    const collision::Bodies bodies =
+        collision::scatter_bodies(n, side, side, BODY_BALL_RADIUS, PARTICLE_RADIUS, n);
+    collision::UniformGrid grid(side, side, 2.0f * bodies.max_radius());
+    collision::SweepAndPrune sweep;
+
+    // 相交对的个数和顺序无关的校验和
+    struct PairSum {
+      size_t count = 0;
+      uint64_t sum = 0;
+      void operator()(size_t i, size_t j) {
+        ++count;
+        sum += (static_cast<uint64_t>(i) << 32 | j) * 0x9e3779b97f4a7c15ULL;
+      }
+    };
+    // 重复到约0.2秒取平均
+    auto average_ms = [](auto&& run) {
+      int reps = 0;
+      auto start = std::chrono::steady_clock::now();
+      std::chrono::duration<double, std::milli> elapsed{};
+      do {
+        run();
+        ++reps;
+        elapsed = std::chrono::steady_clock::now() - start;
+      } while (elapsed.count() < 200.0);
+      return elapsed.count() / reps;
+    };
+
+    PairSum grid_pairs, sweep_pairs, brute_pairs;
+    const double grid_ms = average_ms([&] {
+      grid_pairs = PairSum();
+      grid.build(bodies);
+      grid.for_each_overlap(grid_pairs);
+    });
+    const double sweep_ms = average_ms([&] {
+      sweep_pairs = PairSum();
+      sweep.for_each_overlap(bodies, sweep_pairs);
+    });
+    double brute_ms = 0.0;
+    bool same = grid_pairs.count == sweep_pairs.count && grid_pairs.sum == sweep_pairs.sum;
+    if (n <= brute_max) {
+      brute_ms = average_ms([&] {
+        brute_pairs = PairSum();
+        collision::brute_force_pairs(bodies, brute_pairs);
+      });
+      same = same && grid_pairs.count == brute_pairs.count && grid_pairs.sum == brute_pairs.sum;
+    }
+
+    std::cout << "  " << std::setw(7) << n << std::setw(9) << grid_pairs.count << std::setw(12);
+    if (n <= brute_max) {
+      std::cout << brute_ms;
+    } else {
+      std::cout << "-";
+    }
+    std::cout << std::setw(11) << grid_ms << std::setw(10) << sweep_ms << std::setw(15)
+              << grid_pairs.count / (grid_ms * 1e3) << std::setw(10);
+    if (n <= brute_max) {
+      std::cout << brute_ms / grid_ms;
+    } else {
+      std::cout << "-";
+    }
+    std::cout << (same ? "" : "  结果不一致!") << "\n";
+    all_same = all_same && same;
+  }
+  std::cout.flags(flags);
+  std::cout.precision(precision);
+  return all_same ? 0 : 1;
+}
+
+// 多体模式: 窗口里 count 个球和粒子互相碰撞, 网格宽相位 + 批量渲染
+int run_many_body(size_t count) {
+  InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "Raylib C++ Demo - Many-body collisions");
+  SetTargetFPS(60);
+  {
+    BatchRenderer renderer(pong::Config().ball_radius, static_cast<int>(count));
+    collision::Bodies bodies =
+        collision::scatter_bodies(count, SCREEN_WIDTH, SCREEN_HEIGHT, BODY_BALL_RADIUS,
+                                  PARTICLE_RADIUS, 42);
+    collision::UniformGrid grid(SCREEN_WIDTH, SCREEN_HEIGHT, 2.0f * bodies.max_radius());
+
+    while (!WindowShouldClose()) {
+      auto start = std::chrono::steady_clock::now();
+      const size_t pairs = collision::step_bodies(bodies, grid, SCREEN_WIDTH, SCREEN_HEIGHT,
+                                                  std::min(GetFrameTime(), 1.0f / 30.0f));
+      const std::chrono::duration<double, std::milli> step_ms =
+          std::chrono::steady_clock::now() - start;
+
+      BeginDrawing();
+      ClearBackground(THEME_BACKGROUND);
+      renderer.draw_circles(bodies.size(), [&](size_t i) {
+        const bool ball = bodies.radius[i] > PARTICLE_RADIUS;
+        return BatchRenderer::Circle{Vector2{bodies.x[i], bodies.y[i]}, bodies.radius[i],
+                                     ball ? THEME_FOREGROUND : THEME_ACCENT};
+      });
+      DrawText(TextFormat("FPS: %d", GetFPS()), 10, 10, 20, THEME_ACCENT);
+      DrawText(TextFormat("Bodies: %zu  Pairs: %zu  Step: %.2f ms", bodies.size(), pairs,
+                          step_ms.count()),
+               10, 35, 16, THEME_ACCENT);
+      EndDrawing();
+    }
+  }
+  CloseWindow();
+  return 0;
+}
+
+int main(int argc, char** argv) {
+  if (argc > 1 && std::strcmp(argv[1], "--particle-bench") == 0) {
+    size_t target = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1000000;
+    return run_particle_update_benchmark(target > 0 ? target : 1000000);
+  }
+  if (argc > 1 && std::strcmp(argv[1], "--pong-headless") == 0) {
+    uint64_t ticks = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10000000;
+    return run_pong_headless(ticks > 0 ? ticks : 10000000);
+  }
+  if (argc > 1 && std::strcmp(argv[1], "--collision-bench") == 0) {
+    return run_collision_benchmark();
+  }
+  if (argc > 1 && std::strcmp(argv[1], "--many-body") == 0) {
+    size_t count = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 5000;
+    return run_many_body(count > 0 ? count : 5000);
+  }
+  if (argc > 1 && std::strcmp(argv[1], "--render-bench") == 0) {
+    size_t count = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 100000;
+    return run_render_benchmark(count > 0 ? count : 100000);
+  }
+  if (argc > 1 && std::strcmp(argv[1], "--particle-stress") == 0) {
+    run_particle_stress_benchmark();
+    return 0;
+  }
+
   std::cout << "🎮 Raylib 现代C++游戏开发演示\\n";
   std::cout << "===============================\\n";
   std::cout << "启动 Pong 游戏...\\n\\n";
@@ -0,0 +1,369 @@
+#ifndef CPP_FEATURES_RAYLIB_PARTICLE_SYSTEM_H
+#define CPP_FEATURES_RAYLIB_PARTICLE_SYSTEM_H
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory_resource>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "fast_rng.h"
+#include "raylib.h"
+#include "thread_pool.h"
+
+#if defined(__AVX__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// 数据导向的粒子系统:
+// - SoA存储: 位置/速度/寿命各自是连续的float数组, update 只碰需要的数据
+// - 固定容量: 所有数组在构造时按容量一次分配 (可来自任意memory_resource),
+//   之后 emit/update 不再分配; 超出容量的粒子被丢弃并计数
+// - 交换删除: 死亡粒子用最后一个粒子覆盖, 不保持顺序, 不移动其余元素
+// - 持久的快速PRNG: 不再每次 emit 都构造 random_device + mt19937
+// - 双缓冲快照: update 把位置和淡出后的颜色写进后台缓冲, draw 只读前台缓冲,
+//   所以 begin_update 在线程池上模拟时主线程可以同时绘制上一帧
+// 透明度不存储, 写快照时由 life / max_life 算出.
+
+// 一帧的绘制数据; 刚死亡的粒子也在其中, alpha 为0
+struct ParticleRenderBuffer {
+  std::pmr::vector<Vector2> position;
+  std::pmr::vector<Color> color;
+  size_t count = 0;
+
+  ParticleRenderBuffer(size_t capacity, std::pmr::memory_resource* resource)
+      : position(capacity, resource), color(capacity, resource) {}
+};
+
+class ParticleSystem {
+ public:
+  static constexpr size_t kDefaultCapacity = size_t(1) << 17;
+  // 多线程 update 每个任务处理的粒子数 (8的倍数, 只有最后一块有标量尾部)
+  static constexpr size_t kUpdateChunk = 16384;
+
+  explicit ParticleSystem(std::pmr::memory_resource* resource = std::pmr::get_default_resource(),
+                          size_t capacity = kDefaultCapacity, uint64_t seed = 0x5eed)
+      : pos_x_(capacity, resource),
+        pos_y_(capacity, resource),
+        vel_x_(capacity, resource),
+        vel_y_(capacity, resource),
+        life_(capacity, resource),
+        inv_max_life_(capacity, resource),
+        color_(capacity, resource),
+        frames_{ParticleRenderBuffer(capacity, resource), ParticleRenderBuffer(capacity, resource)},
+        chunk_live_end_(resource),
+        rng_(seed) {}
+
+  ParticleSystem(const ParticleSystem&) = delete;
+  ParticleSystem& operator=(const ParticleSystem&) = delete;
+
+  ~ParticleSystem() {
+    finish_update();
+    if (!driver_.joinable()) return;
+    {
+      std::lock_guard<std::mutex> lock(driver_mutex_);
+      driver_stopping_ = true;
+    }
+    driver_wake_.notify_one();
+    driver_.join();
+  }
+
+  // 从 position 向随机方向发射 count 个粒子; 容量满时多余的被丢弃.
+  // 不能在 begin_update / finish_update 之间调用
+  void emit(Vector2 position, int count, Color base_color) {
+    const size_t room = capacity() - count_;
+    const size_t accepted = std::min(room, static_cast<size_t>(std::max(count, 0)));
+    dropped_ += static_cast<size_t>(std::max(count, 0)) - accepted;
+
+    for (size_t n = 0; n < accepted; ++n) {
+      const size_t i = count_++;
+      const float angle = rng_.uniform(0.0f, 2.0f * PI);
+      const float speed = rng_.uniform(50.0f, 200.0f);
+      const float lifetime = rng_.uniform(0.5f, 2.0f);
+      pos_x_[i] = position.x;
+      pos_y_[i] = position.y;
+      vel_x_[i] = std::cos(angle) * speed;
+      vel_y_[i] = std::sin(angle) * speed;
+      life_[i] = lifetime;
+      inv_max_life_[i] = 1.0f / lifetime;
+      color_[i] = base_color;
+    }
+  }
+
+  // 单线程: 积分, 写快照, 删除死亡粒子, 翻转缓冲
+  void update(float dt) {
+    finish_update();
+    ParticleRenderBuffer& back = frames_[1 - front_];
+    const size_t live_end = simulate(dt, back, 0, count_);
+    back.count = count_;
+    count_ = live_end;
+    front_ = 1 - front_;
+  }
+
+  // 多线程: 按 chunk 个粒子切块交给线程池, 每块独立积分/写快照/块内交换删除;
+  // 之后串行地用末尾的存活粒子填补各块留下的空洞, 只移动"死亡数量"个粒子
+  void update(float dt, cpp_features::ThreadPool& pool, size_t chunk = kUpdateChunk) {
+    finish_update();
+    simulate_parallel(dt, pool, chunk);
+    front_ = 1 - front_;
+  }
+
+  // 异步版本: 把多线程 update 交给常驻的驱动线程后立即返回, 调用方可以同时 draw()
+  // 上一帧的快照; finish_update() 等待模拟结束并翻转缓冲. 驱动线程第一次调用时创建,
+  // 之后每帧复用, 不再每帧新建线程. 模拟期间 pool 被占用, 调用方不要在同一个线程池上
+  // 再发起 parallel_for
+  void begin_update(float dt, cpp_features::ThreadPool& pool, size_t chunk = kUpdateChunk) {
+    finish_update();
+    if (!driver_.joinable()) driver_ = std::thread([this] { driver_loop(); });
+    {
+      std::lock_guard<std::mutex> lock(driver_mutex_);
+      job_ = Job{dt, &pool, chunk};
+      job_pending_ = true;
+    }
+    in_flight_ = true;
+    driver_wake_.notify_one();
+  }
+
+  void finish_update() {
+    if (!in_flight_) return;
+    in_flight_ = false;
+    std::unique_lock<std::mutex> lock(driver_mutex_);
+    driver_done_.wait(lock, [this] { return !job_pending_; });
+    if (job_error_) std::rethrow_exception(std::exchange(job_error_, nullptr));
+    front_ = 1 - front_;
+  }
+
+  // 每个粒子一次 DrawCircleV; 游戏里用 BatchRenderer, 这里留作基准对照
+  void draw() const {
+    const ParticleRenderBuffer& frame = front_buffer();
+    for (size_t i = 0; i < frame.count; ++i) {
+      if (frame.color[i].a == 0) continue;
+      DrawCircleV(frame.position[i], 3.0f, frame.color[i]);
+    }
+  }
+
+  // 最近一次完成的 update 产生的快照; 模拟进行中也可以安全读取
+  const ParticleRenderBuffer& front_buffer() const { return frames_[front_]; }
+
+  // 模拟中的粒子数; 和 emit 一样不能在 begin_update / finish_update 之间调用
+  size_t get_count() const { return count_; }
+  size_t capacity() const { return life_.size(); }
+  // 因容量不足而没有发射的粒子总数
+  size_t dropped() const { return dropped_; }
+
+  // 淡出: alpha = 255 * life / max_life
+  Color faded_color(size_t i) const {
+    Color c = color_[i];
+    const float alpha = std::min(std::max(life_[i] * inv_max_life_[i], 0.0f), 1.0f);
+    c.a = static_cast<unsigned char>(255.0f * alpha);
+    return c;
+  }
+
+ private:
+  std::pmr::vector<float> pos_x_, pos_y_;
+  std::pmr::vector<float> vel_x_, vel_y_;
+  std::pmr::vector<float> life_, inv_max_life_;
+  std::pmr::vector<Color> color_;
+  size_t count_ = 0;
+  size_t dropped_ = 0;
+  ParticleRenderBuffer frames_[2];
+  int front_ = 0;
+  // 多线程 update 中每块压缩后存活区间的末尾
+  std::pmr::vector<size_t> chunk_live_end_;
+  FastRng rng_;
+
+  // begin_update 交给驱动线程的一次模拟
+  struct Job {
+    float dt = 0.0f;
+    cpp_features::ThreadPool* pool = nullptr;
+    size_t chunk = kUpdateChunk;
+  };
+  std::thread driver_;
+  std::mutex driver_mutex_;
+  std::condition_variable driver_wake_;
+  std::condition_variable driver_done_;
+  Job job_;
+  bool job_pending_ = false;  // 已交给驱动线程、还没模拟完
+  bool driver_stopping_ = false;
+  std::exception_ptr job_error_;
+  bool in_flight_ = false;  // 只由调用方线程读写: begin_update 之后还没 finish_update
+
+  void driver_loop() {
+    std::unique_lock<std::mutex> lock(driver_mutex_);
+    while (true) {
+      driver_wake_.wait(lock, [this] { return driver_stopping_ || job_pending_; });
+      if (driver_stopping_) return;
+      const Job job = job_;
+      lock.unlock();
+      std::exception_ptr error;
+      try {
+        simulate_parallel(job.dt, *job.pool, job.chunk);
+      } catch (...) {
+        error = std::current_exception();
+      }
+      lock.lock();
+      job_error_ = error;
+      job_pending_ = false;
+      driver_done_.notify_one();
+    }
+  }
+
+  // [first, last) 范围: 积分并写入 back 快照, 块内交换删除; 返回存活区间的末尾
+  size_t simulate(float dt, ParticleRenderBuffer& back, size_t first, size_t last) {
+    integrate(dt, back, first, last);
+    return remove_dead(first, last);
+  }
+
+  // 不翻转缓冲, 由调用方 (update 或 finish_update) 翻转
+  void simulate_parallel(float dt, cpp_features::ThreadPool& pool, size_t chunk) {
+    chunk = std::max<size_t>(8, chunk & ~size_t(7));
+    ParticleRenderBuffer& back = frames_[1 - front_];
+    const size_t count = count_;
+    chunk_live_end_.resize((count + chunk - 1) / chunk);
+    pool.parallel_for(chunk_live_end_.size(), [&](size_t c) {
+      const size_t first = c * chunk;
+      chunk_live_end_[c] = simulate(dt, back, first, std::min(first + chunk, count));
+    });
+    back.count = count;
+    count_ = close_gaps(chunk);
+  }
+
+  // 各块压缩后, 存活粒子总数为 live; [0, live) 内的空洞与 [live, count) 内的存活粒子
+  // 一样多, 从最后一块往前取存活粒子逐个填入. 返回 live
+  size_t close_gaps(size_t chunk) {
+    const size_t chunks = chunk_live_end_.size();
+    size_t live = 0;
+    for (size_t c = 0; c < chunks; ++c) live += chunk_live_end_[c] - c * chunk;
+
+    size_t source = chunks;  // 当前取粒子的块
+    size_t source_end = 0;   // 该块中还没取走的存活粒子的末尾
+    for (size_t c = 0; c < chunks && c * chunk < live; ++c) {
+      const size_t hole_end = std::min((c + 1) * chunk, live);
+      for (size_t hole = chunk_live_end_[c]; hole < hole_end; ++hole) {
+        while (source_end <= std::max(source * chunk, live)) {
+          --source;
+          source_end = chunk_live_end_[source];
+        }
+        move_particle(hole, --source_end);
+      }
+    }
+    return live;
+  }
+
+  void move_particle(size_t to, size_t from) {
+    pos_x_[to] = pos_x_[from];
+    pos_y_[to] = pos_y_[from];
+    vel_x_[to] = vel_x_[from];
+    vel_y_[to] = vel_y_[from];
+    life_[to] = life_[from];
+    inv_max_life_[to] = inv_max_life_[from];
+    color_[to] = color_[from];
+  }
+
+  // 位置 += 速度 * dt, 寿命 -= dt, 同时把结果写进快照 (位置交错成 Vector2,
+  // 颜色换上淡出的alpha). 和积分放在同一遍里, 新位置不用再从内存读一次.
+  // AVX每次8个粒子, SSE2每次4个
+  void integrate(float dt, ParticleRenderBuffer& back, size_t first, size_t last) {
+    float* px = pos_x_.data();
+    float* py = pos_y_.data();
+    const float* vx = vel_x_.data();
+    const float* vy = vel_y_.data();
+    float* life = life_.data();
+    const float* inv_max_life = inv_max_life_.data();
+    float* out_position = reinterpret_cast<float*>(back.position.data());
+    size_t i = first;
+#if defined(__AVX__)
+    const __m256 step = _mm256_set1_ps(dt);
+    for (; i + 8 <= last; i += 8) {
+      const __m256 x =
+          _mm256_add_ps(_mm256_loadu_ps(px + i), _mm256_mul_ps(_mm256_loadu_ps(vx + i), step));
+      const __m256 y =
+          _mm256_add_ps(_mm256_loadu_ps(py + i), _mm256_mul_ps(_mm256_loadu_ps(vy + i), step));
+      const __m256 remaining = _mm256_sub_ps(_mm256_loadu_ps(life + i), step);
+      _mm256_storeu_ps(px + i, x);
+      _mm256_storeu_ps(py + i, y);
+      _mm256_storeu_ps(life + i, remaining);
+      // x0 y0 x1 y1 | x4 y4 x5 y5 和 x2 y2 x3 y3 | x6 y6 x7 y7, 再按128位重排
+      const __m256 low = _mm256_unpacklo_ps(x, y);
+      const __m256 high = _mm256_unpackhi_ps(x, y);
+      _mm256_storeu_ps(out_position + 2 * i, _mm256_permute2f128_ps(low, high, 0x20));
+      _mm256_storeu_ps(out_position + 2 * i + 8, _mm256_permute2f128_ps(low, high, 0x31));
+      const __m256 alpha = _mm256_mul_ps(remaining, _mm256_loadu_ps(inv_max_life + i));
+      publish_colors(back, i, _mm256_castps256_ps128(alpha));
+      publish_colors(back, i + 4, _mm256_extractf128_ps(alpha, 1));
+    }
+#elif defined(__SSE2__)
+    const __m128 step = _mm_set1_ps(dt);
+    for (; i + 4 <= last; i += 4) {
+      const __m128 x = _mm_add_ps(_mm_loadu_ps(px + i), _mm_mul_ps(_mm_loadu_ps(vx + i), step));
+      const __m128 y = _mm_add_ps(_mm_loadu_ps(py + i), _mm_mul_ps(_mm_loadu_ps(vy + i), step));
+      const __m128 remaining = _mm_sub_ps(_mm_loadu_ps(life + i), step);
+      _mm_storeu_ps(px + i, x);
+      _mm_storeu_ps(py + i, y);
+      _mm_storeu_ps(life + i, remaining);
+      _mm_storeu_ps(out_position + 2 * i, _mm_unpacklo_ps(x, y));
+      _mm_storeu_ps(out_position + 2 * i + 4, _mm_unpackhi_ps(x, y));
+      publish_colors(back, i, _mm_mul_ps(remaining, _mm_loadu_ps(inv_max_life + i)));
+    }
+#endif
+    for (; i < last; ++i) {
+      px[i] += vx[i] * dt;
+      py[i] += vy[i] * dt;
+      life[i] -= dt;
+      back.position[i] = Vector2{px[i], py[i]};
+      back.color[i] = faded_color(i);
+    }
+  }
+
+#if defined(__SSE2__)
+  // 4个粒子的快照颜色: RGB来自原颜色, A = 255 * clamp(alpha, 0, 1)
+  void publish_colors(ParticleRenderBuffer& back, size_t i, __m128 alpha) const {
+    alpha = _mm_min_ps(_mm_max_ps(alpha, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+    const __m128i a = _mm_cvttps_epi32(_mm_mul_ps(alpha, _mm_set1_ps(255.0f)));
+    // Color 是 r, g, b, a 四个字节, 按小端读成uint32时a在最高字节
+    const __m128i rgb = _mm_and_si128(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(color_.data() + i)),
+        _mm_set1_epi32(0x00ffffff));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(back.color.data() + i),
+                     _mm_or_si128(rgb, _mm_slli_epi32(a, 24)));
+  }
+#endif
+
+  // 交换删除 [first, last) 内的死亡粒子, 返回存活区间 [first, end) 的末尾.
+  // 整块都活着时一次跳过 (SIMD比较), 否则逐个检查; 死亡粒子被最后一个覆盖后
+  // 原地再检查一次, 因为换过来的也可能已经死亡
+  size_t remove_dead(size_t first, size_t last) {
+    const float* life = life_.data();
+    size_t i = first;
+    while (i < last) {
+#if defined(__AVX__)
+      if (i + 8 <= last &&
+          _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(life + i), _mm256_setzero_ps(),
+                                           _CMP_LE_OQ)) == 0) {
+        i += 8;
+        continue;
+      }
+#elif defined(__SSE2__)
+      if (i + 4 <= last &&
+          _mm_movemask_ps(_mm_cmple_ps(_mm_loadu_ps(life + i), _mm_setzero_ps())) == 0) {
+        i += 4;
+        continue;
+      }
+#endif
+      if (life[i] > 0.0f) {
+        ++i;
+        continue;
+      }
+      move_particle(i, --last);
+    }
+    return last;
+  }
+};
+
+#endif  // CPP_FEATURES_RAYLIB_PARTICLE_SYSTEM_H
@@ -0,0 +1,274 @@
+#ifndef CPP_FEATURES_RAYLIB_PONG_CORE_H
+#define CPP_FEATURES_RAYLIB_PONG_CORE_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "fast_rng.h"
+
+// Pong 的游戏逻辑, 与 raylib 无关:
+// - 固定步长: 每次 step 前进 Config::tick 秒, 与帧率无关; 渲染端用累加器决定每帧跑几步
+// - 确定性: 发球方向来自带种子的 FastRng, 玩家输入按tick传入,
+//   同一个种子 + 同一串输入总是得到同一个结果 (同一个可执行文件内)
+// - step 返回事件位 (击球/得分/结束), 由渲染端决定播放什么效果
+// 不同编译选项 (例如是否把 a * b + c 合并成FMA) 可能改变浮点结果, 所以只比较
+// 同一次运行内的状态哈希, 不写死哈希值.
+
+namespace pong {
+
+struct Vec2 {
+  float x, y;
+};
+
+struct Rect {
+  float x, y, width, height;
+};
+
+// 与 raylib 的 CheckCollisionRecs 相同: 边恰好相接不算相交
+inline bool overlaps(const Rect& a, const Rect& b) {
+  return a.x < b.x + b.width && a.x + a.width > b.x && a.y < b.y + b.height &&
+         a.y + a.height > b.y;
+}
+
+struct Config {
+  float width = 1024.0f;
+  float height = 768.0f;
+  float ball_radius = 20.0f;
+  float ball_speed = 300.0f;
+  float paddle_width = 15.0f;
+  float paddle_height = 80.0f;
+  float paddle_speed = 400.0f;
+  float paddle_margin = 50.0f;
+  int winning_score = 5;
+  float tick = 1.0f / 120.0f;
+};
+
+struct Ball {
+  Vec2 position;
+  Vec2 velocity;
+  float radius;
+
+  Rect bounds() const {
+    return {position.x - radius, position.y - radius, radius * 2, radius * 2};
+  }
+};
+
+struct Paddle {
+  Vec2 position;
+  Vec2 size;
+  float speed;
+
+  Rect bounds() const { return {position.x, position.y, size.x, size.y}; }
+};
+
+// 玩家在一个tick内按下的方向键
+enum Input : uint8_t { kInputNone = 0, kInputUp = 1, kInputDown = 2 };
+
+// step / check_collisions / check_scoring 返回的事件位
+enum Event : uint32_t {
+  kLeftHit = 1u << 0,
+  kRightHit = 1u << 1,
+  kLeftScored = 1u << 2,   // 左边 (玩家) 得分, 球出了右边界
+  kRightScored = 1u << 3,  // 右边 (AI) 得分, 球出了左边界
+  kGameOver = 1u << 4,
+};
+
+class Simulation {
+ public:
+  explicit Simulation(uint64_t seed = 1, const Config& config = Config()) : config_(config) {
+    reset(seed);
+  }
+
+  // 开始新的一局: 比分清零, 挡板回到中间, 用 seed 重新播种并发球
+  void reset(uint64_t seed) {
+    rng_ = FastRng(seed);
+    left_score_ = 0;
+    right_score_ = 0;
+    ticks_ = 0;
+    game_over_ = false;
+    const float paddle_y = (config_.height - config_.paddle_height) / 2.0f;
+    const Vec2 size{config_.paddle_width, config_.paddle_height};
+    left_ = Paddle{Vec2{config_.paddle_margin, paddle_y}, size, config_.paddle_speed};
+    right_ = Paddle{Vec2{config_.width - config_.paddle_margin - config_.paddle_width, paddle_y},
+                    size, config_.paddle_speed};
+    ball_.radius = config_.ball_radius;
+    reset_ball();
+  }
+
+  // 前进一个tick; 一局结束后不再变化
+  uint32_t step(uint8_t input) {
+    if (game_over_) return 0;
+    ++ticks_;
+    const float dt = config_.tick;
+
+    move_ball(dt);
+    move_player(input, dt);
+    move_ai(dt);
+
+    uint32_t events = check_collisions();
+    events |= check_scoring();
+    if (left_score_ >= config_.winning_score || right_score_ >= config_.winning_score) {
+      game_over_ = true;
+      events |= kGameOver;
+    }
+    return events;
+  }
+
+  // 球碰到挡板且正朝它运动时反弹, 按击中位置偏转竖直速度
+  uint32_t check_collisions() {
+    const Rect ball_rect = ball_.bounds();
+    uint32_t events = 0;
+    if (overlaps(ball_rect, left_.bounds()) && ball_.velocity.x < 0) {
+      bounce(left_);
+      events |= kLeftHit;
+    }
+    if (overlaps(ball_rect, right_.bounds()) && ball_.velocity.x > 0) {
+      bounce(right_);
+      events |= kRightHit;
+    }
+    return events;
+  }
+
+  // 球中心出界时给对方加分并重新发球
+  uint32_t check_scoring() {
+    if (ball_.position.x > config_.width) {
+      ++left_score_;
+      reset_ball();
+      return kLeftScored;
+    }
+    if (ball_.position.x < 0) {
+      ++right_score_;
+      reset_ball();
+      return kRightScored;
+    }
+    return 0;
+  }
+
+  // 状态的 FNV-1a 哈希, 按位比较浮点数; 用于重放一致性检查
+  uint64_t state_hash() const {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    auto mix = [&hash](const void* data, size_t size) {
+      const unsigned char* bytes = static_cast<const unsigned char*>(data);
+      for (size_t i = 0; i < size; ++i) hash = (hash ^ bytes[i]) * 0x100000001b3ULL;
+    };
+    const float values[] = {ball_.position.x, ball_.position.y, ball_.velocity.x,
+                            ball_.velocity.y, left_.position.y,  right_.position.y};
+    mix(values, sizeof(values));
+    const int64_t counters[] = {left_score_, right_score_, static_cast<int64_t>(ticks_),
+                                game_over_ ? 1 : 0};
+    mix(counters, sizeof(counters));
+    return hash;
+  }
+
+  // 可写的访问器供回归测试摆出特定局面
+  Ball& ball() { return ball_; }
+  Paddle& left_paddle() { return left_; }
+  Paddle& right_paddle() { return right_; }
+  const Ball& ball() const { return ball_; }
+  const Paddle& left_paddle() const { return left_; }
+  const Paddle& right_paddle() const { return right_; }
+
+  int left_score() const { return left_score_; }
+  int right_score() const { return right_score_; }
+  void set_score(int left, int right) {
+    left_score_ = left;
+    right_score_ = right;
+  }
+  uint64_t ticks() const { return ticks_; }
+  bool game_over() const { return game_over_; }
+  bool left_won() const { return left_score_ >= config_.winning_score; }
+  const Config& config() const { return config_; }
+
+ private:
+  Config config_;
+  FastRng rng_;
+  Ball ball_{};
+  Paddle left_{};
+  Paddle right_{};
+  int left_score_ = 0;
+  int right_score_ = 0;
+  uint64_t ticks_ = 0;
+  bool game_over_ = false;
+
+  // 从中心发球, 方向在 ±45° 内随机, 向左或向右
+  void reset_ball() {
+    ball_.position = Vec2{config_.width / 2.0f, config_.height / 2.0f};
+    const float quarter_pi = 0.785398163f;
+    const float angle = rng_.uniform(-quarter_pi, quarter_pi);
+    const float direction = (rng_.next() >> 63) ? 1.0f : -1.0f;
+    ball_.velocity.x = std::cos(angle) * config_.ball_speed * direction;
+    ball_.velocity.y = std::sin(angle) * config_.ball_speed;
+  }
+
+  void move_ball(float dt) {
+    ball_.position.x += ball_.velocity.x * dt;
+    ball_.position.y += ball_.velocity.y * dt;
+    // 上下边界反弹
+    if (ball_.position.y - ball_.radius <= 0 ||
+        ball_.position.y + ball_.radius >= config_.height) {
+      ball_.velocity.y = -ball_.velocity.y;
+      ball_.position.y =
+          std::max(ball_.radius, std::min(config_.height - ball_.radius, ball_.position.y));
+    }
+  }
+
+  void move_player(uint8_t input, float dt) {
+    if (input & kInputUp) left_.position.y -= left_.speed * dt;
+    if (input & kInputDown) left_.position.y += left_.speed * dt;
+    clamp_paddle(left_);
+  }
+
+  // AI跟踪球, 速度打八折
+  void move_ai(float dt) {
+    const float diff = ball_.position.y - right_.size.y / 2 - right_.position.y;
+    if (std::abs(diff) > 5.0f) {
+      right_.position.y += (diff > 0 ? 1.0f : -1.0f) * right_.speed * dt * 0.8f;
+    }
+    clamp_paddle(right_);
+  }
+
+  void clamp_paddle(Paddle& paddle) const {
+    paddle.position.y =
+        std::max(0.0f, std::min(config_.height - paddle.size.y, paddle.position.y));
+  }
+
+  void bounce(const Paddle& paddle) {
+    ball_.velocity.x = -ball_.velocity.x;
+    const float hit_pos = (ball_.position.y - paddle.position.y) / paddle.size.y - 0.5f;
+    ball_.velocity.y += hit_pos * 200.0f;
+  }
+};
+
+// 连续多局时第 game 局的种子
+inline uint64_t game_seed(uint64_t session_seed, uint64_t game) {
+  return session_seed + game * 0x9e3779b97f4a7c15ULL;
+}
+
+// 种子 + 每个tick的输入, 足以完整重现一段可能包含多局的录像;
+// 一局结束后的下一个tick先用 game_seed 开新局再 step
+struct Replay {
+  uint64_t seed = 1;
+  std::vector<uint8_t> inputs;
+};
+
+// 按录像的规则前进一个tick, 录制和重放共用
+inline uint32_t step_session(Simulation& sim, uint64_t session_seed, uint64_t& game,
+                             uint8_t input) {
+  if (sim.game_over()) sim.reset(game_seed(session_seed, ++game));
+  return sim.step(input);
+}
+
+// 从头重放, 返回重放结束时的模拟状态
+inline Simulation replay(const Replay& recording, const Config& config = Config()) {
+  Simulation sim(game_seed(recording.seed, 0), config);
+  uint64_t game = 0;
+  for (uint8_t input : recording.inputs) step_session(sim, recording.seed, game, input);
+  return sim;
+}
+
+}  // namespace pong
+
+#endif  // CPP_FEATURES_RAYLIB_PONG_CORE_H
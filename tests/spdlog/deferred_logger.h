@@ -0,0 +1,363 @@
+#ifndef CPP_FEATURES_SPDLOG_DEFERRED_LOGGER_H
+#define CPP_FEATURES_SPDLOG_DEFERRED_LOGGER_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <spdlog/common.h>
+#include <spdlog/fmt/fmt.h>
+
+// 延迟格式化的二进制日志器: 热路径只把 格式串指针 + 解码函数指针 + 时间戳 + 参数的原始字节
+// 拷贝进本线程的环形缓冲区 (单生产者单消费者, 无锁), 格式化由后台线程完成.
+//
+// 记录布局 (按头部大小32字节对齐, 环尾剩余空间总能放下一个填充头):
+//   RecordHeader { size, level, timestamp, format, decode }
+//   参数字节: 算术类型按原样拷贝, 字符串为 uint32 长度 + 字节
+//
+// 格式串必须是字符串字面量 (只保存指针); 字符串参数按值拷贝, 调用返回后可以释放.
+namespace deferred {
+
+using Decoder = void (*)(const char* args, const char* format, fmt::memory_buffer& out);
+
+struct RecordHeader {
+  uint32_t size;   // 整条记录的字节数, 含头部和对齐填充
+  uint32_t level;  // spdlog::level::level_enum
+  int64_t timestamp_ns;
+  const char* format;
+  Decoder decode;  // nullptr 表示环尾的填充记录
+};
+constexpr size_t kRecordAlign = sizeof(RecordHeader);
+static_assert((kRecordAlign & (kRecordAlign - 1)) == 0, "record alignment must be a power of two");
+
+template <typename T>
+constexpr bool is_string_arg_v =
+    std::is_same<std::decay_t<T>, std::string>::value ||
+    std::is_same<std::decay_t<T>, std::string_view>::value ||
+    std::is_same<std::decay_t<T>, const char*>::value ||
+    std::is_same<std::decay_t<T>, char*>::value;
+
+// 解码后的参数类型: 字符串以视图形式指向环形缓冲区
+template <typename T>
+using stored_t = std::conditional_t<is_string_arg_v<T>, fmt::string_view, std::decay_t<T>>;
+
+template <typename T>
+size_t encoded_size(const T& value) {
+  if constexpr (is_string_arg_v<T>) {
+    return sizeof(uint32_t) + std::string_view(value).size();
+  } else {
+    static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value,
+                  "deferred logger only stores arithmetic, enum and string arguments");
+    return sizeof(T);
+  }
+}
+
+template <typename T>
+char* encode(char* out, const T& value) {
+  if constexpr (is_string_arg_v<T>) {
+    const std::string_view s(value);
+    const auto size = static_cast<uint32_t>(s.size());
+    std::memcpy(out, &size, sizeof(size));
+    std::memcpy(out + sizeof(size), s.data(), s.size());
+    return out + sizeof(size) + s.size();
+  } else {
+    std::memcpy(out, &value, sizeof(T));
+    return out + sizeof(T);
+  }
+}
+
+template <typename T>
+stored_t<T> decode_one(const char*& in) {
+  if constexpr (is_string_arg_v<T>) {
+    uint32_t size;
+    std::memcpy(&size, in, sizeof(size));
+    const fmt::string_view s(in + sizeof(size), size);
+    in += sizeof(size) + size;
+    return s;
+  } else {
+    std::decay_t<T> value;
+    std::memcpy(&value, in, sizeof(value));
+    in += sizeof(value);
+    return value;
+  }
+}
+
+// 每个参数类型组合实例化一个解码函数; 花括号初始化保证按从左到右的顺序读取
+template <typename... Args>
+void decode_args(const char* in, const char* format, fmt::memory_buffer& out) {
+  std::tuple<stored_t<Args>...> values{decode_one<Args>(in)...};
+  (void)in;
+  std::apply(
+      [&](const auto&... value) {
+        fmt::format_to(std::back_inserter(out), fmt::runtime(format), value...);
+      },
+      values);
+}
+
+// 单生产者单消费者字节环. 读写位置单调递增, 各自只由一方写入
+class ThreadRing {
+ public:
+  explicit ThreadRing(size_t capacity) : buffer_(capacity), mask_(capacity - 1) {
+    if (capacity < 64 || (capacity & mask_) != 0) {
+      throw std::invalid_argument("ring capacity must be a power of two >= 64");
+    }
+  }
+
+  // 生产者: 取得连续size字节的写入位置; 空间不足返回nullptr
+  char* reserve(size_t size) {
+    uint64_t pos = tail_.load(std::memory_order_relaxed);
+    const size_t offset = static_cast<size_t>(pos & mask_);
+    const size_t contiguous = buffer_.size() - offset;
+    const size_t needed = size <= contiguous ? size : contiguous + size;
+    if (pos + needed - cached_head_ > buffer_.size()) {
+      cached_head_ = head_.load(std::memory_order_acquire);
+      if (pos + needed - cached_head_ > buffer_.size()) return nullptr;
+    }
+    if (size > contiguous) {
+      // 环尾放不下: 写一条填充记录跳到开头
+      RecordHeader padding{};
+      padding.size = static_cast<uint32_t>(contiguous);
+      std::memcpy(buffer_.data() + offset, &padding, sizeof(padding));
+      pos += contiguous;
+      tail_.store(pos, std::memory_order_release);
+    }
+    return buffer_.data() + (pos & mask_);
+  }
+
+  void commit(size_t size) {
+    tail_.store(tail_.load(std::memory_order_relaxed) + size, std::memory_order_release);
+  }
+
+  // 消费者: 处理所有已提交的记录, 返回处理的条数
+  template <typename F>
+  size_t consume(F&& handle) {
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    const uint64_t tail = tail_.load(std::memory_order_acquire);
+    size_t records = 0;
+    while (head < tail) {
+      RecordHeader header;
+      const char* record = buffer_.data() + (head & mask_);
+      std::memcpy(&header, record, sizeof(header));
+      if (header.decode != nullptr) {
+        handle(header, record + sizeof(header));
+        ++records;
+      }
+      head += header.size;
+    }
+    head_.store(head, std::memory_order_release);
+    return records;
+  }
+
+  bool empty() const {
+    return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+  }
+
+ private:
+  std::vector<char> buffer_;
+  size_t mask_;
+  alignas(64) std::atomic<uint64_t> tail_{0};
+  uint64_t cached_head_ = 0;  // 生产者缓存的读位置, 减少跨核读取
+  alignas(64) std::atomic<uint64_t> head_{0};
+};
+
+enum class Overflow {
+  kDrop,  // 环满时丢弃新消息并计数, 热路径从不等待
+  kBlock  // 环满时让出CPU直到后台线程腾出空间
+};
+
+class Logger {
+ public:
+  Logger(std::string name, const std::string& path, size_t ring_bytes = size_t{1} << 22,
+         Overflow overflow = Overflow::kDrop)
+      : name_(std::move(name)),
+        ring_bytes_(ring_bytes),
+        overflow_(overflow),
+        id_(next_id().fetch_add(1) + 1),
+        file_(open_file(path)) {
+    if (file_ == nullptr) throw std::runtime_error("无法打开日志文件: " + path);
+    worker_ = std::thread([this] { run(); });
+  }
+
+  Logger(const Logger&) = delete;
+  Logger& operator=(const Logger&) = delete;
+
+  ~Logger() {
+    stopping_.store(true, std::memory_order_release);
+    worker_.join();
+    std::fclose(file_);
+  }
+
+  template <typename... Args>
+  void log(spdlog::level::level_enum level, fmt::format_string<Args...> format,
+           const Args&... args) {
+    const size_t payload = (size_t{0} + ... + encoded_size(args));
+    const size_t size = (sizeof(RecordHeader) + payload + kRecordAlign - 1) & ~(kRecordAlign - 1);
+    ThreadRing& ring = local_ring();
+    char* out = ring.reserve(size);
+    while (out == nullptr) {
+      if (overflow_ == Overflow::kDrop || size > ring_bytes_ / 2) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+      }
+      std::this_thread::yield();
+      out = ring.reserve(size);
+    }
+
+    const RecordHeader header{
+        static_cast<uint32_t>(size), static_cast<uint32_t>(level),
+        std::chrono::system_clock::now().time_since_epoch() / std::chrono::nanoseconds(1),
+        fmt::string_view(format).data(), &decode_args<Args...>};
+    std::memcpy(out, &header, sizeof(header));
+    char* cursor = out + sizeof(header);
+    ((cursor = encode(cursor, args)), ...);
+    ring.commit(size);
+  }
+
+  template <typename... Args>
+  void info(fmt::format_string<Args...> format, const Args&... args) {
+    log(spdlog::level::info, format, args...);
+  }
+
+  template <typename... Args>
+  void error(fmt::format_string<Args...> format, const Args&... args) {
+    log(spdlog::level::err, format, args...);
+  }
+
+  // 等待所有线程已提交的记录写入文件
+  void flush() {
+    while (true) {
+      bool drained = true;
+      {
+        std::lock_guard<std::mutex> lock(rings_mutex_);
+        for (const auto& ring : rings_) drained = drained && ring->empty();
+      }
+      if (drained && !writing_.load(std::memory_order_acquire)) break;
+      std::this_thread::yield();
+    }
+    std::lock_guard<std::mutex> lock(file_mutex_);
+    std::fflush(file_);
+  }
+
+  size_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+  size_t written() const { return written_.load(std::memory_order_relaxed); }
+
+ private:
+  std::string name_;
+  size_t ring_bytes_;
+  Overflow overflow_;
+  uint64_t id_;
+  std::FILE* file_;
+  std::mutex file_mutex_;
+  std::mutex rings_mutex_;
+  std::vector<std::shared_ptr<ThreadRing>> rings_;
+  std::atomic<bool> stopping_{false};
+  std::atomic<bool> writing_{false};
+  std::atomic<size_t> dropped_{0};
+  std::atomic<size_t> written_{0};
+  std::thread worker_;
+
+  // 日志目录不存在时先创建; 失败由fopen返回nullptr报告
+  static std::FILE* open_file(const std::string& path) {
+    const std::filesystem::path parent = std::filesystem::path(path).parent_path();
+    std::error_code ec;
+    if (!parent.empty()) std::filesystem::create_directories(parent, ec);
+    return std::fopen(path.c_str(), "wb");
+  }
+
+  static std::atomic<uint64_t>& next_id() {
+    static std::atomic<uint64_t> id{0};
+    return id;
+  }
+
+  // 每个线程第一次向某个日志器记录时注册自己的环, 之后走thread_local缓存.
+  // 用日志器编号而不是地址做键, 避免新日志器复用旧地址时拿到失效的环; 缓存只持有
+  // weak_ptr, 注册新环时顺便清掉已销毁日志器的条目
+  ThreadRing& local_ring() {
+    thread_local uint64_t last_owner = 0;
+    thread_local ThreadRing* last_ring = nullptr;
+    if (last_owner == id_) return *last_ring;
+
+    thread_local std::vector<std::pair<uint64_t, std::weak_ptr<ThreadRing>>> known;
+    ThreadRing* ring = nullptr;
+    for (const auto& entry : known) {
+      if (entry.first == id_) ring = entry.second.lock().get();  // 由本日志器的rings_持有
+    }
+    if (ring == nullptr) {
+      known.erase(std::remove_if(known.begin(), known.end(),
+                                 [](const auto& entry) { return entry.second.expired(); }),
+                  known.end());
+      auto created = std::make_shared<ThreadRing>(ring_bytes_);
+      ring = created.get();
+      known.emplace_back(id_, created);
+      std::lock_guard<std::mutex> lock(rings_mutex_);
+      rings_.push_back(std::move(created));
+    }
+    last_owner = id_;
+    last_ring = ring;
+    return *ring;
+  }
+
+  void run() {
+    fmt::memory_buffer line;
+    while (true) {
+      const bool stopping = stopping_.load(std::memory_order_acquire);
+      writing_.store(true, std::memory_order_release);
+      size_t records = 0;
+      {
+        std::lock_guard<std::mutex> rings_lock(rings_mutex_);
+        std::lock_guard<std::mutex> file_lock(file_mutex_);
+        for (const auto& ring : rings_) {
+          records += ring->consume([&](const RecordHeader& header, const char* args) {
+            line.clear();
+            append_prefix(line, header);
+            header.decode(args, header.format, line);
+            line.push_back('\n');
+            std::fwrite(line.data(), 1, line.size(), file_);
+          });
+        }
+      }
+      // 先计数再清标志: flush() 看到 writing_ == false 时 written() 已包含本轮
+      written_.fetch_add(records, std::memory_order_relaxed);
+      writing_.store(false, std::memory_order_release);
+      if (stopping) break;  // 停止标志之前提交的记录都已在本轮写出
+      if (records == 0) std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    std::fflush(file_);
+  }
+
+  void append_prefix(fmt::memory_buffer& out, const RecordHeader& header) const {
+    const std::time_t seconds = static_cast<std::time_t>(header.timestamp_ns / 1000000000);
+    std::tm local{};
+#if defined(_WIN32)
+    localtime_s(&local, &seconds);
+#else
+    localtime_r(&seconds, &local);
+#endif
+    const auto level = static_cast<spdlog::level::level_enum>(header.level);
+    const spdlog::string_view_t level_name = spdlog::level::to_string_view(level);
+    fmt::format_to(std::back_inserter(out), "[{:02}:{:02}:{:02}.{:06}] [{}] [{}] ", local.tm_hour,
+                   local.tm_min, local.tm_sec, header.timestamp_ns / 1000 % 1000000, name_,
+                   fmt::string_view(level_name.data(), level_name.size()));
+  }
+};
+
+}  // namespace deferred
+
+#endif  // CPP_FEATURES_SPDLOG_DEFERRED_LOGGER_H
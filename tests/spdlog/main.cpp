@@ -1,13 +1,19 @@
+#include <chrono>
+#include <iomanip>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <vector>
 
+#include <spdlog/async.h>
 #include <spdlog/fmt/ostr.h>
 #include <spdlog/sinks/basic_file_sink.h>
 #include <spdlog/sinks/rotating_file_sink.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/spdlog.h>
 
+#include "deferred_logger.h"
+
 // 自定义类，演示对象日志
 class User {
  public:
@@ -141,34 +147,69 @@ void demo_log_patterns() {
   logger->error("Simple error");
 }
 
+// 同步文件日志器 vs 异步日志器 (有界队列 + 专用后台写线程), 异步分别使用两种溢出策略:
+// block 队列满时调用方等待, overrun_oldest 丢弃最旧的消息. "调用方" 是记录所有消息
+// 的耗时, "含落盘" 额外包含等待队列清空 (线程池析构时处理完剩余消息)
 void demo_performance() {
   std::cout << "\n=== 性能测试 ===\n";
 
-  const int num_messages = 10000;
-  auto start = std::chrono::high_resolution_clock::now();
-
-  // 创建异步日志器以提高性能
-  try {
-    // 注意：新版本的spdlog可能需要不同的异步设置方式
-    auto async_logger = spdlog::stdout_color_mt("async");
-    async_logger->set_pattern("[%H:%M:%S.%e] [%n] [%l] %v");
+  const int num_messages = 200000;
+  using clock = std::chrono::steady_clock;
+  auto ms_since = [](clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(clock::now() - start).count();
+  };
+  const std::ios_base::fmtflags flags = std::cout.flags();
+  const std::streamsize precision = std::cout.precision();
 
+  // finish 负责释放日志器并等待所有消息写出
+  auto run = [&](const char* label, std::shared_ptr<spdlog::logger> logger, auto finish) {
+    logger->set_pattern("[%H:%M:%S.%e] [%n] [%l] %v");
+    const auto start = clock::now();
     for (int i = 0; i < num_messages; ++i) {
-      async_logger->info("Async message #{}", i);
+      logger->info("Async message #{} value={:.3f}", i, i * 0.5);
     }
+    const double caller_ms = ms_since(start);
+    finish(std::move(logger));
+    const double total_ms = ms_since(start);
+    std::cout << "  " << std::left << std::setw(26) << label << std::right << std::fixed
+              << std::setprecision(1) << std::setw(8) << caller_ms << " ms" << std::setw(10)
+              << std::setprecision(0) << num_messages / caller_ms * 1000.0
+              << " msg/s   含落盘 " << std::setprecision(1) << total_ms << " ms\n";
+  };
 
-    spdlog::drop_all();  // 确保所有日志器都被清理
+  auto async_run = [&](const char* label, size_t queue_size,
+                       spdlog::async_overflow_policy policy, const std::string& file) {
+    auto pool = std::make_shared<spdlog::details::thread_pool>(queue_size, 1);
+    auto sink = std::make_shared<spdlog::sinks::basic_file_sink_mt>(file, true);
+    auto logger = std::make_shared<spdlog::async_logger>(label, sink, pool, policy);
+    size_t dropped = 0;
+    run(label, logger, [&](std::shared_ptr<spdlog::logger> l) {
+      l.reset();
+      logger.reset();
+      dropped = pool->overrun_counter();
+      pool.reset();  // 析构时处理完队列中剩余的消息再join
+    });
+    if (dropped > 0) std::cout << "    队列溢出丢弃 " << dropped << " 条\n";
+  };
 
+  try {
+    std::cout << "  " << num_messages << " 条消息写入 logs/perf_*.log\n";
+    run("同步 basic_file_sink", spdlog::basic_logger_mt("perf_sync", "logs/perf_sync.log", true),
+        [](std::shared_ptr<spdlog::logger> l) {
+          l->flush();
+          spdlog::drop(l->name());
+        });
+
+    // 队列8192条; 第二个实验用1024条的小队列, 更容易触发溢出
+    async_run("异步 block", 8192, spdlog::async_overflow_policy::block,
+              "logs/perf_async_block.log");
+    async_run("异步 overrun_oldest", 1024, spdlog::async_overflow_policy::overrun_oldest,
+              "logs/perf_async_overrun.log");
   } catch (const std::exception& e) {
     std::cout << "  异步日志错误: " << e.what() << "\n";
-    return;
   }
-
-  auto end = std::chrono::high_resolution_clock::now();
-  auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
-
-  std::cout << "  📊 记录 " << num_messages << " 条消息耗时: " << duration.count() << " ms\n";
-  std::cout << "  📈 平均速度: " << (num_messages * 1000 / duration.count()) << " msg/sec\n";
+  std::cout.flags(flags);
+  std::cout.precision(precision);
 }
 
 void demo_conditional_logging() {
@@ -229,6 +270,96 @@ void demo_structured_logging() {
   logger->error("Authentication failed: code={} user_id={} attempts={}", error_code, user_id, 3);
 }
 
+// 热路径开销: spdlog同步/异步日志器在调用线程上格式化消息, 延迟格式化日志器只拷贝
+// 格式串指针和参数字节, 由后台线程格式化. 模式与 demo_structured_logging 相同
+void demo_deferred_logging() {
+  std::cout << "\n=== 延迟格式化日志 (热路径 ns/次) ===\n";
+
+  const int calls = 1000000;
+  const std::string operation = "database_query";
+  const std::string table = "users";
+  using clock = std::chrono::steady_clock;
+
+  // 返回调用线程上每次调用的纳秒数; finish 负责等待消息全部落盘
+  auto measure = [&](const char* label, auto&& log_one, auto&& finish) {
+    const auto start = clock::now();
+    for (int i = 0; i < calls; ++i) log_one(i);
+    const double hot_ns = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+    finish();
+    const double total_ms =
+        std::chrono::duration<double, std::milli>(clock::now() - start).count();
+    std::cout << "  " << std::left << std::setw(34) << label << std::right << std::fixed
+              << std::setprecision(1) << std::setw(8) << hot_ns / calls << " ns/次   含落盘 "
+              << total_ms << " ms\n";
+  };
+
+  try {
+    std::cout << "  " << calls << " 次 \"operation={} table={} duration_ms={}\"\n";
+
+    auto sync_logger =
+        spdlog::basic_logger_mt("structured_sync", "logs/structured_sync.log", true);
+    measure(
+        "spdlog 同步",
+        [&](int i) {
+          sync_logger->info("operation={} table={} duration_ms={}", operation, table, i % 100);
+        },
+        [&] {
+          sync_logger->flush();
+          spdlog::drop("structured_sync");
+        });
+
+    {
+      auto pool = std::make_shared<spdlog::details::thread_pool>(8192, 1);
+      auto sink =
+          std::make_shared<spdlog::sinks::basic_file_sink_mt>("logs/structured_async.log", true);
+      auto async_logger = std::make_shared<spdlog::async_logger>(
+          "structured_async", sink, pool, spdlog::async_overflow_policy::block);
+      measure(
+          "spdlog 异步 (block)",
+          [&](int i) {
+            async_logger->info("operation={} table={} duration_ms={}", operation, table, i % 100);
+          },
+          [&] {
+            async_logger.reset();
+            pool.reset();  // 线程池析构时写完剩余消息
+          });
+    }
+
+    // 4 MB的环装不下全部消息, 单核上后台线程只能在热线程让出CPU时追赶;
+    // 64 MB的环能容纳全部消息, 反映后台线程跟得上时的纯热路径开销
+    struct Config {
+      const char* label;
+      deferred::Overflow overflow;
+      size_t ring_bytes;
+    };
+    const Config configs[] = {
+        {"延迟格式化 4MB 满则丢弃", deferred::Overflow::kDrop, size_t{1} << 22},
+        {"延迟格式化 4MB 满则等待", deferred::Overflow::kBlock, size_t{1} << 22},
+        {"延迟格式化 64MB 满则等待", deferred::Overflow::kBlock, size_t{1} << 26},
+    };
+    for (const Config& config : configs) {
+      auto logger = std::make_unique<deferred::Logger>(
+          "structured", "logs/structured_deferred.log", config.ring_bytes, config.overflow);
+      size_t dropped = 0;
+      size_t written = 0;
+      measure(
+          config.label,
+          [&](int i) {
+            logger->info("operation={} table={} duration_ms={}", operation, table, i % 100);
+          },
+          [&] {
+            logger->flush();
+            dropped = logger->dropped();
+            written = logger->written();
+            logger.reset();
+          });
+      std::cout << "    写出 " << written << " 条, 丢弃 " << dropped << " 条\n";
+    }
+  } catch (const std::exception& e) {
+    std::cout << "  日志错误: " << e.what() << "\n";
+  }
+}
+
 int main() {
   std::cout << "🚀 spdlog 现代C++日志库演示\n";
   std::cout << "================================\n";
@@ -241,6 +372,7 @@ int main() {
     demo_performance();
     demo_conditional_logging();
     demo_structured_logging();
+    demo_deferred_logging();
 
     std::cout << "\n✅ spdlog 演示完成!\n";
     std::cout << "\n📚 主要特性:\n";
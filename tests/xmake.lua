@@ -15,9 +15,39 @@ add_requires("raylib")
 -- Common C++17 language setting for compatibility
 add_languages("c++17")
 
+-- Eigen build variants for the eigen_example performance sweep:
+--   xmake f --eigen_openmp=y   multithreaded Eigen kernels (Eigen::setNbThreads)
+--   xmake f --eigen_blas=y     dense products through OpenBLAS (EIGEN_USE_BLAS)
+--   xmake f --native=y         -march=native
+option("eigen_openmp")
+    set_default(false)
+    set_showmenu(true)
+    set_description("Build eigen_example with OpenMP")
+option_end()
+
+option("eigen_blas")
+    set_default(false)
+    set_showmenu(true)
+    set_description("Build eigen_example with EIGEN_USE_BLAS against OpenBLAS")
+option_end()
+
+option("native")
+    set_default(false)
+    set_showmenu(true)
+    set_description("Build eigen_example with -march=native")
+option_end()
+
+if has_config("eigen_openmp") then
+    add_requires("openmp")
+end
+if has_config("eigen_blas") then
+    add_requires("openblas")
+end
+
 -- fmt library example
 target("fmt_example")
     set_kind("binary")
+    add_rules("alloc_tracking")
     add_files("fmtlib/*.cpp")
     add_packages("fmt")
     set_targetdir("bin/third_party")
@@ -27,6 +57,7 @@ target("fmt_example")
 -- spdlog logging library example  
 target("spdlog_example")
     set_kind("binary")
+    add_rules("alloc_tracking")
     add_files("spdlog/*.cpp")
     add_packages("spdlog")
     set_targetdir("bin/third_party")
@@ -36,6 +67,7 @@ target("spdlog_example")
 -- nlohmann/json library example
 target("json_example")
     set_kind("binary")
+    add_rules("alloc_tracking")
     add_files("nlohmann_json/*.cpp")
     add_packages("nlohmann_json")
     set_targetdir("bin/third_party")
@@ -45,6 +77,7 @@ target("json_example")
 -- Catch2 testing framework example
 target("catch2_example")
     set_kind("binary")
+    add_rules("alloc_tracking")
     add_files("catch2/*.cpp")
     add_packages("catch2")
     set_targetdir("bin/third_party")
@@ -54,15 +87,31 @@ target("catch2_example")
 -- Eigen linear algebra library example
 target("eigen_example")
     set_kind("binary")
+    add_rules("alloc_tracking")
     add_files("eigen/*.cpp")
     add_packages("eigen")
     set_targetdir("bin/third_party")
     add_languages("c++17")
     set_group("math")
+    if has_config("eigen_openmp") then
+        add_packages("openmp")
+    end
+    if has_config("eigen_blas") then
+        add_defines("EIGEN_USE_BLAS")
+        add_packages("openblas")
+    end
+    if has_config("native") then
+        add_cxxflags("-march=native", {tools = {"gcc", "clang"}})
+    end
+    if has_config("simd") then
+        add_vectorexts("avx2")
+        add_cxxflags("-mfma", {tools = {"gcc", "clang"}})
+    end
 
 -- Raylib game library example
 target("raylib_example")
     set_kind("binary")
+    add_rules("alloc_tracking")
     add_files("raylib_cpp/*.cpp")
     add_packages("raylib")
     set_targetdir("bin/third_party")
@@ -76,15 +125,23 @@ target("raylib_example")
     elseif is_plat("macosx") then
         add_frameworks("OpenGL", "Cocoa", "IOKit", "CoreFoundation", "CoreVideo")
     end
+    if has_config("simd") then
+        add_vectorexts("avx2")
+    end
 
 -- Comprehensive demo showing multiple libraries together
 target("combined_example")
     set_kind("binary")
+    add_rules("alloc_tracking")
     add_files("combined/*.cpp")
     add_packages("fmt", "spdlog", "nlohmann_json")
     set_targetdir("bin/third_party")
     add_languages("c++17")
     set_group("integration")
+    if has_config("simd") then
+        add_vectorexts("avx2")
+        add_cxxflags("-mpclmul", {tools = {"gcc", "clang"}})
+    end
 
 -- Information target (shows available examples)
 target("show_examples")
@@ -6,10 +6,35 @@ set_version("1.0.0")
 set_warnings("all", "error")
 set_optimize("fastest")
 
+-- Opt-in SIMD kernels (AVX2/BMI2) for the benchmark demos: xmake f --simd=y
+option("simd")
+    set_default(false)
+    set_showmenu(true)
+    set_description("Enable AVX2/BMI2 code paths in benchmark demos")
+option_end()
+
+-- Opt-in allocation tracking for every target: xmake f --alloc_tracking=y
+-- Links src/utils/alloc_tracker.cpp (global operator new/delete counters)
+option("alloc_tracking")
+    set_default(false)
+    set_showmenu(true)
+    set_description("Count allocations, bytes and peak live bytes per demo")
+option_end()
+
+rule("alloc_tracking")
+    on_load(function (target)
+        target:add("includedirs", path.join(os.projectdir(), "include"))
+        if has_config("alloc_tracking") then
+            target:add("files", path.join(os.projectdir(), "src/utils/alloc_tracker.cpp"))
+            target:add("defines", "CPP_FEATURES_ALLOC_TRACKING")
+        end
+    end)
+rule_end()
 
 -- C++11 features target
 target("cpp11_features")
     set_kind("binary")
+    add_rules("alloc_tracking")
     add_files("src/cpp11/*.cpp")
     add_includedirs("include")
     set_targetdir("bin")
@@ -18,6 +43,7 @@ target("cpp11_features")
 -- C++14 features target  
 target("cpp14_features")
     set_kind("binary")
+    add_rules("alloc_tracking")
     add_files("src/cpp14/*.cpp")
     add_includedirs("include")
     set_targetdir("bin")
@@ -26,6 +52,7 @@ target("cpp14_features")
 -- C++17 features target
 target("cpp17_features")
     set_kind("binary")
+    add_rules("alloc_tracking")
     add_files("src/cpp17/*.cpp")
     add_includedirs("include")
     set_targetdir("bin")
@@ -34,14 +61,20 @@ target("cpp17_features")
 -- C++20 features target
 target("cpp20_features")
     set_kind("binary")
+    add_rules("alloc_tracking")
     add_files("src/cpp20/*.cpp")
     add_includedirs("include")
     set_targetdir("bin")
     add_languages("c++20")
+    if has_config("simd") then
+        add_vectorexts("avx2")
+        add_cxxflags("-mbmi2", {tools = {"gcc", "clang"}})
+    end
 
 -- C++23 features target
 target("cpp23_features")
     set_kind("binary")
+    add_rules("alloc_tracking")
     add_files("src/cpp23/*.cpp")
     add_includedirs("include")
     set_targetdir("bin")
@@ -50,6 +83,7 @@ target("cpp23_features")
 -- C++26 features target (experimental/proposed features)
 target("cpp26_features")
     set_kind("binary")
+    add_rules("alloc_tracking")
     add_files("src/cpp26/*.cpp")
     add_includedirs("include")
     set_targetdir("bin")
@@ -64,6 +98,7 @@ target("cpp26_features")
 -- Main showcase program
 target("modern_cpp_showcase")
     set_kind("binary")
+    add_rules("alloc_tracking")
     add_files("src/main_simple.cpp")
     add_includedirs("include")
     set_targetdir("bin")
@@ -72,6 +107,7 @@ target("modern_cpp_showcase")
 -- Examples target
 target("examples")
     set_kind("binary")
+    add_rules("alloc_tracking")
     add_files("examples/*.cpp")
     add_includedirs("include")
     set_targetdir("bin/examples")